@@ -0,0 +1,297 @@
+/** @file
+ * Generator wejść do testów wydajności słownika na złośliwie dobranych nazwach miast.
+ *
+ * Program wypisuje na standardowe wyjście komendy dla programu map:
+ * najpierw łańcuch @p addRoad łączący kolejne nazwy, a potem
+ * @p repairRoad dla tych samych par, co wymaga ponownego wyszukania każdej nazwy.
+ * Użycie: `adversarial_names collisions|sorted|random liczba_nazw`.
+ *
+ * Nazwy są dobierane przeciwko dawnej, stałej funkcji haszującej słownika
+ * (wielomian modulo @ref OLD_HASH_MODULO):
+ * - @p collisions - wszystkie nazwy mają ten sam hasz;
+ * - @p sorted - nazwy są wypisywane w kolejności rosnących haszy;
+ * - @p random - losowe nazwy, jako punkt odniesienia.
+ *
+ * Czasy dla wszystkich trzech zestawów powinny być zbliżone.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+
+/* Stałe. */
+
+/** Modulo dawnej funkcji haszującej. */
+static const uint64_t OLD_HASH_MODULO = 1770134209;
+/** Mnożnik dawnej funkcji haszującej. */
+static const uint64_t OLD_HASH_MULTIPLIER = 257;
+/** Maska do ekstrakcji wartości z hasza, aby sxorować z bajtem. */
+static const uint64_t OLD_HASH_XOR_MASK = 0xff;
+/** Znaki, z których są składane nazwy. */
+static const char ALPHABET[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+/** Długość jednego fragmentu nazwy w zestawie @p collisions. */
+#define PIECE_LENGTH 6
+/** Długość nazwy w zestawach @p sorted i @p random. */
+#define NAME_LENGTH 12
+/** Logarytm liczby pól tablicy używanej do szukania kolizji. */
+#define SEARCH_BITS 20
+/** Maksymalna liczba par kolidujących fragmentów (czyli 2^30 nazw). */
+#define MAX_PIECES 30
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca nazwę wraz z jej dawnym haszem. */
+typedef struct NamedHashStruct NamedHash;
+
+/** Przechowuje nazwę wraz z jej dawnym haszem. */
+struct NamedHashStruct {
+    /** Dawny hasz nazwy. */
+    uint64_t hash;
+    /** Nazwa. */
+    char name[NAME_LENGTH + 1];
+};
+
+
+/* Zmienne globalne. */
+
+/** Stan generatora liczb pseudolosowych, stały żeby wejścia były powtarzalne. */
+static uint64_t randomState = 0x2545f4914f6cdd1d;
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Losuje kolejną liczbę (xorshift64).
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t nextRandom(void);
+
+/**
+ * @brief Wypełnia napis losowymi znakami z @ref ALPHABET.
+ * @param[out] text  - napis;
+ * @param[in] length - liczba znaków, za nimi dopisywany jest zerowy bajt.
+ */
+static void randomText(char *text, size_t length);
+
+/**
+ * @brief Przetwarza bajty tak, jak dawna funkcja haszująca, bez uwzględnienia długości.
+ * @param[in] state - stan przed przetworzeniem bajtów;
+ * @param[in] text  - przetwarzane bajty;
+ * @param[in] length - liczba bajtów.
+ * @return Stan po przetworzeniu bajtów.
+ */
+static uint64_t oldHashStep(uint64_t state, const char *text, size_t length);
+
+/**
+ * @brief Liczy dawny hasz całej nazwy.
+ * @param[in] name - nazwa.
+ * @return Hasz nazwy.
+ */
+static uint64_t oldHash(const char *name);
+
+/**
+ * @brief Znajduje dwa różne fragmenty, które z danego stanu prowadzą do tego samego stanu.
+ * Korzysta z paradoksu urodzin, trzymając stany losowych fragmentów w tablicy.
+ * @param[in] state - stan początkowy;
+ * @param[out] first  - pierwszy fragment;
+ * @param[out] second - drugi fragment.
+ * @return Wspólny stan po przetworzeniu fragmentu lub @p UINT64_MAX gdy brak pamięci.
+ */
+static uint64_t findCollidingPieces(uint64_t state, char *first, char *second);
+
+/**
+ * @brief Porównuje nazwy według dawnych haszy.
+ * @param[in] aPtr - wskaźnik na pierwszą nazwę;
+ * @param[in] bPtr - wskaźnik na drugą nazwę.
+ * @return @p -1, @p 0 lub @p 1 w zależności od stosunku haszy.
+ */
+static int compareNamedHashes(const void *aPtr, const void *bPtr);
+
+/**
+ * @brief Wypisuje komendy dla kolejnych nazw.
+ * @param[in] names - tablica nazw;
+ * @param[in] count - liczba nazw.
+ */
+static void printCommands(char **names, size_t count);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static uint64_t nextRandom(void) {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    return randomState;
+}
+
+static void randomText(char *text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        text[i] = ALPHABET[nextRandom() % (sizeof(ALPHABET) - 1)];
+    }
+    text[length] = '\0';
+}
+
+static uint64_t oldHashStep(uint64_t state, const char *text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        unsigned char xor = state & OLD_HASH_XOR_MASK;
+        uint64_t byte = (unsigned char) text[i] ^ xor;
+        state = (state * OLD_HASH_MULTIPLIER + byte) % OLD_HASH_MODULO;
+    }
+    return state;
+}
+
+static uint64_t oldHash(const char *name) {
+    size_t length = strlen(name);
+    uint64_t state = oldHashStep(OLD_HASH_MODULO & 0xaaaaaaaa, name, length);
+    return (state * OLD_HASH_MULTIPLIER + length) % OLD_HASH_MODULO;
+}
+
+static uint64_t findCollidingPieces(uint64_t state, char *first, char *second) {
+    size_t size = (size_t) 1 << SEARCH_BITS;
+    uint64_t *states = malloc(sizeof(uint64_t) * size);
+    char (*pieces)[PIECE_LENGTH + 1] = malloc(sizeof(*pieces) * size);
+    if (states == NULL || pieces == NULL) {
+        free(states);
+        free(pieces);
+        return UINT64_MAX;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        states[i] = UINT64_MAX;
+    }
+
+    uint64_t result = UINT64_MAX;
+    while (result == UINT64_MAX) {
+        char piece[PIECE_LENGTH + 1];
+        randomText(piece, PIECE_LENGTH);
+        uint64_t newState = oldHashStep(state, piece, PIECE_LENGTH);
+
+        size_t index = (newState * 0x9e3779b97f4a7c15) >> (64 - SEARCH_BITS);
+        if (states[index] == newState && strcmp(pieces[index], piece) != 0) {
+            strcpy(first, pieces[index]);
+            strcpy(second, piece);
+            result = newState;
+        } else {
+            /* Pole jest nadpisywane, wystarczy że zapamiętana jest część stanów. */
+            states[index] = newState;
+            strcpy(pieces[index], piece);
+        }
+    }
+
+    free(states);
+    free(pieces);
+    return result;
+}
+
+static int compareNamedHashes(const void *aPtr, const void *bPtr) {
+    const NamedHash *a = aPtr;
+    const NamedHash *b = bPtr;
+    if (a->hash < b->hash) {
+        return -1;
+    }
+    if (a->hash > b->hash) {
+        return 1;
+    }
+    return 0;
+}
+
+static void printCommands(char **names, size_t count) {
+    for (size_t i = 0; i + 1 < count; i++) {
+        printf("addRoad;%s;%s;1;2000\n", names[i], names[i + 1]);
+    }
+    for (size_t i = 0; i + 1 < count; i++) {
+        printf("repairRoad;%s;%s;2001\n", names[i], names[i + 1]);
+    }
+}
+
+
+/**
+ * Funkcja main programu.
+ * @param[in] argc - liczba argumentów;
+ * @param[in] argv - argumenty.
+ * @return Kod wyjścia.
+ */
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s collisions|sorted|random count\n", argv[0]);
+        return 1;
+    }
+
+    size_t count = strtoull(argv[2], NULL, 10);
+    char **names = malloc(sizeof(char *) * (count + 1));
+    if (names == NULL) {
+        return 1;
+    }
+
+    if (strcmp(argv[1], "collisions") == 0) {
+        /* Jeśli fragmenty A_i i B_i prowadzą do tego samego stanu, to każde złożenie
+         * wyborów z kolejnych par daje ten sam hasz, bo nazwy mają też równe długości. */
+        char firstPieces[MAX_PIECES][PIECE_LENGTH + 1];
+        char secondPieces[MAX_PIECES][PIECE_LENGTH + 1];
+        size_t pieceCount = 0;
+        while (((size_t) 1 << pieceCount) < count && pieceCount < MAX_PIECES) {
+            pieceCount++;
+        }
+
+        /* Nazwa zaczyna się od litery, żeby nie była liczbą, gdy nie ma żadnych fragmentów. */
+        uint64_t state = oldHashStep(OLD_HASH_MODULO & 0xaaaaaaaa, "x", 1);
+        for (size_t i = 0; i < pieceCount; i++) {
+            state = findCollidingPieces(state, firstPieces[i], secondPieces[i]);
+            if (state == UINT64_MAX) {
+                return 1;
+            }
+        }
+
+        for (size_t n = 0; n < count; n++) {
+            names[n] = malloc(PIECE_LENGTH * pieceCount + 2);
+            if (names[n] == NULL) {
+                return 1;
+            }
+            names[n][0] = 'x';
+            names[n][1] = '\0';
+            for (size_t i = 0; i < pieceCount; i++) {
+                strcat(names[n], ((n >> i) & 1) ? secondPieces[i] : firstPieces[i]);
+            }
+        }
+    } else if (strcmp(argv[1], "sorted") == 0 || strcmp(argv[1], "random") == 0) {
+        NamedHash *named = malloc(sizeof(NamedHash) * (count + 1));
+        if (named == NULL) {
+            return 1;
+        }
+
+        for (size_t n = 0; n < count; n++) {
+            randomText(named[n].name, NAME_LENGTH);
+            named[n].hash = oldHash(named[n].name);
+        }
+        if (strcmp(argv[1], "sorted") == 0) {
+            qsort(named, count, sizeof(NamedHash), compareNamedHashes);
+        }
+
+        for (size_t n = 0; n < count; n++) {
+            names[n] = malloc(NAME_LENGTH + 1);
+            if (names[n] == NULL) {
+                return 1;
+            }
+            strcpy(names[n], named[n].name);
+        }
+        free(named);
+    } else {
+        fprintf(stderr, "Unknown name set: %s\n", argv[1]);
+        return 1;
+    }
+
+    printCommands(names, count);
+
+    for (size_t n = 0; n < count; n++) {
+        free(names[n]);
+    }
+    free(names);
+    return 0;
+}
@@ -0,0 +1,328 @@
+/** @file
+ * Sprawdzenie słownika współbieżnego pod obciążeniem wielu wątków.
+ *
+ * Wątki jednocześnie wywołują @ref getOrInsertInConcurrentDict i @ref valueInConcurrentDict
+ * dla tych samych nazw, każdy w innej, losowej kolejności. Program sprawdza, że wartość
+ * każdej nazwy została utworzona dokładnie raz, że wszystkie wątki dostały tę samą
+ * wartość i że wyszukiwanie nie zwróciło innej wartości niż dodawanie.
+ * Tworzenie wartości przydziela nazwie id z atomowego licznika, tak jak mapa przydziela
+ * id miastom, a program sprawdza, że id są dokładnie liczbami od @p 0 do liczby nazw - 1.
+ * Użycie: `concurrent_dict_stress [liczba_wątków [liczba_nazw [liczba_przejść]]]`.
+ * Jeśli sprawdzenie się nie powiedzie, kod wyjścia jest niezerowy.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "concurrent_dict.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+
+/* Stałe. */
+
+/** Domyślna liczba wątków. */
+static const size_t DEFAULT_THREAD_COUNT = 8;
+/** Domyślna liczba nazw. */
+static const size_t DEFAULT_NAME_COUNT = 100000;
+/** Domyślna liczba przejść każdego wątku po wszystkich nazwach. */
+static const size_t DEFAULT_ROUND_COUNT = 4;
+/** Przedrostek nazw, za nim jest numer nazwy. */
+static const char NAME_PREFIX[] = "miasto";
+/** Długość najdłuższej nazwy, razem z zerowym bajtem. */
+#define NAME_SIZE 32
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca dane wspólne dla wszystkich wątków. */
+typedef struct StressStruct Stress;
+
+/** Struktura przechowująca dane jednego wątku. */
+typedef struct WorkerStruct Worker;
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje dane wspólne dla wszystkich wątków. */
+struct StressStruct {
+    /** Sprawdzany słownik. */
+    ConcurrentDict *dict;
+    /** Tablica nazw. */
+    char (*names)[NAME_SIZE];
+    /** Liczba nazw. */
+    size_t nameCount;
+    /** Liczba przejść każdego wątku po wszystkich nazwach. */
+    size_t roundCount;
+    /** Tablica liczb utworzonych wartości kolejnych nazw. */
+    atomic_size_t *creations;
+    /** Tablica id przydzielonych kolejnym nazwom przy tworzeniu wartości. */
+    size_t *ids;
+    /** Id, które dostanie następna utworzona wartość. */
+    atomic_size_t nextId;
+    /** Liczba wartości zwróconych przez słownik, które nie zgadzały się z wcześniejszymi. */
+    atomic_size_t mismatchCount;
+};
+
+/** Przechowuje dane jednego wątku. */
+struct WorkerStruct {
+    /** Dane wspólne. */
+    Stress *stress;
+    /** Stan generatora liczb pseudolosowych wątku. */
+    uint64_t randomState;
+    /** Kolejność nazw w bieżącym przejściu. */
+    size_t *order;
+    /** Tablica wartości, które wątek dostał dla kolejnych nazw, @p NULL dla jeszcze nieznanych. */
+    void **seen;
+};
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Losuje kolejną liczbę (xorshift64).
+ * @param[in,out] state - stan generatora.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t nextRandom(uint64_t *state);
+
+/**
+ * @brief Tworzy wartość nazwy, przekazywana do słownika.
+ * Wartością jest wskaźnik na pole tablicy liczb utworzeń, więc wyznacza numer nazwy.
+ * Przydziela nazwie kolejne id. Wartości nazw z różnych części słownika są tworzone
+ * jednocześnie, dlatego licznik id jest atomowy.
+ * @param[in,out] stressPtr - wskaźnik na dane wspólne;
+ * @param[in] word          - kopia nazwy przechowywana przez słownik;
+ * @param[in] length        - długość nazwy.
+ * @return Wskaźnik na liczbę utworzeń wartości nazwy.
+ */
+static void *createValue(void *stressPtr, const char *word, size_t length);
+
+/**
+ * @brief Porównuje wartość zwróconą przez słownik z wcześniej zapamiętaną i ją zapamiętuje.
+ * @param[in,out] worker - wskaźnik na dane wątku;
+ * @param[in] index      - numer nazwy;
+ * @param[in] value      - wartość zwrócona przez słownik lub @p NULL.
+ */
+static void recordValue(Worker *worker, size_t index, void *value);
+
+/**
+ * @brief Wykonuje przejścia wątku po nazwach.
+ * Przy każdym przejściu nazwy są przeglądane w nowej losowej kolejności,
+ * każda najpierw wyszukiwana, a potem dodawana.
+ * @param[in,out] workerPtr - wskaźnik na dane wątku.
+ * @return @p NULL.
+ */
+static void *runWorker(void *workerPtr);
+
+/**
+ * @brief Sprawdza, że przydzielone id są gęste i unikalne.
+ * @param[in] stress - wskaźnik na dane wspólne po zakończeniu wątków.
+ * @return Liczba nazw z id spoza zakresu lub powtórzonym oraz brakujących id.
+ */
+static size_t countIdFailures(const Stress *stress);
+
+/**
+ * @brief Konwertuje argument programu na dodatnią liczbę.
+ * @param[in] text      - napis z liczbą lub @p NULL;
+ * @param[in] fallback  - wartość dla @p NULL.
+ * @return Liczba lub @p 0 jeśli napis jest niepoprawny.
+ */
+static size_t parseCount(const char *text, size_t fallback);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void *createValue(void *stressPtr, const char *word, size_t length) {
+    Stress *stress = stressPtr;
+    (void) length;
+
+    size_t index = strtoull(word + sizeof(NAME_PREFIX) - 1, NULL, 10);
+    atomic_fetch_add(&stress->creations[index], 1);
+    stress->ids[index] = atomic_fetch_add(&stress->nextId, 1);
+    return &stress->creations[index];
+}
+
+static void recordValue(Worker *worker, size_t index, void *value) {
+    if (value == NULL) {
+        return;
+    }
+
+    Stress *stress = worker->stress;
+    if (value != &stress->creations[index] ||
+        (worker->seen[index] != NULL && worker->seen[index] != value)) {
+        atomic_fetch_add(&stress->mismatchCount, 1);
+    }
+    worker->seen[index] = value;
+}
+
+static void *runWorker(void *workerPtr) {
+    Worker *worker = workerPtr;
+    Stress *stress = worker->stress;
+    size_t count = stress->nameCount;
+
+    for (size_t round = 0; round < stress->roundCount; round++) {
+        /* Losowa permutacja (Fisher-Yates), inna dla każdego wątku i przejścia. */
+        for (size_t i = 0; i < count; i++) {
+            worker->order[i] = i;
+        }
+        for (size_t i = count - 1; i > 0; i--) {
+            size_t j = nextRandom(&worker->randomState) % (i + 1);
+            size_t tmp = worker->order[i];
+            worker->order[i] = worker->order[j];
+            worker->order[j] = tmp;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            size_t index = worker->order[i];
+            DictKey key = initDictKey(stress->names[index]);
+            recordValue(worker, index, valueInConcurrentDict(stress->dict, key));
+            recordValue(worker, index, getOrInsertInConcurrentDict(stress->dict, key, createValue, stress));
+        }
+    }
+    return NULL;
+}
+
+static size_t countIdFailures(const Stress *stress) {
+    size_t count = stress->nameCount;
+    bool *used = calloc(count, sizeof(bool));
+    if (used == NULL) {
+        return count;
+    }
+
+    size_t failureCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t id = stress->ids[i];
+        if (id >= count || used[id]) {
+            failureCount++;
+        } else {
+            used[id] = true;
+        }
+    }
+
+    /* Licznik wskazuje za ostatnie id tylko wtedy, gdy każda wartość dostała dokładnie jedno id. */
+    if (atomic_load(&stress->nextId) != count) {
+        failureCount++;
+    }
+    free(used);
+    return failureCount;
+}
+
+static size_t parseCount(const char *text, size_t fallback) {
+    if (text == NULL) {
+        return fallback;
+    }
+
+    char *end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return 0;
+    }
+    return value;
+}
+
+
+/**
+ * Funkcja main programu.
+ * @param[in] argc - liczba argumentów;
+ * @param[in] argv - argumenty.
+ * @return Kod wyjścia.
+ */
+int main(int argc, char **argv) {
+    size_t threadCount = parseCount(argc > 1 ? argv[1] : NULL, DEFAULT_THREAD_COUNT);
+    size_t nameCount = parseCount(argc > 2 ? argv[2] : NULL, DEFAULT_NAME_COUNT);
+    size_t roundCount = parseCount(argc > 3 ? argv[3] : NULL, DEFAULT_ROUND_COUNT);
+    if (threadCount == 0 || nameCount == 0 || roundCount == 0) {
+        fprintf(stderr, "Usage: %s [threads [names [rounds]]]\n", argv[0]);
+        return 1;
+    }
+
+    Stress stress;
+    stress.dict = initConcurrentDict();
+    stress.names = malloc(sizeof(*stress.names) * nameCount);
+    stress.nameCount = nameCount;
+    stress.roundCount = roundCount;
+    stress.creations = malloc(sizeof(atomic_size_t) * nameCount);
+    stress.ids = malloc(sizeof(size_t) * nameCount);
+    atomic_init(&stress.nextId, 0);
+    atomic_init(&stress.mismatchCount, 0);
+    Worker *workers = calloc(threadCount, sizeof(Worker));
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    if (stress.dict == NULL || stress.names == NULL || stress.creations == NULL || stress.ids == NULL ||
+        workers == NULL || threads == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < nameCount; i++) {
+        snprintf(stress.names[i], NAME_SIZE, "%s%zu", NAME_PREFIX, i);
+        atomic_init(&stress.creations[i], 0);
+        stress.ids[i] = SIZE_MAX;
+    }
+
+    size_t startedCount = 0;
+    for (; startedCount < threadCount; startedCount++) {
+        Worker *worker = &workers[startedCount];
+        worker->stress = &stress;
+        worker->randomState = 0x2545f4914f6cdd1d * (startedCount + 1);
+        worker->order = malloc(sizeof(size_t) * nameCount);
+        worker->seen = calloc(nameCount, sizeof(void *));
+        if (worker->order == NULL || worker->seen == NULL ||
+            pthread_create(&threads[startedCount], NULL, runWorker, worker) != 0) {
+            fprintf(stderr, "Cannot start thread %zu\n", startedCount);
+            break;
+        }
+    }
+    for (size_t i = 0; i < startedCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    size_t failureCount = atomic_load(&stress.mismatchCount);
+    for (size_t i = 0; i < nameCount; i++) {
+        void *value = valueInConcurrentDict(stress.dict, initDictKey(stress.names[i]));
+        bool consistent = atomic_load(&stress.creations[i]) == 1 && value == &stress.creations[i];
+        for (size_t t = 0; t < startedCount; t++) {
+            consistent = consistent && workers[t].seen[i] == value;
+        }
+        if (!consistent) {
+            failureCount++;
+        }
+    }
+
+    size_t idFailureCount = countIdFailures(&stress);
+
+    if (startedCount < threadCount) {
+        failureCount++;
+    }
+    if (failureCount > 0 || idFailureCount > 0) {
+        fprintf(stderr, "FAILED: %zu inconsistent names, %zu id errors\n", failureCount, idFailureCount);
+    } else {
+        printf("OK: %zu threads, %zu names, %zu rounds\n", threadCount, nameCount, roundCount);
+    }
+
+    for (size_t i = 0; i < threadCount; i++) {
+        free(workers[i].order);
+        free(workers[i].seen);
+    }
+    free(workers);
+    free(threads);
+    free(stress.ids);
+    free(stress.creations);
+    free(stress.names);
+    deleteConcurrentDict(stress.dict, NULL);
+    return failureCount > 0 || idFailureCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,421 @@
+/** @file
+ * Porównanie kolejek priorytetowych z modułu kopca w algorytmie Dijkstry.
+ *
+ * Na losowym grafie program wielokrotnie liczy odległości algorytmem Dijkstry
+ * z trzema kolejkami: ogólnym kopcem wskaźników z komparatorem, do którego każde
+ * dodanie alokuje wpis, a nieaktualne wpisy są pomijane przy zdejmowaniu (tak jak
+ * w pierwszej wersji szukania dróg), kopcem indeksowanym i kopcem pozycyjnym.
+ * Wypisuje czas każdej kolejki i sprawdza, że wszystkie dały te same odległości.
+ * Użycie: `heap_baseline [liczba_miast [liczba_odcinków_z_miasta [liczba_szukań]]]`.
+ * Jeśli odległości się nie zgadzają lub brak pamięci, kod wyjścia jest niezerowy.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "heap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+
+/* Stałe. */
+
+/** Domyślna liczba miast. */
+static const size_t DEFAULT_CITY_COUNT = 200000;
+/** Domyślna liczba odcinków wychodzących z każdego miasta. */
+static const size_t DEFAULT_DEGREE = 4;
+/** Domyślna liczba szukań z różnych miast. */
+static const size_t DEFAULT_SEARCH_COUNT = 8;
+/** Największa długość odcinka. */
+static const uint64_t MAX_LENGTH = 1000;
+/** Odległość miasta, do którego nie da się dojść. */
+static const uint64_t UNREACHED = UINT64_MAX;
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca losowy graf. */
+typedef struct GraphStruct Graph;
+
+/** Struktura przechowująca wpis ogólnego kopca. */
+typedef struct GenericEntryStruct GenericEntry;
+
+/**
+ * Typ wyliczeniowy określający porównywaną kolejkę.
+ */
+enum QueueKindEnum {
+    /** Ogólny kopiec z alokowanymi wpisami. */
+            QUEUE_GENERIC,
+    /** Kopiec indeksowany. */
+            QUEUE_INDEXED,
+    /** Kopiec pozycyjny. */
+            QUEUE_RADIX,
+    /** Liczba kolejek. */
+            QUEUE_KIND_COUNT
+};
+
+/**
+ * Typ określający porównywaną kolejkę.
+ */
+typedef enum QueueKindEnum QueueKind;
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje graf w postaci tablic sąsiedztwa. */
+struct GraphStruct {
+    /** Liczba miast. */
+    size_t cityCount;
+    /** Tablica początków odcinków kolejnych miast, o jedno pole dłuższa od liczby miast. */
+    size_t *offsets;
+    /** Tablica drugich końców odcinków. */
+    uint32_t *neighbors;
+    /** Tablica długości odcinków. */
+    uint64_t *lengths;
+};
+
+/** Przechowuje wpis ogólnego kopca. */
+struct GenericEntryStruct {
+    /** Klucz wpisu. */
+    HeapKey key;
+    /** Miasto. */
+    uint32_t cityId;
+};
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Losuje kolejną liczbę (xorshift64).
+ * @param[in,out] state - stan generatora.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t nextRandom(uint64_t *state);
+
+/**
+ * @brief Buduje losowy graf, w którym z każdego miasta wychodzi tyle samo odcinków.
+ * @param[out] graph    - wskaźnik na budowany graf;
+ * @param[in] cityCount - liczba miast;
+ * @param[in] degree    - liczba odcinków wychodzących z każdego miasta.
+ * @return @p true lub @p false gdy brak pamięci.
+ */
+static bool buildGraph(Graph *graph, size_t cityCount, size_t degree);
+
+/**
+ * @brief Usuwa tablice grafu.
+ * @param[in,out] graph - wskaźnik na graf.
+ */
+static void deleteGraph(Graph *graph);
+
+/**
+ * @brief Komparator wpisów ogólnego kopca.
+ * @param[in] entry1Void - wskaźnik na pierwszy wpis;
+ * @param[in] entry2Void - wskaźnik na drugi wpis.
+ * @return Liczba ujemna, zero lub dodatnia, gdy klucz pierwszego wpisu jest mniejszy, równy lub większy.
+ */
+static int compareGenericEntries(void *entry1Void, void *entry2Void);
+
+/**
+ * @brief Liczy odległości od miasta z ogólnym kopcem.
+ * @param[in] graph      - graf;
+ * @param[in] source     - miasto początkowe;
+ * @param[out] distances - tablica na odległości.
+ * @return @p true lub @p false gdy brak pamięci.
+ */
+static bool searchWithGenericHeap(const Graph *graph, uint32_t source, uint64_t *distances);
+
+/**
+ * @brief Liczy odległości od miasta z kopcem indeksowanym.
+ * @param[in] graph      - graf;
+ * @param[in] source     - miasto początkowe;
+ * @param[in,out] heap   - pusty kopiec na wszystkie miasta;
+ * @param[out] distances - tablica na odległości.
+ */
+static void searchWithIndexedHeap(const Graph *graph, uint32_t source, IndexedHeap *heap, uint64_t *distances);
+
+/**
+ * @brief Liczy odległości od miasta z kopcem pozycyjnym.
+ * @param[in] graph      - graf;
+ * @param[in] source     - miasto początkowe;
+ * @param[in,out] heap   - pusty kopiec na wszystkie miasta;
+ * @param[out] distances - tablica na odległości.
+ */
+static void searchWithRadixHeap(const Graph *graph, uint32_t source, RadixHeap *heap, uint64_t *distances);
+
+/**
+ * @brief Podaje bieżący czas w sekundach.
+ * @return Czas zegara monotonicznego.
+ */
+static double currentSeconds(void);
+
+/**
+ * @brief Konwertuje argument programu na dodatnią liczbę.
+ * @param[in] text      - napis z liczbą lub @p NULL;
+ * @param[in] fallback  - wartość dla @p NULL.
+ * @return Liczba lub @p 0 jeśli napis jest niepoprawny.
+ */
+static size_t parseCount(const char *text, size_t fallback);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static bool buildGraph(Graph *graph, size_t cityCount, size_t degree) {
+    size_t edgeCount = cityCount * degree;
+    graph->cityCount = cityCount;
+    graph->offsets = malloc(sizeof(size_t) * (cityCount + 1));
+    graph->neighbors = malloc(sizeof(uint32_t) * (edgeCount + 1));
+    graph->lengths = malloc(sizeof(uint64_t) * (edgeCount + 1));
+    if (graph->offsets == NULL || graph->neighbors == NULL || graph->lengths == NULL) {
+        deleteGraph(graph);
+        return false;
+    }
+
+    uint64_t state = 0x2545f4914f6cdd1d;
+    for (size_t cityId = 0; cityId <= cityCount; cityId++) {
+        graph->offsets[cityId] = cityId * degree;
+    }
+    for (size_t i = 0; i < edgeCount; i++) {
+        graph->neighbors[i] = (uint32_t) (nextRandom(&state) % cityCount);
+        graph->lengths[i] = nextRandom(&state) % MAX_LENGTH + 1;
+    }
+    return true;
+}
+
+static void deleteGraph(Graph *graph) {
+    free(graph->offsets);
+    free(graph->neighbors);
+    free(graph->lengths);
+    graph->offsets = NULL;
+    graph->neighbors = NULL;
+    graph->lengths = NULL;
+}
+
+static int compareGenericEntries(void *entry1Void, void *entry2Void) {
+    GenericEntry *entry1 = entry1Void;
+    GenericEntry *entry2 = entry2Void;
+    if (entry1->key.primary != entry2->key.primary) {
+        return entry1->key.primary < entry2->key.primary ? -1 : 1;
+    }
+    if (entry1->key.secondary != entry2->key.secondary) {
+        return entry1->key.secondary < entry2->key.secondary ? -1 : 1;
+    }
+    return 0;
+}
+
+static bool searchWithGenericHeap(const Graph *graph, uint32_t source, uint64_t *distances) {
+    Heap *heap = initHeap(compareGenericEntries);
+    if (heap == NULL) {
+        return false;
+    }
+
+    for (size_t cityId = 0; cityId < graph->cityCount; cityId++) {
+        distances[cityId] = UNREACHED;
+    }
+    distances[source] = 0;
+    GenericEntry *entry = malloc(sizeof(GenericEntry));
+    if (entry == NULL) {
+        deleteHeap(heap, free);
+        return false;
+    }
+    entry->key.primary = 0;
+    entry->key.secondary = 0;
+    entry->cityId = source;
+    if (!addToHeap(heap, (void **) &entry)) {
+        free(entry);
+        deleteHeap(heap, free);
+        return false;
+    }
+
+    while (!isEmptyHeap(heap)) {
+        entry = getMinimumFromHeap(heap);
+        uint32_t cityId = entry->cityId;
+        uint64_t distance = entry->key.primary;
+        free(entry);
+        /* Miasto mogło zostać dodane kilka razy, aktualny jest tylko wpis z jego odległością. */
+        if (distance != distances[cityId]) {
+            continue;
+        }
+
+        for (size_t i = graph->offsets[cityId]; i < graph->offsets[cityId + 1]; i++) {
+            uint32_t neighbor = graph->neighbors[i];
+            uint64_t newDistance = distance + graph->lengths[i];
+            if (newDistance >= distances[neighbor]) {
+                continue;
+            }
+
+            distances[neighbor] = newDistance;
+            entry = malloc(sizeof(GenericEntry));
+            if (entry == NULL) {
+                deleteHeap(heap, free);
+                return false;
+            }
+            entry->key.primary = newDistance;
+            entry->key.secondary = 0;
+            entry->cityId = neighbor;
+            if (!addToHeap(heap, (void **) &entry)) {
+                free(entry);
+                deleteHeap(heap, free);
+                return false;
+            }
+        }
+    }
+
+    deleteHeap(heap, free);
+    return true;
+}
+
+static void searchWithIndexedHeap(const Graph *graph, uint32_t source, IndexedHeap *heap, uint64_t *distances) {
+    for (size_t cityId = 0; cityId < graph->cityCount; cityId++) {
+        distances[cityId] = UNREACHED;
+    }
+    distances[source] = 0;
+    HeapKey key = {0, 0};
+    pushToIndexedHeap(heap, source, key);
+
+    while (!isEmptyIndexedHeap(heap)) {
+        uint32_t cityId = popFromIndexedHeap(heap, &key);
+        for (size_t i = graph->offsets[cityId]; i < graph->offsets[cityId + 1]; i++) {
+            uint32_t neighbor = graph->neighbors[i];
+            uint64_t newDistance = key.primary + graph->lengths[i];
+            if (newDistance < distances[neighbor]) {
+                distances[neighbor] = newDistance;
+                HeapKey newKey = {newDistance, 0};
+                pushToIndexedHeap(heap, neighbor, newKey);
+            }
+        }
+    }
+}
+
+static void searchWithRadixHeap(const Graph *graph, uint32_t source, RadixHeap *heap, uint64_t *distances) {
+    for (size_t cityId = 0; cityId < graph->cityCount; cityId++) {
+        distances[cityId] = UNREACHED;
+    }
+    distances[source] = 0;
+    HeapKey key = {0, 0};
+    pushToRadixHeap(heap, source, key);
+
+    while (!isEmptyRadixHeap(heap)) {
+        uint32_t cityId = popFromRadixHeap(heap, &key);
+        for (size_t i = graph->offsets[cityId]; i < graph->offsets[cityId + 1]; i++) {
+            uint32_t neighbor = graph->neighbors[i];
+            uint64_t newDistance = key.primary + graph->lengths[i];
+            if (newDistance < distances[neighbor]) {
+                distances[neighbor] = newDistance;
+                HeapKey newKey = {newDistance, 0};
+                pushToRadixHeap(heap, neighbor, newKey);
+            }
+        }
+    }
+    clearRadixHeap(heap);
+}
+
+static double currentSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static size_t parseCount(const char *text, size_t fallback) {
+    if (text == NULL) {
+        return fallback;
+    }
+
+    char *end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return 0;
+    }
+    return value;
+}
+
+
+/**
+ * Funkcja main programu.
+ * @param[in] argc - liczba argumentów;
+ * @param[in] argv - argumenty.
+ * @return Kod wyjścia.
+ */
+int main(int argc, char **argv) {
+    size_t cityCount = parseCount(argc > 1 ? argv[1] : NULL, DEFAULT_CITY_COUNT);
+    size_t degree = parseCount(argc > 2 ? argv[2] : NULL, DEFAULT_DEGREE);
+    size_t searchCount = parseCount(argc > 3 ? argv[3] : NULL, DEFAULT_SEARCH_COUNT);
+    if (cityCount == 0 || cityCount >= UINT32_MAX || degree == 0 || searchCount == 0) {
+        fprintf(stderr, "Usage: %s [cities [degree [searches]]]\n", argv[0]);
+        return 1;
+    }
+
+    static const char *const QUEUE_NAMES[QUEUE_KIND_COUNT] = {
+            "generic binary heap", "4-ary heap", "radix heap"
+    };
+    Graph graph;
+    uint64_t *distances[QUEUE_KIND_COUNT];
+    double seconds[QUEUE_KIND_COUNT] = {0};
+    bool built = buildGraph(&graph, cityCount, degree);
+    IndexedHeap *indexedHeap = initIndexedHeap(cityCount);
+    RadixHeap *radixHeap = initRadixHeap(cityCount);
+    bool allocated = built && indexedHeap != NULL && radixHeap != NULL;
+    for (size_t kind = 0; kind < QUEUE_KIND_COUNT; kind++) {
+        distances[kind] = malloc(sizeof(uint64_t) * cityCount);
+        allocated = allocated && distances[kind] != NULL;
+    }
+
+    size_t mismatchCount = 0;
+    bool outOfMemory = !allocated;
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (size_t search = 0; search < searchCount && !outOfMemory; search++) {
+        uint32_t source = (uint32_t) (nextRandom(&state) % cityCount);
+
+        double start = currentSeconds();
+        outOfMemory = !searchWithGenericHeap(&graph, source, distances[QUEUE_GENERIC]);
+        seconds[QUEUE_GENERIC] += currentSeconds() - start;
+
+        start = currentSeconds();
+        searchWithIndexedHeap(&graph, source, indexedHeap, distances[QUEUE_INDEXED]);
+        seconds[QUEUE_INDEXED] += currentSeconds() - start;
+
+        start = currentSeconds();
+        searchWithRadixHeap(&graph, source, radixHeap, distances[QUEUE_RADIX]);
+        seconds[QUEUE_RADIX] += currentSeconds() - start;
+
+        for (size_t kind = QUEUE_INDEXED; kind < QUEUE_KIND_COUNT && !outOfMemory; kind++) {
+            if (memcmp(distances[kind], distances[QUEUE_GENERIC], sizeof(uint64_t) * cityCount) != 0) {
+                mismatchCount++;
+            }
+        }
+    }
+
+    if (outOfMemory) {
+        fprintf(stderr, "Out of memory\n");
+    } else if (mismatchCount > 0) {
+        fprintf(stderr, "FAILED: %zu searches with different distances\n", mismatchCount);
+    } else {
+        printf("OK: %zu cities, %zu roads per city, %zu searches\n", cityCount, degree, searchCount);
+        for (size_t kind = 0; kind < QUEUE_KIND_COUNT; kind++) {
+            printf("%s: %.3f s\n", QUEUE_NAMES[kind], seconds[kind]);
+        }
+    }
+
+    for (size_t kind = 0; kind < QUEUE_KIND_COUNT; kind++) {
+        free(distances[kind]);
+    }
+    deleteRadixHeap(radixHeap);
+    deleteIndexedHeap(indexedHeap);
+    if (built) {
+        deleteGraph(&graph);
+    }
+    return outOfMemory || mismatchCount > 0 ? 1 : 0;
+}
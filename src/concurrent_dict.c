@@ -0,0 +1,147 @@
+/** @file
+ * Implementacja słownika, z którego może jednocześnie korzystać wiele wątków.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "concurrent_dict.h"
+#include "utility.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+
+/* Stałe. */
+
+/** Logarytm liczby części słownika. */
+#define SHARD_BITS 6
+/** Liczba części słownika. */
+#define SHARD_COUNT (1 << SHARD_BITS)
+/** Rozmiar linii pamięci podręcznej, do którego są wyrównywane części. */
+#define CACHE_LINE_SIZE 64
+/**
+ * Mnożnik rozpraszający hasz przed wyborem części. Słownik indeksuje tablicę niskimi,
+ * a tablicę zamrożoną wysokimi bitami hasza, więc część nie może zależeć wprost od żadnych z nich.
+ */
+static const uint64_t SHARD_MULTIPLIER = 0x9e3779b97f4a7c15;
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca jedną część słownika. */
+typedef struct ShardStruct Shard;
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje część słownika wraz z chroniącą ją blokadą. */
+struct ShardStruct {
+    /** Blokada części, czytelnicy mogą z niej korzystać jednocześnie. */
+    _Alignas(CACHE_LINE_SIZE) pthread_rwlock_t lock;
+    /** Słownik ze słowami tej części. */
+    Dict *dict;
+};
+
+/** Przechowuje słownik współbieżny. */
+struct ConcurrentDictStruct {
+    /** Części słownika. */
+    Shard shards[SHARD_COUNT];
+};
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Wybiera część słownika, w której jest dane słowo.
+ * @param[in] dict - wskaźnik na słownik;
+ * @param[in] key  - klucz słowa.
+ * @return Wskaźnik na część słownika.
+ */
+static Shard *shardOfKey(ConcurrentDict *dict, DictKey key);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static Shard *shardOfKey(ConcurrentDict *dict, DictKey key) {
+    return &dict->shards[(key.hash * SHARD_MULTIPLIER) >> (64 - SHARD_BITS)];
+}
+
+
+/* Funkcje z interfejsu. */
+
+ConcurrentDict *initConcurrentDict(void) {
+    /* Wyrównana alokacja wymaga rozmiaru będącego wielokrotnością wyrównania. */
+    ConcurrentDict *dict = aligned_alloc(CACHE_LINE_SIZE, sizeof(ConcurrentDict));
+    if (dict == NULL) {
+        return NULL;
+    }
+
+    size_t initialized = 0;
+    for (; initialized < SHARD_COUNT; initialized++) {
+        Shard *shard = &dict->shards[initialized];
+        shard->dict = initDict();
+        FAIL_IF(shard->dict == NULL);
+        if (pthread_rwlock_init(&shard->lock, NULL) != 0) {
+            deleteDict(shard->dict, NULL);
+            FAIL;
+        }
+    }
+    return dict;
+
+    FAILURE:
+    for (size_t i = 0; i < initialized; i++) {
+        pthread_rwlock_destroy(&dict->shards[i].lock);
+        deleteDict(dict->shards[i].dict, NULL);
+    }
+    free(dict);
+    return NULL;
+}
+
+void deleteConcurrentDict(ConcurrentDict *dict, void valueDestructor(void *)) {
+    if (dict == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        pthread_rwlock_destroy(&dict->shards[i].lock);
+        deleteDict(dict->shards[i].dict, valueDestructor);
+    }
+    free(dict);
+}
+
+void *valueInConcurrentDict(ConcurrentDict *dict, DictKey key) {
+    if (dict == NULL || key.word == NULL) {
+        return NULL;
+    }
+
+    Shard *shard = shardOfKey(dict, key);
+    pthread_rwlock_rdlock(&shard->lock);
+    void *value = valueInDictKeyed(shard->dict, key);
+    pthread_rwlock_unlock(&shard->lock);
+    return value;
+}
+
+void *getOrInsertInConcurrentDict(ConcurrentDict *dict, DictKey key,
+                                  void *valueFactory(void *context, const char *word, size_t length),
+                                  void *context) {
+    if (dict == NULL || key.word == NULL || valueFactory == NULL) {
+        return NULL;
+    }
+
+    /* Większość wywołań dotyczy istniejących słów, więc najpierw wystarczy blokada do odczytu. */
+    void *value = valueInConcurrentDict(dict, key);
+    if (value != NULL) {
+        return value;
+    }
+
+    /* Słowo mogło zostać dodane między blokadami, ale getOrInsertInDict to uwzględnia. */
+    Shard *shard = shardOfKey(dict, key);
+    pthread_rwlock_wrlock(&shard->lock);
+    value = getOrInsertInDict(shard->dict, key, valueFactory, context);
+    pthread_rwlock_unlock(&shard->lock);
+    return value;
+}
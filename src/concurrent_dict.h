@@ -0,0 +1,70 @@
+/** @file
+ * Interfejs słownika, z którego może jednocześnie korzystać wiele wątków.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_CONCURRENT_DICT_H
+#define DROGI_CONCURRENT_DICT_H
+
+#include "dict.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Struktura przechowująca słownik współbieżny.
+ * Słowa są rozdzielone na niezależne części, każda chroniona własną blokadą,
+ * więc operacje na słowach z różnych części nie czekają na siebie.
+ */
+typedef struct ConcurrentDictStruct ConcurrentDict;
+
+/**
+ * @brief Tworzy nowy, pusty słownik współbieżny.
+ * Samo tworzenie nie jest bezpieczne względem innych wątków używających słownika.
+ * @return Wskaźnik na słownik lub @p NULL gdy brak pamięci.
+ */
+ConcurrentDict *initConcurrentDict(void);
+
+/**
+ * @brief Usuwa słownik współbieżny.
+ * Żaden inny wątek nie może w tym czasie korzystać ze słownika.
+ * Jeśli słownik to @p NULL nic nie robi.
+ * @param[in,out] dict        - wskaźnik na słownik;
+ * @param[in] valueDestructor - funkcja usuwająca wartości lub @p NULL.
+ */
+void deleteConcurrentDict(ConcurrentDict *dict, void valueDestructor(void *));
+
+/**
+ * @brief Udostępnia wartość słowa o podanym kluczu.
+ * Może być wywoływana jednocześnie z innych wątków.
+ * @param[in] dict - wskaźnik na słownik;
+ * @param[in] key  - klucz słowa utworzony przez @ref initDictKey.
+ * @return Wartość słowa lub @p NULL jeśli słowa nie ma w słowniku lub argumenty są niepoprawne.
+ */
+void *valueInConcurrentDict(ConcurrentDict *dict, DictKey key);
+
+/**
+ * @brief Atomowo udostępnia wartość słowa, a jeśli go nie ma, to dodaje je z nową wartością.
+ * Może być wywoływana jednocześnie z innych wątków. Dla danego słowa @p valueFactory
+ * zostanie wywołana co najwyżej raz, a wszystkie wątki dostaną tę samą wartość.
+ * Znaczenie argumentów jest takie jak w @ref getOrInsertInDict. Funkcja @p valueFactory
+ * jest wywoływana pod blokadą części słownika, więc nie może z niego korzystać.
+ * Blokada chroni tylko jedną część, więc funkcje @p valueFactory dla słów z różnych
+ * części działają jednocześnie. Jeśli wartości dostają kolejne id, na przykład id miast,
+ * które muszą być gęste i unikalne, to @p valueFactory musi je przydzielać bezpiecznie
+ * względem wątków, na przykład atomowo zwiększanym licznikiem. Wartość zwrócona przez
+ * @p valueFactory zawsze trafia do słownika, więc przydzielone id nie przepada.
+ * @param[in,out] dict     - wskaźnik na słownik;
+ * @param[in] key          - klucz słowa utworzony przez @ref initDictKey;
+ * @param[in] valueFactory - funkcja tworząca wartość dla nowego słowa;
+ * @param[in] context      - kontekst przekazywany do @p valueFactory.
+ * @return Istniejąca lub nowo utworzona wartość, @p NULL jeśli argumenty są niepoprawne,
+ * brak pamięci lub @p valueFactory zwróciła @p NULL.
+ */
+void *getOrInsertInConcurrentDict(ConcurrentDict *dict, DictKey key,
+                                  void *valueFactory(void *context, const char *word, size_t length),
+                                  void *context);
+
+#endif /* DROGI_CONCURRENT_DICT_H */
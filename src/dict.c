@@ -1,252 +1,814 @@
 /** @file
  * Implementacja klasy przechowującej słownik.
  *
+ * Słownik jest tablicą haszującą z adresowaniem otwartym w wariancie Robin Hood.
+ * Przy powiększaniu stara tablica jest przenoszona do nowej stopniowo,
+ * po kilka pól przy każdym dodaniu, więc żadne pojedyncze dodanie
+ * nie przepisuje całej zawartości słownika.
+ * Słowa są kopiowane do areny napisów należącej do słownika.
+ *
+ * Hasz słowa to SipHash-1-3 z kluczem losowanym raz na proces,
+ * więc nie da się z góry przygotować słów o tych samych haszach.
+ *
+ * Słownik można zamrozić, wtedy tablica jest zastępowana minimalną doskonałą
+ * funkcją haszującą: każde słowo ma jedno wyliczone pole i nie ma pustych pól.
+ * Dodanie nowego słowa odmraża słownik, przepisując wpisy z powrotem do tablicy.
+ *
  * @author Antoni Żewierżejew <azewierzejew@gmail.com>
  * @date 27.04.2019
  */
 
-#define _GNU_SOURCE
-
 #include "dict.h"
-#include "vector.h"
+#include "string_arena.h"
+#include "utility.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
 
 
 /* Definicje typów. */
 
-/** Struktura odpowiadająca za jeden wpis w słowniku. */
-typedef struct EntryStruct Entry;
-/** Struktura odpowiadająca za kubełek wpisów o wspólnym haszu. */
-typedef struct BucketStruct Bucket;
+/** Struktura odpowiadająca za jedno pole tablicy haszującej. */
+typedef struct SlotStruct Slot;
+/** Struktura odpowiadająca za tablicę haszującą. */
+typedef struct TableStruct Table;
+/** Struktura odpowiadająca za zamrożoną tablicę z minimalnym haszowaniem doskonałym. */
+typedef struct FrozenTableStruct FrozenTable;
 
 
 /* Deklaracje struktur. */
 
-/** Przechowuje wpis ze słownika. */
-struct EntryStruct {
-    /** Wskaźnik na napis reprezentujący słowo. */
-    char *word;
+/** Przechowuje pole tablicy, czyli wpis ze słownika. */
+struct SlotStruct {
+    /** Pełny hasz słowa. */
+    uint64_t hash;
+    /** Wskaźnik na kopię słowa w arenie słownika, @p NULL jeśli pole jest puste. */
+    const char *word;
+    /** Długość słowa. */
+    size_t length;
     /** Wartość przypisana danemu słowu. */
     void *value;
 };
 
 /**
- * Kubełek wpisów o jednakowym haszu.
- * Kubełki są układane w strukturę drzewa BST ze względu na hasz.
+ * Tablica haszująca z adresowaniem otwartym.
+ * Słowo o haszu @p h jest w polu `(h + d) % capacity`, gdzie @p d to odległość
+ * od pola docelowego. Wpisy są ułożone tak, że odległości w ciągu zajętych pól
+ * nie spadają o więcej niż jeden (Robin Hood), co pozwala wcześnie przerwać szukanie.
  */
-struct BucketStruct {
-    /** Hasz danego kubełka. */
-    uint64_t hash;
-    /** Lewy kubełek-syn. */
-    Bucket *left;
-    /** Prawy kubełek-syn. */
-    Bucket *right;
-    /** Wektor słów w kubełku (typu @ref EntryStruct *). */
-    Vector *entries;
+struct TableStruct {
+    /** Liczba pól w tablicy, zawsze potęga dwójki lub @p 0. */
+    size_t capacity;
+    /** Liczba zajętych pól. */
+    size_t count;
+    /** Wskaźnik na blok pól. */
+    Slot *slots;
+};
+
+/**
+ * Tablica z minimalną doskonałą funkcją haszującą (w wariancie hash and displace).
+ * Słowa są dzielone na kubełki według górnych bitów hasza. Każdy kubełek ma
+ * przesunięcie dobrane tak, że pola wyliczone z hasza i przesunięcia
+ * są różne dla wszystkich słów, więc słowo może być tylko w jednym polu.
+ */
+struct FrozenTableStruct {
+    /** Liczba pól, równa liczbie słów w chwili zamrożenia. */
+    size_t count;
+    /** Liczba pól opróżnionych przez usunięcie słowa. */
+    size_t emptyCount;
+    /** Liczba kubełków. */
+    size_t bucketCount;
+    /** Tablica przesunięć kolejnych kubełków. */
+    uint32_t *displacements;
+    /** Wskaźnik na blok pól, puste są tylko pola usuniętych słów. */
+    Slot *slots;
 };
 
 /** Przechowuje słownik. */
 struct DictStruct {
-    /** Korzeń drzewa BST kubełków. */
-    Bucket *root;
+    /** Tablica, do której trafiają nowe słowa. */
+    Table current;
+    /**
+     * Tablica sprzed ostatniego powiększenia, przenoszona do @p current.
+     * Po zakończeniu przenoszenia jest pusta.
+     */
+    Table old;
+    /**
+     * Liczba początkowych pól @p old, które zostały już przeniesione (@p old.count ich nie liczy).
+     * Słowa usunięte z dalszych pól @p old zostają w nich z wartością @p NULL,
+     * żeby nie przesuwać wpisów przed miejsce, od którego jest kontynuowane przenoszenie.
+     */
+    size_t migrated;
+    /** Arena przechowująca kopie wszystkich słów. */
+    StringArena *words;
+    /** Czy słownik jest zamrożony, wtedy wszystkie słowa są w @p frozen, a tablice są puste. */
+    bool isFrozen;
+    /** Zamrożona tablica, używana gdy @p isFrozen. */
+    FrozenTable frozen;
 };
 
 
 /* Stałe. */
 
-/** Modulo używane przy haszowaniu. */
-static const uint64_t HASH_MODULO = 1770134209;
-/** Początkowa wartość hasza dla pustego słowa. */
-static const uint64_t HASH_START = HASH_MODULO & 0xaaaaaaaa;
-/** Mnożnik do przemnażania kolejnych liter przy haszowaniu. */
-static const uint64_t HASH_MULTIPLIER = 257;
-/** Maska do ekstrakcji wartości z hasza, aby sxorować z bajtem. */
-static const uint64_t HASH_XOR_MASK = 0xff;
+/** Początkowa liczba pól w tablicy. */
+static const size_t INITIAL_CAPACITY = 16;
+/** Licznik maksymalnego zapełnienia tablicy. */
+static const size_t MAX_LOAD_NUMERATOR = 4;
+/** Mianownik maksymalnego zapełnienia tablicy. */
+static const size_t MAX_LOAD_DENOMINATOR = 5;
+/**
+ * Liczba pól starej tablicy przenoszonych przy jednym dodaniu.
+ * Przeniesienie kończy się zanim nowa tablica zdąży się zapełnić.
+ */
+static const size_t MIGRATION_STEP = 8;
+/** Stałe inicjujące stan SipHash. */
+static const uint64_t SIP_INIT[4] = {
+        0x736f6d6570736575, 0x646f72616e646f6d, 0x6c7967656e657261, 0x7465646279746573
+};
+/** Plik, z którego czytany jest losowy klucz hasza. */
+static const char *const RANDOM_SOURCE = "/dev/urandom";
+/** Mnożnik używany przy mieszaniu bitów. */
+static const uint64_t HASH_MIX_MULTIPLIER = 0xff51afd7ed558ccd;
+/** Mnożnik, przez który przesunięcie kubełka jest mnożone przed zmieszaniem z haszem. */
+static const uint64_t DISPLACEMENT_MULTIPLIER = 0x9e3779b97f4a7c15;
+/** Średnia liczba słów w kubełku zamrożonej tablicy. */
+static const size_t FROZEN_BUCKET_SIZE = 4;
+
+
+/* Zmienne globalne. */
+
+/** Klucz hasza, wspólny dla wszystkich słowników w procesie. */
+static uint64_t hashSeed[2];
+/** Czy klucz hasza został już wylosowany. */
+static bool hashSeedReady = false;
 
 
 /* Funkcje pomocnicze. */
 
 /**
- * @brief Tworzy pojedyncze wejście do słownika.
- * Tworzy wejście, czyli @ref Entry, które zawiera słowo i przypisaną mu wartość.
- * Słowo dla danego wejścia jest kopiowane do nowego miejsca w pamięci.
- * @param[in] word  - słowo;
- * @param[in] value - wartość dla słowa.
- * @return Wskaźnik na wpis lub @p NULL gdy się nie powiodło utworzenie.
+ * @brief Losuje klucz hasza.
+ * Czyta klucz z @ref RANDOM_SOURCE, a gdy to się nie uda,
+ * składa go z czasu, licznika procesora i adresu na stosie.
+ */
+static void initHashSeed(void);
+
+/**
+ * @brief Wykonuje jedną rundę SipHash.
+ * @param[in,out] v - stan SipHash.
+ */
+static inline void sipRound(uint64_t v[4]);
+
+/**
+ * @brief Miesza bity liczby, tak że każdy bit wyniku zależy od każdego bitu argumentu.
+ * @param[in] x - liczba.
+ * @return Wymieszana liczba.
+ */
+static inline uint64_t mixBits(uint64_t x);
+
+/**
+ * @brief Wyznacza liczbę pól tablicy, która pomieści daną liczbę słów.
+ * @param[in] count - liczba słów.
+ * @return Najmniejsza potęga dwójki, nie mniejsza niż @ref INITIAL_CAPACITY,
+ * przy której tablica nie przekracza dopuszczalnego zapełnienia.
+ */
+static size_t capacityForCount(size_t count);
+
+/**
+ * @brief Tworzy pustą tablicę o podanej liczbie pól.
+ * @param[out] table   - wskaźnik na tablicę;
+ * @param[in] capacity - liczba pól, potęga dwójki.
+ * @return @p true lub @p false w zależności od powodzenia alokacji.
+ */
+static bool initTable(Table *table, size_t capacity);
+
+/**
+ * @brief Liczy odległość wpisu od jego pola docelowego.
+ * @param[in] table - wskaźnik na tablicę;
+ * @param[in] index - indeks zajętego pola.
+ * @return Odległość wpisu od pola wyznaczonego przez jego hasz.
+ */
+static inline size_t probeDistance(const Table *table, size_t index);
+
+/**
+ * @brief Znajduje pole ze słowem.
+ * @param[in] table - wskaźnik na tablicę;
+ * @param[in] key   - klucz słowa.
+ * @return Wskaźnik na pole lub @p NULL jeśli słowa nie ma w tablicy.
+ */
+static Slot *findInTable(const Table *table, DictKey key);
+
+/**
+ * @brief Znajduje pole ze słowem w całym słowniku.
+ * Szuka w nowej tablicy, a potem w nieprzeniesionej części starej.
+ * @param[in] dict - wskaźnik na słownik;
+ * @param[in] key  - klucz słowa.
+ * @return Wskaźnik na pole lub @p NULL jeśli słowa nie ma w słowniku.
+ */
+static Slot *findInDict(const Dict *dict, DictKey key);
+
+/**
+ * @brief Znajduje pole ze słowem w nieprzeniesionej części starej tablicy.
+ * Pomija przeniesione pola i pola usuniętych słów.
+ * @param[in] dict - wskaźnik na słownik;
+ * @param[in] key  - klucz słowa.
+ * @return Wskaźnik na pole lub @p NULL jeśli słowa tam nie ma.
+ */
+static Slot *findInOldTable(const Dict *dict, DictKey key);
+
+/**
+ * @brief Przygotowuje dodanie nowego słowa.
+ * Jeśli słowo trafia w pole zamrożonej tablicy opróżnione przez usunięcie,
+ * to tylko kopiuje słowo. W przeciwnym razie odmraża słownik, zapewnia miejsce w tablicy na jeszcze jedno słowo
+ * i kopiuje słowo do areny. Jeśli słownik nie zostanie w międzyczasie zmieniony,
+ * to następujące po tym @ref insertNewSlot na pewno się powiedzie.
+ * @param[in,out] dict - wskaźnik na słownik;
+ * @param[in] key      - klucz słowa, którego nie ma w słowniku.
+ * @return Wskaźnik na kopię słowa lub @p NULL jeśli brak pamięci.
+ */
+static const char *prepareNewSlot(Dict *dict, DictKey key);
+
+/**
+ * @brief Wstawia słowo przygotowane przez @ref prepareNewSlot.
+ * @param[in,out] dict - wskaźnik na słownik;
+ * @param[in] key      - klucz słowa;
+ * @param[in] word     - kopia słowa zwrócona przez @ref prepareNewSlot;
+ * @param[in] value    - wartość do przypisania.
+ * @return Wskaźnik na pole ze słowem.
+ */
+static Slot *insertNewSlot(Dict *dict, DictKey key, const char *word, void *value);
+
+/**
+ * @brief Dodaje słowo do słownika.
+ * Jeśli słowo już jest w słowniku, to zmienia jego wartość.
+ * @param[in,out] dict - wskaźnik na słownik;
+ * @param[in] key      - klucz słowa;
+ * @param[in] value    - wartość do przypisania.
+ * @return Wskaźnik na pole ze słowem lub @p NULL jeśli brak pamięci.
+ */
+static Slot *addToDictSlot(Dict *dict, DictKey key, void *value);
+
+/**
+ * @brief Wstawia wpis do tablicy.
+ * Nie sprawdza czy słowo już jest w tablicy ani czy jest w niej miejsce.
+ * @param[in,out] table - wskaźnik na tablicę;
+ * @param[in] slot      - wstawiany wpis.
+ */
+static void insertIntoTable(Table *table, Slot slot);
+
+/**
+ * @brief Usuwa wpis z tablicy.
+ * Kolejne wpisy, które nie są w swoich polach docelowych, są przesuwane o jedno
+ * pole wstecz, więc tablica nie potrzebuje znaczników usuniętych pól.
+ * @param[in,out] table - wskaźnik na tablicę;
+ * @param[in,out] slot  - wskaźnik na zajęte pole tablicy.
+ */
+static void removeFromTable(Table *table, Slot *slot);
+
+/**
+ * @brief Przenosi kolejne pola starej tablicy do nowej.
+ * Przenosi co najwyżej @p steps pól, po przeniesieniu wszystkich zwalnia starą tablicę.
+ * @param[in,out] dict - wskaźnik na słownik;
+ * @param[in] steps    - maksymalna liczba pól do przeniesienia.
+ */
+static void migrateOldTable(Dict *dict, size_t steps);
+
+/**
+ * @brief Wyznacza kubełek słowa w zamrożonej tablicy.
+ * @param[in] frozen - wskaźnik na zamrożoną tablicę;
+ * @param[in] hash   - hasz słowa.
+ * @return Indeks kubełka.
+ */
+static inline size_t frozenBucket(const FrozenTable *frozen, uint64_t hash);
+
+/**
+ * @brief Wyznacza pole słowa w zamrożonej tablicy.
+ * @param[in] hash         - hasz słowa;
+ * @param[in] displacement - przesunięcie kubełka słowa;
+ * @param[in] count        - liczba pól.
+ * @return Indeks pola.
+ */
+static inline size_t frozenPosition(uint64_t hash, uint32_t displacement, size_t count);
+
+/**
+ * @brief Wyznacza jedyne pole zamrożonej tablicy, w którym może być słowo.
+ * @param[in] frozen - wskaźnik na zamrożoną tablicę;
+ * @param[in] hash   - hasz słowa.
+ * @return Wskaźnik na pole lub @p NULL jeśli tablica nie ma pól.
  */
-static Entry *initEntry(const char *word, void *value);
+static Slot *frozenSlotOf(const FrozenTable *frozen, uint64_t hash);
 
 /**
- * @brief Tworzy kubełek wpisów.
- * Tworzy nowy, pusty kubełek wpisów i przypisuje mu dany hasz.
- * @param[in] hash - hasz kubełka.
- * @return Wskaźnik na kubełek lub @p NULL gdy się nie powiodło utworzenie.
+ * @brief Znajduje pole ze słowem w zamrożonej tablicy.
+ * @param[in] frozen - wskaźnik na zamrożoną tablicę;
+ * @param[in] key    - klucz słowa.
+ * @return Wskaźnik na pole lub @p NULL jeśli słowa nie ma w tablicy.
  */
-static Bucket *initBucket(uint64_t hash);
+static Slot *findInFrozen(const FrozenTable *frozen, DictKey key);
 
 /**
- * @brief Liczy hash słowa.
- * Liczy hasz, czyli funkcję skrótu, dwa takie same słowa zawsze mają tę samą wartość.
- * @param[in] word - słowo.
- * @return hash danego słowa.
+ * @brief Buduje zamrożoną tablicę z podanych wpisów.
+ * Dla każdego kubełka, zaczynając od największych, szuka przesunięcia,
+ * przy którym wszystkie jego słowa trafiają w wolne pola.
+ * @param[out] frozen  - wskaźnik na budowaną tablicę;
+ * @param[in] entries  - tablica wpisów, wszystkie są zajęte;
+ * @param[in] count    - liczba wpisów.
+ * @return @p true jeśli się udało, @p false gdy brak pamięci lub dwa słowa
+ * mają ten sam hasz, wtedy @p frozen nie wymaga usuwania.
  */
-static uint64_t hashWord(const char *word);
+static bool buildFrozenTable(FrozenTable *frozen, const Slot *entries, size_t count);
 
 /**
- * @brief Usuwa kubełek haszy wraz z zawartością.
- * Jeśli @p valueDestructor to @p NULL nie wywołuje go.
- * @param[in,out] bucket      - wskaźnik na kubełek do usunięcia;
- * @param[in] valueDestructor - funkcja do usuwania wartości z pamięci.
+ * @brief Usuwa bloki pamięci zamrożonej tablicy, ale nie słowa i wartości.
+ * @param[in,out] frozen - wskaźnik na zamrożoną tablicę.
  */
-static void deleteBucketTree(Bucket *bucket, void valueDestructor(void *));
+static void deleteFrozenTable(FrozenTable *frozen);
 
 /**
- * @brief Znajduje kubełek o podanym hashu.
- * Mając dany hasz i wskaźnik na korzeń drzewa BST kubełków znajduje odpowiedni kubełek.
- * Jeśli taki nie istnieje to w kubełku, którego synem byłby kubełek o takim hashu
- * znajduje odpowiedni wskaźnik na syna.
- * Zwraca wskaźnik na odpowiedni wskaźnik, zatem jeśli kubełek nie istnieje to
- * zwraca wskaźnik na NULL w miejscu gdzie należałoby taki kubełek dodać.
- * Pozwala to właśnie na dodanie kubełka bez znania kontekstu w jakim się znajduje.
- * @param[in] bucketPtr - wskaźnik na wskaźnik na kubełek będący korzeniem;
- * @param[in] hash      - hasz kubełka.
- * @return Wskaźnik na wskaźnik pod którym powinien być kubełek.
+ * @brief Odmraża słownik.
+ * Przepisuje wszystkie niepuste wpisy z zamrożonej tablicy do zwykłej tablicy
+ * z miejscem na co najmniej jedno nowe słowo.
+ * @param[in,out] dict - wskaźnik na zamrożony słownik.
+ * @return @p true lub @p false w zależności od powodzenia alokacji,
+ * w razie niepowodzenia słownik pozostaje zamrożony.
  */
-static Bucket **findBucketPtr(Bucket **bucketPtr, uint64_t hash);
+static bool thawDict(Dict *dict);
 
 /**
- * @brief Znajduje kubełek o podanym haszu.
- * Znajduje kubełek o podanym haszu w drzewie BST kubełków.
- * @param[in] bucket - kubełek będący korzeniem drzewa;
- * @param[in] hash   - szukany hasz.
- * @return Wskaźnik na kubełek lub @p NULL jeśli nie ma.
+ * @brief Zapewnia miejsce na jeszcze jedno słowo.
+ * Jeśli dodanie słowa przekroczyłoby dopuszczalne zapełnienie,
+ * rozpoczyna przenoszenie do dwukrotnie większej tablicy.
+ * @param[in,out] dict - wskaźnik na słownik.
+ * @return @p true lub @p false w zależności od powodzenia alokacji.
  */
-static Bucket *findBucket(Bucket *bucket, uint64_t hash);
+static bool reserveSlot(Dict *dict);
 
 
 /* Implementacja funkcji pomocniczych. */
 
-static Entry *initEntry(const char *word, void *value) {
-    Entry *entry = malloc(sizeof(Entry));
-    if (entry == NULL) {
-        return NULL;
+static void initHashSeed(void) {
+    bool ready = false;
+    FILE *source = fopen(RANDOM_SOURCE, "rb");
+    if (source != NULL) {
+        ready = fread(hashSeed, sizeof(hashSeed), 1, source) == 1;
+        fclose(source);
     }
 
-    entry->word = strdup(word);
-    if (entry->word == NULL) {
-        free(entry);
-        return NULL;
+    if (!ready) {
+        int local;
+        hashSeed[0] = mixBits((uint64_t) time(NULL) ^ (uint64_t) (uintptr_t) &local);
+        hashSeed[1] = mixBits(hashSeed[0] ^ (uint64_t) clock());
     }
+    hashSeedReady = true;
+}
 
-    entry->value = value;
-    return entry;
+static inline void sipRound(uint64_t v[4]) {
+    v[0] += v[1];
+    v[1] = (v[1] << 13) | (v[1] >> 51);
+    v[1] ^= v[0];
+    v[0] = (v[0] << 32) | (v[0] >> 32);
+    v[2] += v[3];
+    v[3] = (v[3] << 16) | (v[3] >> 48);
+    v[3] ^= v[2];
+    v[0] += v[3];
+    v[3] = (v[3] << 21) | (v[3] >> 43);
+    v[3] ^= v[0];
+    v[2] += v[1];
+    v[1] = (v[1] << 17) | (v[1] >> 47);
+    v[1] ^= v[2];
+    v[2] = (v[2] << 32) | (v[2] >> 32);
 }
 
-static Bucket *initBucket(uint64_t hash) {
-    Bucket *bucket = malloc(sizeof(Bucket));
-    if (bucket == NULL) {
-        return NULL;
+static inline uint64_t mixBits(uint64_t x) {
+    x ^= x >> 33;
+    x *= HASH_MIX_MULTIPLIER;
+    x ^= x >> 33;
+    return x;
+}
+
+static size_t capacityForCount(size_t count) {
+    size_t capacity = INITIAL_CAPACITY;
+    while (count * MAX_LOAD_DENOMINATOR > capacity * MAX_LOAD_NUMERATOR) {
+        capacity *= 2;
     }
+    return capacity;
+}
+
+static bool initTable(Table *table, size_t capacity) {
+    table->slots = calloc(capacity, sizeof(Slot));
+    if (table->slots == NULL) {
+        return false;
+    }
+
+    table->capacity = capacity;
+    table->count = 0;
+    return true;
+}
+
+static inline size_t probeDistance(const Table *table, size_t index) {
+    return (index - table->slots[index].hash) & (table->capacity - 1);
+}
 
-    bucket->entries = initVector();
-    if (bucket->entries == NULL) {
-        free(bucket);
+static Slot *findInTable(const Table *table, DictKey key) {
+    if (table->slots == NULL || table->count == 0) {
         return NULL;
     }
 
-    bucket->left = NULL;
-    bucket->right = NULL;
-    bucket->hash = hash;
-    return bucket;
+    size_t mask = table->capacity - 1;
+    size_t index = key.hash & mask;
+    /* Tablica nigdy nie jest pełna, więc pętla natrafi na puste pole. */
+    for (size_t distance = 0;; distance++) {
+        Slot *slot = &table->slots[index];
+        if (slot->word == NULL || probeDistance(table, index) < distance) {
+            /* Gdyby słowo było w tablicy, to wcześniej wyparłoby ten wpis. */
+            return NULL;
+        }
+        if (slot->hash == key.hash && slot->length == key.length &&
+            memcmp(slot->word, key.word, key.length) == 0) {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
 }
 
-static uint64_t hashWord(const char *word) {
-    if (word == NULL) {
-        return 0;
+static Slot *findInDict(const Dict *dict, DictKey key) {
+    if (dict->isFrozen) {
+        return findInFrozen(&dict->frozen, key);
+    }
+
+    Slot *slot = findInTable(&dict->current, key);
+    if (slot == NULL) {
+        /* Nieprzeniesione słowo jest tylko w starej tablicy. */
+        slot = findInOldTable(dict, key);
+    }
+    return slot;
+}
+
+static Slot *findInOldTable(const Dict *dict, DictKey key) {
+    Slot *slot = findInTable(&dict->old, key);
+    /* Przeniesione pola nie są czyszczone, a usunięte słowa mają pustą wartość. */
+    if (slot == NULL || (size_t) (slot - dict->old.slots) < dict->migrated || slot->value == NULL) {
+        return NULL;
+    }
+    return slot;
+}
+
+static void insertIntoTable(Table *table, Slot slot) {
+    size_t mask = table->capacity - 1;
+    size_t index = slot.hash & mask;
+    size_t distance = 0;
+    while (table->slots[index].word != NULL) {
+        size_t existingDistance = probeDistance(table, index);
+        if (existingDistance < distance) {
+            /* Wpis bliżej swojego pola ustępuje miejsca i to on jest dalej wstawiany. */
+            Slot tmp = table->slots[index];
+            table->slots[index] = slot;
+            slot = tmp;
+            distance = existingDistance;
+        }
+        index = (index + 1) & mask;
+        distance++;
     }
 
-    uint64_t hash = HASH_START;
-    size_t len = 0;
-    while (word[len] != '\0') {
-        unsigned char xor = hash & HASH_XOR_MASK;
-        /* Xor hasza z kodowanym bajtem, żeby hasze podobnych słów nie były w dokładnie tej samej kolejności. */
-        uint64_t byte = (unsigned char) word[len] ^xor;
-        hash = (hash * HASH_MULTIPLIER + byte) % HASH_MODULO;
-        len++;
+    table->slots[index] = slot;
+    table->count++;
+}
+
+static void removeFromTable(Table *table, Slot *slot) {
+    size_t mask = table->capacity - 1;
+    size_t index = (size_t) (slot - table->slots);
+    size_t next = (index + 1) & mask;
+    while (table->slots[next].word != NULL && probeDistance(table, next) > 0) {
+        table->slots[index] = table->slots[next];
+        index = next;
+        next = (next + 1) & mask;
     }
 
-    /* Uwzględniamy długość słowa w haszu. */
-    hash = (hash * HASH_MULTIPLIER + len) % HASH_MODULO;
-    return hash;
+    table->slots[index].word = NULL;
+    table->slots[index].value = NULL;
+    table->count--;
 }
 
-static void deleteBucketTree(Bucket *bucket, void valueDestructor(void *)) {
-    if (bucket == NULL) {
+static void migrateOldTable(Dict *dict, size_t steps) {
+    if (dict->old.slots == NULL) {
         return;
     }
 
-    deleteBucketTree(bucket->left, valueDestructor);
-    deleteBucketTree(bucket->right, valueDestructor);
+    /* Przeniesione pola nie są czyszczone, bo stara tablica nie jest już modyfikowana,
+     * a przeniesione słowa zawsze zostaną wcześniej znalezione w nowej tablicy. */
+    for (; steps > 0 && dict->migrated < dict->old.capacity; steps--, dict->migrated++) {
+        Slot *slot = &dict->old.slots[dict->migrated];
+        if (slot->word != NULL && slot->value != NULL) {
+            insertIntoTable(&dict->current, *slot);
+            dict->old.count--;
+        }
+    }
+
+    if (dict->migrated == dict->old.capacity) {
+        free(dict->old.slots);
+        dict->old.slots = NULL;
+        dict->old.capacity = 0;
+        dict->old.count = 0;
+        dict->migrated = 0;
+    }
+}
+
+static inline size_t frozenBucket(const FrozenTable *frozen, uint64_t hash) {
+    /* Przeskalowanie górnych 32 bitów hasza do liczby kubełków, bez dzielenia. */
+    return (size_t) (((hash >> 32) * frozen->bucketCount) >> 32);
+}
+
+static inline size_t frozenPosition(uint64_t hash, uint32_t displacement, size_t count) {
+    uint64_t mixed = mixBits(hash ^ (displacement * DISPLACEMENT_MULTIPLIER));
+    return (size_t) (((mixed & UINT32_MAX) * count) >> 32);
+}
+
+static Slot *frozenSlotOf(const FrozenTable *frozen, uint64_t hash) {
+    if (frozen->count == 0) {
+        return NULL;
+    }
+
+    uint32_t displacement = frozen->displacements[frozenBucket(frozen, hash)];
+    return &frozen->slots[frozenPosition(hash, displacement, frozen->count)];
+}
+
+static Slot *findInFrozen(const FrozenTable *frozen, DictKey key) {
+    /* Jeden hasz, jedno pole i jedno porównanie. */
+    Slot *slot = frozenSlotOf(frozen, key.hash);
+    if (slot != NULL && slot->word != NULL && slot->hash == key.hash && slot->length == key.length &&
+        memcmp(slot->word, key.word, key.length) == 0) {
+        return slot;
+    }
+    return NULL;
+}
+
+static bool buildFrozenTable(FrozenTable *frozen, const Slot *entries, size_t count) {
+    size_t *bucketStarts = NULL;
+    size_t *bucketEntries = NULL;
+    size_t *bucketOrder = NULL;
+    size_t *sizeStarts = NULL;
+    size_t *positions = NULL;
+    bool *taken = NULL;
+
+    frozen->count = count;
+    frozen->emptyCount = 0;
+    frozen->bucketCount = count / FROZEN_BUCKET_SIZE + 1;
+    frozen->displacements = NULL;
+    frozen->slots = NULL;
+    /* Pozycje są liczone na 32 bitach. */
+    FAIL_IF(count > UINT32_MAX);
+
+    frozen->displacements = calloc(frozen->bucketCount, sizeof(uint32_t));
+    frozen->slots = calloc(count + 1, sizeof(Slot));
+    bucketStarts = calloc(frozen->bucketCount + 1, sizeof(size_t));
+    bucketEntries = malloc(sizeof(size_t) * (count + 1));
+    bucketOrder = malloc(sizeof(size_t) * frozen->bucketCount);
+    taken = calloc(count + 1, sizeof(bool));
+    FAIL_IF(frozen->displacements == NULL || frozen->slots == NULL || bucketStarts == NULL ||
+            bucketEntries == NULL || bucketOrder == NULL || taken == NULL);
+
+    /* Wpisy są grupowane według kubełków sortowaniem przez zliczanie. */
+    for (size_t i = 0; i < count; i++) {
+        bucketStarts[frozenBucket(frozen, entries[i].hash) + 1]++;
+    }
+    size_t maxBucketSize = 0;
+    for (size_t b = 0; b < frozen->bucketCount; b++) {
+        if (bucketStarts[b + 1] > maxBucketSize) {
+            maxBucketSize = bucketStarts[b + 1];
+        }
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+    /* Tablica kolejności chwilowo przechowuje miejsce na następne słowo kubełka. */
+    for (size_t b = 0; b < frozen->bucketCount; b++) {
+        bucketOrder[b] = bucketStarts[b];
+    }
+    for (size_t i = 0; i < count; i++) {
+        bucketEntries[bucketOrder[frozenBucket(frozen, entries[i].hash)]++] = i;
+    }
+
+    /* Kubełki są ustawiane od największych, bo najtrudniej je umieścić. */
+    sizeStarts = calloc(maxBucketSize + 2, sizeof(size_t));
+    positions = malloc(sizeof(size_t) * (maxBucketSize + 1));
+    FAIL_IF(sizeStarts == NULL || positions == NULL);
+    for (size_t b = 0; b < frozen->bucketCount; b++) {
+        sizeStarts[maxBucketSize - (bucketStarts[b + 1] - bucketStarts[b]) + 1]++;
+    }
+    for (size_t size = 0; size <= maxBucketSize; size++) {
+        sizeStarts[size + 1] += sizeStarts[size];
+    }
+    for (size_t b = 0; b < frozen->bucketCount; b++) {
+        bucketOrder[sizeStarts[maxBucketSize - (bucketStarts[b + 1] - bucketStarts[b])]++] = b;
+    }
+
+    for (size_t i = 0; i < frozen->bucketCount; i++) {
+        size_t bucket = bucketOrder[i];
+        size_t first = bucketStarts[bucket];
+        size_t size = bucketStarts[bucket + 1] - first;
+        if (size == 0) {
+            /* Kubełki są posortowane, więc dalej są już tylko puste. */
+            break;
+        }
 
-    size_t entryCount = sizeOfVector(bucket->entries);
-    Entry **entries = (Entry **) storageBlockOfVector(bucket->entries);
-    for (size_t i = 0; i < entryCount; i++) {
-        free(entries[i]->word);
-        if (valueDestructor != NULL) {
-            valueDestructor(entries[i]->value);
+        /* Słowa o tym samym haszu zawsze trafiałyby w to samo pole. */
+        for (size_t j = 0; j < size; j++) {
+            for (size_t k = j + 1; k < size; k++) {
+                FAIL_IF(entries[bucketEntries[first + j]].hash == entries[bucketEntries[first + k]].hash);
+            }
+        }
+
+        bool placed = false;
+        for (uint64_t displacement = 0; displacement <= UINT32_MAX && !placed; displacement++) {
+            size_t placedCount = 0;
+            while (placedCount < size) {
+                uint64_t hash = entries[bucketEntries[first + placedCount]].hash;
+                size_t position = frozenPosition(hash, displacement, count);
+                if (taken[position]) {
+                    break;
+                }
+                taken[position] = true;
+                positions[placedCount++] = position;
+            }
+
+            if (placedCount == size) {
+                frozen->displacements[bucket] = displacement;
+                placed = true;
+            } else {
+                /* Przesunięcie nie pasuje, więc zajęte pola są zwalniane. */
+                for (size_t j = 0; j < placedCount; j++) {
+                    taken[positions[j]] = false;
+                }
+            }
+        }
+        FAIL_IF(!placed);
+
+        for (size_t j = 0; j < size; j++) {
+            frozen->slots[positions[j]] = entries[bucketEntries[first + j]];
         }
     }
-    deleteVector(bucket->entries, free);
 
-    free(bucket);
+    free(bucketStarts);
+    free(bucketEntries);
+    free(bucketOrder);
+    free(sizeStarts);
+    free(positions);
+    free(taken);
+    return true;
+
+    FAILURE:
+
+    deleteFrozenTable(frozen);
+    free(bucketStarts);
+    free(bucketEntries);
+    free(bucketOrder);
+    free(sizeStarts);
+    free(positions);
+    free(taken);
+    return false;
 }
 
-static Bucket **findBucketPtr(Bucket **bucketPtr, uint64_t hash) {
-    if (*bucketPtr == NULL) {
-        return bucketPtr;
+static void deleteFrozenTable(FrozenTable *frozen) {
+    free(frozen->displacements);
+    free(frozen->slots);
+    frozen->displacements = NULL;
+    frozen->slots = NULL;
+    frozen->count = 0;
+    frozen->emptyCount = 0;
+    frozen->bucketCount = 0;
+}
+
+static bool thawDict(Dict *dict) {
+    FrozenTable *frozen = &dict->frozen;
+    if (!initTable(&dict->current, capacityForCount(frozen->count - frozen->emptyCount + 1))) {
+        return false;
     }
 
-    if ((*bucketPtr)->hash < hash) {
-        return findBucketPtr(&(*bucketPtr)->right, hash);
+    for (size_t i = 0; i < frozen->count; i++) {
+        if (frozen->slots[i].word != NULL) {
+            insertIntoTable(&dict->current, frozen->slots[i]);
+        }
     }
 
-    if ((*bucketPtr)->hash > hash) {
-        return findBucketPtr(&(*bucketPtr)->left, hash);
+    deleteFrozenTable(frozen);
+    dict->isFrozen = false;
+    return true;
+}
+
+static bool reserveSlot(Dict *dict) {
+    Table *current = &dict->current;
+    size_t total = current->count + 1;
+    if (dict->old.slots != NULL) {
+        total += dict->old.count;
     }
 
-    return bucketPtr;
+    if (total * MAX_LOAD_DENOMINATOR <= current->capacity * MAX_LOAD_NUMERATOR) {
+        return true;
+    }
+
+    /* Poprzednie przenoszenie musi się skończyć, zanim zacznie się kolejne. */
+    migrateOldTable(dict, SIZE_MAX);
+
+    Table bigger;
+    if (!initTable(&bigger, current->capacity * 2)) {
+        return false;
+    }
+
+    dict->old = *current;
+    dict->migrated = 0;
+    dict->current = bigger;
+    return true;
 }
 
-static Bucket *findBucket(Bucket *bucket, const uint64_t hash) {
-    if (bucket == NULL) {
+
+static const char *prepareNewSlot(Dict *dict, DictKey key) {
+    if (dict->isFrozen) {
+        Slot *slot = frozenSlotOf(&dict->frozen, key.hash);
+        if (slot != NULL && slot->word == NULL) {
+            /* Słowo trafia w pole usuniętego słowa, więc funkcja nadal jest doskonała. */
+            return addToStringArena(dict->words, key.word, key.length);
+        }
+        if (!thawDict(dict)) {
+            return NULL;
+        }
+    }
+
+    if (!reserveSlot(dict)) {
         return NULL;
     }
 
-    if (bucket->hash < hash) {
-        return findBucket(bucket->right, hash);
+    return addToStringArena(dict->words, key.word, key.length);
+}
+
+static Slot *insertNewSlot(Dict *dict, DictKey key, const char *word, void *value) {
+    Slot newSlot;
+    newSlot.hash = key.hash;
+    newSlot.length = key.length;
+    newSlot.value = value;
+    newSlot.word = word;
+
+    if (dict->isFrozen) {
+        Slot *slot = frozenSlotOf(&dict->frozen, key.hash);
+        *slot = newSlot;
+        dict->frozen.emptyCount--;
+        return slot;
     }
 
-    if (bucket->hash > hash) {
-        return findBucket(bucket->left, hash);
+    insertIntoTable(&dict->current, newSlot);
+    migrateOldTable(dict, MIGRATION_STEP);
+    /* Wstawianie i przenoszenie przesuwa wpisy, więc pole jest szukane ponownie. */
+    return findInTable(&dict->current, key);
+}
+
+static Slot *addToDictSlot(Dict *dict, DictKey key, void *value) {
+    Slot *slot = findInDict(dict, key);
+    if (slot != NULL) {
+        /* Nieprzeniesione słowo jest aktualizowane w miejscu i przeniesione później. */
+        slot->value = value;
+        return slot;
     }
 
-    return bucket;
+    const char *word = prepareNewSlot(dict, key);
+    if (word == NULL) {
+        return NULL;
+    }
+
+    return insertNewSlot(dict, key, word, value);
 }
 
 
 /* Funkcje z interfejsu. */
 
 Dict *initDict() {
+    /* Klucz hasza jest losowany przed utworzeniem pierwszego słownika,
+     * żeby późniejsze tworzenie kluczy słów nie zmieniało stanu globalnego. */
+    if (!hashSeedReady) {
+        initHashSeed();
+    }
+
     Dict *dict = malloc(sizeof(Dict));
     if (dict == NULL) {
         return NULL;
     }
 
-    dict->root = NULL;
+    dict->words = initStringArena();
+    if (dict->words == NULL || !initTable(&dict->current, INITIAL_CAPACITY)) {
+        deleteStringArena(dict->words);
+        free(dict);
+        return NULL;
+    }
+
+    dict->old.slots = NULL;
+    dict->old.capacity = 0;
+    dict->old.count = 0;
+    dict->migrated = 0;
+    dict->isFrozen = false;
+    dict->frozen.count = 0;
+    dict->frozen.emptyCount = 0;
+    dict->frozen.bucketCount = 0;
+    dict->frozen.displacements = NULL;
+    dict->frozen.slots = NULL;
     return dict;
 }
 
@@ -255,67 +817,283 @@ void deleteDict(Dict *dict, void valueDestructor(void *)) {
         return;
     }
 
-    deleteBucketTree(dict->root, valueDestructor);
+    if (valueDestructor != NULL) {
+        size_t cursor = 0;
+        DictEntry entry;
+        while (dictForEach(dict, &cursor, &entry)) {
+            valueDestructor(entry.value);
+        }
+    }
+
+    free(dict->current.slots);
+    free(dict->old.slots);
+    deleteFrozenTable(&dict->frozen);
+    deleteStringArena(dict->words);
     free(dict);
 }
 
+DictKey initDictKey(const char *word) {
+    return scanDictKey(word, '\0', NULL);
+}
+
+DictKey scanDictKey(const char *word, char terminator, bool isCorrectChar(char)) {
+    DictKey key;
+    key.word = word;
+    key.length = 0;
+    key.hash = 0;
+    if (word == NULL) {
+        return key;
+    }
+
+    if (!hashSeedReady) {
+        initHashSeed();
+    }
+
+    uint64_t v[4];
+    v[0] = SIP_INIT[0] ^ hashSeed[0];
+    v[1] = SIP_INIT[1] ^ hashSeed[1];
+    v[2] = SIP_INIT[2] ^ hashSeed[0];
+    v[3] = SIP_INIT[3] ^ hashSeed[1];
+
+    /* Długość i hasz są liczone w jednym przejściu po słowie,
+     * bajty są zbierane w 64-bitowe bloki (little-endian). */
+    uint64_t block = 0;
+    size_t length = 0;
+    bool correct = true;
+    for (const char *it = word; *it != '\0' && *it != terminator; it++, length++) {
+        if (isCorrectChar != NULL && !isCorrectChar(*it)) {
+            correct = false;
+        }
+        block |= (uint64_t) (unsigned char) *it << (8 * (length % 8));
+        if (length % 8 == 7) {
+            v[3] ^= block;
+            sipRound(v);
+            v[0] ^= block;
+            block = 0;
+        }
+    }
+
+    /* Ostatni blok zawiera pozostałe bajty i długość słowa. */
+    block |= (uint64_t) length << 56;
+    v[3] ^= block;
+    sipRound(v);
+    v[0] ^= block;
+
+    v[2] ^= 0xff;
+    sipRound(v);
+    sipRound(v);
+    sipRound(v);
+
+    key.word = correct ? word : NULL;
+    key.length = length;
+    key.hash = v[0] ^ v[1] ^ v[2] ^ v[3];
+    return key;
+}
+
 bool addToDict(Dict *dict, const char *word, void *value) {
-    if (dict == NULL || word == NULL || value == NULL) {
+    return addToDictKeyed(dict, initDictKey(word), value);
+}
+
+void *valueInDict(const Dict *dict, const char *word) {
+    return valueInDictKeyed(dict, initDictKey(word));
+}
+
+bool addToDictKeyed(Dict *dict, DictKey key, void *value) {
+    return internInDict(dict, key, value) != NULL;
+}
+
+const char *internInDict(Dict *dict, DictKey key, void *value) {
+    if (dict == NULL || key.word == NULL || value == NULL) {
+        return NULL;
+    }
+
+    Slot *slot = addToDictSlot(dict, key, value);
+    return slot == NULL ? NULL : slot->word;
+}
+
+void *getOrInsertInDict(Dict *dict, DictKey key,
+                        void *valueFactory(void *context, const char *word, size_t length),
+                        void *context) {
+    if (dict == NULL || key.word == NULL || valueFactory == NULL) {
+        return NULL;
+    }
+
+    Slot *slot = findInDict(dict, key);
+    if (slot != NULL) {
+        return slot->value;
+    }
+
+    /* Miejsce jest rezerwowane przed utworzeniem wartości, więc wstawienie się powiedzie. */
+    const char *word = prepareNewSlot(dict, key);
+    if (word == NULL) {
+        return NULL;
+    }
+
+    void *value = valueFactory(context, word, key.length);
+    if (value == NULL) {
+        releaseFromStringArena(dict->words, word, key.length);
+        return NULL;
+    }
+
+    insertNewSlot(dict, key, word, value);
+    return value;
+}
+
+void *valueInDictKeyed(const Dict *dict, DictKey key) {
+    if (dict == NULL || key.word == NULL) {
+        return NULL;
+    }
+
+    Slot *slot = findInDict(dict, key);
+    return slot == NULL ? NULL : slot->value;
+}
+
+bool removeFromDict(Dict *dict, DictKey key, void valueDestructor(void *)) {
+    if (dict == NULL || key.word == NULL) {
         return false;
     }
 
-    uint64_t hash = hashWord(word);
-    Bucket **bucketPtr = findBucketPtr(&dict->root, hash);
-    if (*bucketPtr == NULL) {
-        /* Jeśli nie ma odpowiedniego kubełka to należy go stworzyć. */
-        *bucketPtr = initBucket(hash);
-        if (*bucketPtr == NULL) {
-            return false;
-        }
+    Slot *slot = findInDict(dict, key);
+    if (slot == NULL) {
+        return false;
     }
 
-    Bucket *bucket = *bucketPtr;
-    size_t entryCount = sizeOfVector(bucket->entries);
-    Entry **entries = (Entry **) storageBlockOfVector(bucket->entries);
-    for (size_t i = 0; i < entryCount; i++) {
-        if (strcmp(word, entries[i]->word) == 0) {
-            entries[i]->value = value;
-            return true;
-        }
+    void *value = slot->value;
+    releaseFromStringArena(dict->words, slot->word, slot->length);
+    if (dict->isFrozen) {
+        /* Pole zostaje puste, pozostałe słowa nadal trafiają w swoje pola. */
+        slot->word = NULL;
+        slot->value = NULL;
+        dict->frozen.emptyCount++;
+    } else if (findInTable(&dict->current, key) == slot) {
+        removeFromTable(&dict->current, slot);
+    } else {
+        /* Przesuwanie wpisów w starej tablicy mogłoby przenieść wpis przed miejsce,
+         * od którego jest kontynuowane przenoszenie, więc słowo zostaje w polu bez wartości. */
+        slot->value = NULL;
+        dict->old.count--;
+    }
+    if (valueDestructor != NULL) {
+        valueDestructor(value);
+    }
+    return true;
+}
+
+size_t liveWordBytesOfDict(const Dict *dict) {
+    return dict == NULL ? 0 : liveBytesOfStringArena(dict->words);
+}
+
+size_t deadWordBytesOfDict(const Dict *dict) {
+    return dict == NULL ? 0 : deadBytesOfStringArena(dict->words);
+}
+
+bool freezeDict(Dict *dict) {
+    if (dict == NULL) {
+        return false;
+    }
+    if (dict->isFrozen) {
+        return true;
     }
 
-    Entry *entry = initEntry(word, value);
-    if (entry == NULL) {
+    /* Wszystkie wpisy muszą być w jednej tablicy, żeby zebrać je w ciągłym bloku. */
+    migrateOldTable(dict, SIZE_MAX);
+
+    size_t count = dict->current.count;
+    Slot *entries = malloc(sizeof(Slot) * (count + 1));
+    if (entries == NULL) {
         return false;
     }
 
-    if (!pushToVector(bucket->entries, entry)) {
-        free(entry->word);
-        free(entry);
+    size_t entryCount = 0;
+    for (size_t i = 0; i < dict->current.capacity; i++) {
+        if (dict->current.slots[i].word != NULL) {
+            entries[entryCount++] = dict->current.slots[i];
+        }
+    }
+
+    bool built = buildFrozenTable(&dict->frozen, entries, count);
+    free(entries);
+    if (!built) {
         return false;
     }
 
+    free(dict->current.slots);
+    dict->current.slots = NULL;
+    dict->current.capacity = 0;
+    dict->current.count = 0;
+    dict->isFrozen = true;
     return true;
 }
 
-void *valueInDict(const Dict *dict, const char *word) {
-    if (dict == NULL || word == NULL) {
-        return NULL;
+bool dictForEach(const Dict *dict, size_t *cursor, DictEntry *entry) {
+    if (dict == NULL || cursor == NULL || entry == NULL) {
+        return false;
     }
 
-    uint64_t hash = hashWord(word);
-    Bucket *bucket = findBucket(dict->root, hash);
-    if (bucket == NULL) {
-        return NULL;
+    /* Kursor przebiega kolejno pola zamrożonej tablicy, nowej tablicy
+     * i nieprzeniesionej części starej, pomijając puste. */
+    size_t frozenEnd = dict->frozen.count;
+    size_t currentEnd = frozenEnd + dict->current.capacity;
+    size_t oldEnd = currentEnd + dict->old.capacity - dict->migrated;
+    for (; *cursor < oldEnd; (*cursor)++) {
+        const Slot *slot;
+        if (*cursor < frozenEnd) {
+            slot = &dict->frozen.slots[*cursor];
+        } else if (*cursor < currentEnd) {
+            slot = &dict->current.slots[*cursor - frozenEnd];
+        } else {
+            slot = &dict->old.slots[dict->migrated + *cursor - currentEnd];
+        }
+
+        if (slot->word != NULL && slot->value != NULL) {
+            entry->word = slot->word;
+            entry->length = slot->length;
+            entry->value = slot->value;
+            (*cursor)++;
+            return true;
+        }
+    }
+    return false;
+}
+
+Dict *dictBuildFromArray(const DictKey *keys, void *const *values, size_t count) {
+    Dict *dict = NULL;
+    FAIL_IF(count > 0 && (keys == NULL || values == NULL));
+
+    dict = initDict();
+    FAIL_IF(dict == NULL);
+
+    /* Tablica od razu ma docelowy rozmiar, więc przy wstawianiu nic nie jest przenoszone. */
+    size_t capacity = capacityForCount(count);
+    if (capacity > dict->current.capacity) {
+        Table table;
+        FAIL_IF(!initTable(&table, capacity));
+        free(dict->current.slots);
+        dict->current = table;
     }
 
-    size_t entryCount = sizeOfVector(bucket->entries);
-    Entry **entries = (Entry **) storageBlockOfVector(bucket->entries);
-    for (size_t i = 0; i < entryCount; i++) {
-        if (strcmp(word, entries[i]->word) == 0) {
-            return entries[i]->value;
+    for (size_t i = 0; i < count; i++) {
+        FAIL_IF(keys[i].word == NULL || values[i] == NULL);
+
+        Slot *slot = findInTable(&dict->current, keys[i]);
+        if (slot != NULL) {
+            slot->value = values[i];
+            continue;
         }
+
+        Slot newSlot;
+        newSlot.hash = keys[i].hash;
+        newSlot.length = keys[i].length;
+        newSlot.value = values[i];
+        newSlot.word = addToStringArena(dict->words, keys[i].word, keys[i].length);
+        FAIL_IF(newSlot.word == NULL);
+        insertIntoTable(&dict->current, newSlot);
     }
 
+    return dict;
+
+    FAILURE:
+
+    deleteDict(dict, NULL);
     return NULL;
 }
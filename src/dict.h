@@ -9,10 +9,41 @@
 #define DROGI_DICT_H
 
 #include <stdbool.h>
+#include <stdlib.h>
+#include <inttypes.h>
 
 /** Struktura przechowująca słownik. */
 typedef struct DictStruct Dict;
 
+/** Struktura przechowująca słowo wraz z policzonymi długością i haszem. */
+typedef struct DictKeyStruct DictKey;
+
+/**
+ * Klucz słowa, pozwala raz policzyć hasz i długość słowa
+ * i używać ich przy wielu operacjach na słowniku.
+ */
+struct DictKeyStruct {
+    /** Wskaźnik na napis reprezentujący słowo, @p NULL dla niepoprawnego klucza. */
+    const char *word;
+    /** Długość słowa. */
+    size_t length;
+    /** Hasz słowa. */
+    uint64_t hash;
+};
+
+/** Struktura udostępniająca słowo ze słownika wraz z wartością. */
+typedef struct DictEntryStruct DictEntry;
+
+/** Wpis słownika udostępniany przy przeglądaniu przez @ref dictForEach. */
+struct DictEntryStruct {
+    /** Wskaźnik na kopię słowa przechowywaną przez słownik. */
+    const char *word;
+    /** Długość słowa. */
+    size_t length;
+    /** Wartość przypisana słowu. */
+    void *value;
+};
+
 /**
  * @brief Tworzy nowy słownik bez żadnych słów.
  * @return Wskaźnik na utworzony słownik lub @p NULL, gdy nie udało się
@@ -48,5 +79,150 @@ bool addToDict(Dict *dict, const char *word, void *value);
  */
 void *valueInDict(const Dict *dict, const char *word);
 
+/**
+ * @brief Tworzy klucz słowa.
+ * Liczy długość i hasz słowa w jednym przejściu. Nie kopiuje słowa,
+ * więc klucz jest ważny tak długo, jak napis @p word.
+ * @param[in] word - wskaźnik na napis reprezentujący słowo.
+ * @return Klucz słowa, jeśli @p word to @p NULL, klucz ma pole @p word równe @p NULL.
+ */
+DictKey initDictKey(const char *word);
+
+/**
+ * @brief Tworzy klucz słowa, sprawdzając przy tym jego znaki.
+ * Słowo kończy się zerowym bajtem lub pierwszym znakiem @p terminator.
+ * Koniec słowa, jego długość i hasz są wyznaczane w jednym przejściu,
+ * w którym każdy znak jest też sprawdzany przez @p isCorrectChar,
+ * więc wywołujący nie musi osobno szukać końca słowa ani sprawdzać jego znaków.
+ * @param[in] word          - wskaźnik na napis zaczynający się słowem;
+ * @param[in] terminator    - znak kończący słowo;
+ * @param[in] isCorrectChar - funkcja sprawdzająca znak lub @p NULL, jeśli każdy znak jest poprawny.
+ * @return Klucz słowa. Pole @p length zawsze jest długością słowa, a jeśli któryś znak
+ * jest niepoprawny lub @p word to @p NULL, to pole @p word klucza ma wartość @p NULL.
+ */
+DictKey scanDictKey(const char *word, char terminator, bool isCorrectChar(char));
+
+/**
+ * @brief Dodaje do słownika słowo o podanym kluczu.
+ * Działa jak @ref addToDict, ale nie liczy ponownie hasza słowa.
+ * @param[in,out] dict - wskaźnik na słownik;
+ * @param[in] key      - klucz słowa utworzony przez @ref initDictKey;
+ * @param[in] value    - wartość do przypisania.
+ * @return Wartość @p true, jeśli słowo zostało dodane.
+ * Wartość @p false, jeśli wystąpił błąd: argumenty są niepoprawne lub brak pamięci.
+ */
+bool addToDictKeyed(Dict *dict, DictKey key, void *value);
+
+/**
+ * @brief Dodaje do słownika słowo i udostępnia jego kopię.
+ * Działa jak @ref addToDictKeyed, ale zwraca wskaźnik na kopię słowa
+ * przechowywaną przez słownik. Kopia jest ważna aż do usunięcia słownika,
+ * więc wartości mogą jej używać zamiast trzymać własną.
+ * @param[in,out] dict - wskaźnik na słownik;
+ * @param[in] key      - klucz słowa utworzony przez @ref initDictKey;
+ * @param[in] value    - wartość do przypisania.
+ * @return Wskaźnik na kopię słowa lub @p NULL, jeśli wystąpił błąd:
+ * argumenty są niepoprawne lub brak pamięci.
+ */
+const char *internInDict(Dict *dict, DictKey key, void *value);
+
+/**
+ * @brief Udostępnia wartość słowa, a jeśli go nie ma, to dodaje je z nową wartością.
+ * Jeśli słowa nie ma w słowniku, to kopiuje je do słownika, wywołuje
+ * @p valueFactory z kontekstem, kopią słowa i jego długością, a wynik przypisuje słowu.
+ * Funkcja @p valueFactory jest wywoływana co najwyżej raz i nie może modyfikować słownika.
+ * Jeśli zwróci @p NULL, to słowo nie jest dodawane.
+ * @param[in,out] dict     - wskaźnik na słownik;
+ * @param[in] key          - klucz słowa utworzony przez @ref initDictKey;
+ * @param[in] valueFactory - funkcja tworząca wartość dla nowego słowa;
+ * @param[in] context      - kontekst przekazywany do @p valueFactory.
+ * @return Istniejąca lub nowo utworzona wartość, @p NULL jeśli argumenty są niepoprawne,
+ * brak pamięci lub @p valueFactory zwróciła @p NULL.
+ */
+void *getOrInsertInDict(Dict *dict, DictKey key,
+                        void *valueFactory(void *context, const char *word, size_t length),
+                        void *context);
+
+/**
+ * @brief Udostępnia wartość słowa o podanym kluczu.
+ * Działa jak @ref valueInDict, ale nie liczy ponownie hasza słowa.
+ * @param[in] dict - wskaźnik na słownik;
+ * @param[in] key  - klucz słowa utworzony przez @ref initDictKey.
+ * @return znalezioną wartość, @p NULL jeśli nie ma słowa w słowniku.
+ */
+void *valueInDictKeyed(const Dict *dict, DictKey key);
+
+/**
+ * @brief Usuwa słowo ze słownika.
+ * Kopia słowa pozostaje w pamięci słownika aż do jego usunięcia,
+ * więc wskaźniki zwrócone wcześniej przez @ref internInDict pozostają poprawne.
+ * Zajmowane przez nią bajty są liczone przez @ref deadWordBytesOfDict.
+ * Zamrożony słownik nie jest odmrażany, pole słowa zostaje tylko opróżnione.
+ * @param[in,out] dict        - wskaźnik na słownik;
+ * @param[in] key             - klucz słowa utworzony przez @ref initDictKey;
+ * @param[in] valueDestructor - funkcja usuwająca wartość słowa lub @p NULL.
+ * @return Wartość @p true, jeśli słowo zostało usunięte. Wartość @p false, jeśli
+ * słowa nie było w słowniku, argumenty są niepoprawne lub brak pamięci.
+ */
+bool removeFromDict(Dict *dict, DictKey key, void valueDestructor(void *));
+
+/**
+ * @brief Podaje liczbę bajtów zajmowanych przez kopie słów ze słownika.
+ * @param[in] dict - wskaźnik na słownik.
+ * @return Liczba bajtów, razem z zerowymi bajtami, lub @p 0 gdy słownik to @p NULL.
+ */
+size_t liveWordBytesOfDict(const Dict *dict);
+
+/**
+ * @brief Podaje liczbę bajtów zajmowanych przez kopie usuniętych słów.
+ * Te bajty są zwalniane dopiero razem ze słownikiem, więc gdy przewyższają
+ * liczbę z @ref liveWordBytesOfDict, opłaca się zbudować słownik od nowa.
+ * @param[in] dict - wskaźnik na słownik.
+ * @return Liczba bajtów, razem z zerowymi bajtami, lub @p 0 gdy słownik to @p NULL.
+ */
+size_t deadWordBytesOfDict(const Dict *dict);
+
+/**
+ * @brief Zamraża słownik.
+ * Buduje minimalną doskonałą funkcję haszującą dla słów ze słownika
+ * i przenosi wpisy do jednego ciągłego bloku bez pustych pól.
+ * Wyszukiwanie w zamrożonym słowniku wymaga jednego hasza, jednego pola i jednego porównania.
+ * Zmiana wartości istniejącego słowa ani usunięcie słowa nie odmraża słownika.
+ * Nowe słowo zajmuje pole usuniętego słowa, jeśli w nie trafia, a w przeciwnym
+ * razie dodanie go przywraca zwykłą tablicę bez utraty wpisów.
+ * @param[in,out] dict - wskaźnik na słownik.
+ * @return Wartość @p true, jeśli słownik jest zamrożony.
+ * Wartość @p false, jeśli brak pamięci lub funkcji nie udało się zbudować,
+ * wtedy słownik działa dalej bez zmian.
+ */
+bool freezeDict(Dict *dict);
+
+/**
+ * @brief Udostępnia kolejny wpis słownika.
+ * Kursor to liczba, którą przed pierwszym wywołaniem należy ustawić na @p 0,
+ * a potem przekazywać bez zmian. Funkcja niczego nie alokuje.
+ * Wpisy są udostępniane w nieokreślonej kolejności, każdy dokładnie raz,
+ * o ile słownik nie jest w tym czasie zmieniany (poza zmianą wartości istniejących słów).
+ * Przykład: `size_t cursor = 0; DictEntry entry; while (dictForEach(dict, &cursor, &entry)) {...}`.
+ * @param[in] dict       - wskaźnik na słownik;
+ * @param[in,out] cursor - wskaźnik na kursor;
+ * @param[out] entry     - wskaźnik na strukturę, do której jest zapisywany wpis.
+ * @return Wartość @p true, jeśli wpis został udostępniony,
+ * @p false jeśli nie ma już więcej wpisów lub argumenty są niepoprawne.
+ */
+bool dictForEach(const Dict *dict, size_t *cursor, DictEntry *entry);
+
+/**
+ * @brief Tworzy słownik z podanych słów i wartości.
+ * Tablica jest od razu tworzona w docelowym rozmiarze, więc słowa są wstawiane
+ * bez powiększania i przenoszenia tablicy. Jeśli słowo się powtarza,
+ * to zostaje mu przypisana ostatnia z wartości.
+ * @param[in] keys   - tablica kluczy słów utworzonych przez @ref initDictKey;
+ * @param[in] values - tablica wartości, kolejnych dla kolejnych kluczy;
+ * @param[in] count  - liczba słów.
+ * @return Wskaźnik na utworzony słownik lub @p NULL, gdy któryś klucz jest niepoprawny,
+ * któraś wartość to @p NULL lub nie udało się zaalokować pamięci.
+ */
+Dict *dictBuildFromArray(const DictKey *keys, void *const *values, size_t count);
 
 #endif /* DROGI_DICT_H */
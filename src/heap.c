@@ -9,6 +9,31 @@
 #include "vector.h"
 
 #include <stdbool.h>
+#include <string.h>
+
+
+/* Stałe. */
+
+/** Liczba synów wierzchołka w kopcu indeksowanym. */
+#define INDEXED_HEAP_ARITY 4
+
+/** Pozycja elementu, którego nie ma na kopcu indeksowanym. */
+static const uint32_t NOT_IN_HEAP = UINT32_MAX;
+
+/**
+ * Liczba kubełków kopca pozycyjnego: jeden na klucze równe ostatnio zdjętemu
+ * i po jednym na każdy bit obu części klucza.
+ */
+#define RADIX_HEAP_BUCKETS (1 + 64 + 32)
+
+/** Kubełek elementu, którego nie ma na kopcu pozycyjnym. */
+static const uint8_t NOT_IN_BUCKET = UINT8_MAX;
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca wpis kopca indeksowanego. */
+typedef struct IndexedHeapEntryStruct IndexedHeapEntry;
 
 
 /* Deklaracje struktur. */
@@ -26,6 +51,54 @@ struct HeapStruct {
     Vector *elements;
 };
 
+/** Przechowuje wpis kopca indeksowanego, czyli klucz razem z elementem. */
+struct IndexedHeapEntryStruct {
+    /** Klucz. */
+    HeapKey key;
+    /** Element. */
+    uint32_t item;
+};
+
+/** Przechowuje kopiec indeksowany. */
+struct IndexedHeapStruct {
+    /**
+     * Tablica wpisów tworząca kopiec czwórkowy.
+     * Synami "wierzchołka" w polu @p i są pola od `(4 * i + 1)` do `(4 * i + 4)`.
+     * Płytszy kopiec wymaga mniej porównań przy dodawaniu, a synowie leżą obok siebie.
+     */
+    IndexedHeapEntry *entries;
+    /** Liczba wpisów na kopcu. */
+    size_t count;
+    /** Pozycje elementów w tablicy wpisów według elementów, @ref NOT_IN_HEAP dla elementów spoza kopca. */
+    uint32_t *positions;
+    /** Liczba możliwych elementów. */
+    size_t itemCount;
+};
+
+/**
+ * Przechowuje kopiec pozycyjny.
+ * Kubełki są listami dwukierunkowymi zapisanymi w tablicach według elementów,
+ * więc przenoszenie i usuwanie elementu nie alokuje pamięci.
+ */
+struct RadixHeapStruct {
+    /** Ostatnio zdjęty klucz, względem którego są wyznaczane kubełki. */
+    HeapKey last;
+    /** Klucze elementów według elementów. */
+    HeapKey *keys;
+    /** Następniki elementów na listach kubełków, @ref NOT_IN_HEAP na końcu listy. */
+    uint32_t *next;
+    /** Poprzedniki elementów na listach kubełków, @ref NOT_IN_HEAP na początku listy. */
+    uint32_t *previous;
+    /** Kubełki elementów, @ref NOT_IN_BUCKET dla elementów spoza kopca. */
+    uint8_t *buckets;
+    /** Pierwsze elementy list kubełków. */
+    uint32_t heads[RADIX_HEAP_BUCKETS];
+    /** Liczba elementów na kopcu. */
+    size_t count;
+    /** Liczba możliwych elementów. */
+    size_t itemCount;
+};
+
 
 /* Funkcje pomocnicze. */
 
@@ -48,6 +121,72 @@ static void swap(void **array, size_t index1, size_t index2);
  */
 static int heapCompare(Heap *heap, void *element1, void *element2);
 
+/**
+ * @brief Sprawdza czy pierwszy klucz jest mniejszy od drugiego.
+ * @param[in] key1 - pierwszy klucz;
+ * @param[in] key2 - drugi klucz.
+ * @return @p true jeśli pierwszy klucz jest mniejszy, @p false w p.p.
+ */
+static inline bool isKeyLess(HeapKey key1, HeapKey key2);
+
+/**
+ * @brief Przesuwa wpis w górę kopca indeksowanego.
+ * Wpis jest wstawiany na pozycję, na której kopiec jest poprawny,
+ * a mijane wpisy są przesuwane o poziom w dół.
+ * @param[in,out] heap - wskaźnik na kopiec;
+ * @param[in] position - pozycja, od której wpis jest przesuwany;
+ * @param[in] entry    - wpis.
+ */
+static void siftUpIndexedHeap(IndexedHeap *heap, size_t position, IndexedHeapEntry entry);
+
+/**
+ * @brief Przesuwa wpis w dół kopca indeksowanego.
+ * @param[in,out] heap - wskaźnik na kopiec;
+ * @param[in] position - pozycja, od której wpis jest przesuwany;
+ * @param[in] entry    - wpis.
+ */
+static void siftDownIndexedHeap(IndexedHeap *heap, size_t position, IndexedHeapEntry entry);
+
+/**
+ * @brief Wyznacza numer najstarszego zapalonego bitu liczby.
+ * @param[in] value - niezerowa liczba.
+ * @return Numer bitu, licząc od @p 0 dla najmłodszego.
+ */
+static inline unsigned highestBit(uint64_t value);
+
+/**
+ * @brief Wyznacza kubełek klucza w kopcu pozycyjnym.
+ * Kubełek @p 0 to klucze równe ostatnio zdjętemu, a kubełek @p b > 0 to klucze,
+ * których najstarszy bit różny od ostatnio zdjętego klucza ma numer @p b - 1,
+ * licząc bity drugiej części klucza przed bitami pierwszej.
+ * @param[in] heap - wskaźnik na kopiec;
+ * @param[in] key  - klucz nie mniejszy od ostatnio zdjętego.
+ * @return Numer kubełka.
+ */
+static inline unsigned bucketOfKey(const RadixHeap *heap, HeapKey key);
+
+/**
+ * @brief Dopisuje element na początek listy kubełka odpowiedniego dla jego klucza.
+ * @param[in,out] heap - wskaźnik na kopiec;
+ * @param[in] item     - element spoza list kubełków.
+ */
+static inline void linkToBucket(RadixHeap *heap, uint32_t item);
+
+/**
+ * @brief Wypisuje element z listy jego kubełka.
+ * @param[in,out] heap - wskaźnik na kopiec;
+ * @param[in] item     - element na liście kubełka.
+ */
+static inline void unlinkFromBucket(RadixHeap *heap, uint32_t item);
+
+/**
+ * @brief Przenosi elementy o najmniejszym kluczu do kubełka @p 0.
+ * Jeśli kubełek @p 0 jest pusty, to najmniejszy klucz z pierwszego niepustego kubełka
+ * staje się ostatnio zdjętym kluczem, a elementy tego kubełka są rozdzielane na młodsze kubełki.
+ * @param[in,out] heap - wskaźnik na niepusty kopiec.
+ */
+static void fillFirstBucket(RadixHeap *heap);
+
 
 /* Implementacja funkcji pomocniczych. */
 
@@ -76,6 +215,133 @@ static int heapCompare(Heap *heap, void *element1, void *element2) {
     return heap->comparator(element1, element2);
 }
 
+static inline bool isKeyLess(HeapKey key1, HeapKey key2) {
+    return key1.primary < key2.primary || (key1.primary == key2.primary && key1.secondary < key2.secondary);
+}
+
+static void siftUpIndexedHeap(IndexedHeap *heap, size_t position, IndexedHeapEntry entry) {
+    IndexedHeapEntry *entries = heap->entries;
+    while (position > 0) {
+        size_t upPosition = (position - 1) / INDEXED_HEAP_ARITY;
+        if (!isKeyLess(entry.key, entries[upPosition].key)) {
+            break;
+        }
+        entries[position] = entries[upPosition];
+        heap->positions[entries[position].item] = position;
+        position = upPosition;
+    }
+    entries[position] = entry;
+    heap->positions[entry.item] = position;
+}
+
+static void siftDownIndexedHeap(IndexedHeap *heap, size_t position, IndexedHeapEntry entry) {
+    IndexedHeapEntry *entries = heap->entries;
+    size_t count = heap->count;
+    while (true) {
+        size_t firstSon = position * INDEXED_HEAP_ARITY + 1;
+        if (firstSon >= count) {
+            break;
+        }
+
+        /* Wybierany jest najmniejszy z synów. */
+        size_t lastSon = firstSon + INDEXED_HEAP_ARITY < count ? firstSon + INDEXED_HEAP_ARITY : count;
+        size_t minimumSon = firstSon;
+        for (size_t son = firstSon + 1; son < lastSon; son++) {
+            if (isKeyLess(entries[son].key, entries[minimumSon].key)) {
+                minimumSon = son;
+            }
+        }
+        if (!isKeyLess(entries[minimumSon].key, entry.key)) {
+            break;
+        }
+
+        entries[position] = entries[minimumSon];
+        heap->positions[entries[position].item] = position;
+        position = minimumSon;
+    }
+    entries[position] = entry;
+    heap->positions[entry.item] = position;
+}
+
+
+static inline unsigned highestBit(uint64_t value) {
+#ifdef __GNUC__
+    return 63 - __builtin_clzll(value);
+#else
+    unsigned bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static inline unsigned bucketOfKey(const RadixHeap *heap, HeapKey key) {
+    if (key.primary != heap->last.primary) {
+        return 1 + 32 + highestBit(key.primary ^ heap->last.primary);
+    }
+    if (key.secondary != heap->last.secondary) {
+        return 1 + highestBit(key.secondary ^ heap->last.secondary);
+    }
+    return 0;
+}
+
+static inline void linkToBucket(RadixHeap *heap, uint32_t item) {
+    unsigned bucket = bucketOfKey(heap, heap->keys[item]);
+    uint32_t head = heap->heads[bucket];
+    heap->buckets[item] = bucket;
+    heap->previous[item] = NOT_IN_HEAP;
+    heap->next[item] = head;
+    if (head != NOT_IN_HEAP) {
+        heap->previous[head] = item;
+    }
+    heap->heads[bucket] = item;
+}
+
+static inline void unlinkFromBucket(RadixHeap *heap, uint32_t item) {
+    uint32_t previous = heap->previous[item];
+    uint32_t next = heap->next[item];
+    if (previous == NOT_IN_HEAP) {
+        heap->heads[heap->buckets[item]] = next;
+    } else {
+        heap->next[previous] = next;
+    }
+    if (next != NOT_IN_HEAP) {
+        heap->previous[next] = previous;
+    }
+    heap->buckets[item] = NOT_IN_BUCKET;
+}
+
+static void fillFirstBucket(RadixHeap *heap) {
+    if (heap->heads[0] != NOT_IN_HEAP) {
+        return;
+    }
+
+    /* Najmniejszy klucz jest w pierwszym niepustym kubełku. */
+    unsigned bucket = 1;
+    while (heap->heads[bucket] == NOT_IN_HEAP) {
+        bucket++;
+    }
+
+    uint32_t minimum = heap->heads[bucket];
+    for (uint32_t item = heap->next[minimum]; item != NOT_IN_HEAP; item = heap->next[item]) {
+        if (isKeyLess(heap->keys[item], heap->keys[minimum])) {
+            minimum = item;
+        }
+    }
+
+    /* Względem nowego ostatniego klucza elementy kubełka trafiają do młodszych kubełków,
+     * a pozostałe kubełki się nie zmieniają. */
+    heap->last = heap->keys[minimum];
+    uint32_t item = heap->heads[bucket];
+    heap->heads[bucket] = NOT_IN_HEAP;
+    while (item != NOT_IN_HEAP) {
+        uint32_t next = heap->next[item];
+        linkToBucket(heap, item);
+        item = next;
+    }
+}
+
 
 /* Funkcje z interfejsu. */
 
@@ -184,4 +450,182 @@ void *getMinimumFromHeap(Heap *heap) {
         }
     }
     return minimum;
-}
\ No newline at end of file
+}
+
+IndexedHeap *initIndexedHeap(size_t itemCount) {
+    if (itemCount >= NOT_IN_HEAP) {
+        return NULL;
+    }
+
+    IndexedHeap *heap = malloc(sizeof(IndexedHeap));
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    /* Każdy element jest na kopcu co najwyżej raz, więc kopiec nigdy nie rośnie. */
+    heap->entries = malloc(sizeof(IndexedHeapEntry) * (itemCount + 1));
+    heap->positions = malloc(sizeof(uint32_t) * (itemCount + 1));
+    if (heap->entries == NULL || heap->positions == NULL) {
+        deleteIndexedHeap(heap);
+        return NULL;
+    }
+
+    /* Wszystkie bajty równe 0xFF dają pozycję NOT_IN_HEAP. */
+    memset(heap->positions, 0xFF, sizeof(uint32_t) * itemCount);
+    heap->count = 0;
+    heap->itemCount = itemCount;
+    return heap;
+}
+
+void deleteIndexedHeap(IndexedHeap *heap) {
+    if (heap == NULL) {
+        return;
+    }
+
+    free(heap->entries);
+    free(heap->positions);
+    free(heap);
+}
+
+bool isEmptyIndexedHeap(const IndexedHeap *heap) {
+    return heap == NULL || heap->count == 0;
+}
+
+void pushToIndexedHeap(IndexedHeap *heap, uint32_t item, HeapKey key) {
+    if (heap == NULL || item >= heap->itemCount) {
+        return;
+    }
+
+    IndexedHeapEntry entry = {key, item};
+    uint32_t position = heap->positions[item];
+    if (position == NOT_IN_HEAP) {
+        /* Nowy wpis zaczyna w pierwszym wolnym liściu. */
+        siftUpIndexedHeap(heap, heap->count++, entry);
+    } else if (isKeyLess(key, heap->entries[position].key)) {
+        siftUpIndexedHeap(heap, position, entry);
+    }
+}
+
+void clearIndexedHeap(IndexedHeap *heap) {
+    if (heap == NULL) {
+        return;
+    }
+
+    for (size_t position = 0; position < heap->count; position++) {
+        heap->positions[heap->entries[position].item] = NOT_IN_HEAP;
+    }
+    heap->count = 0;
+}
+
+HeapKey minimumKeyOfIndexedHeap(const IndexedHeap *heap) {
+    return heap->entries[0].key;
+}
+
+uint32_t popFromIndexedHeap(IndexedHeap *heap, HeapKey *key) {
+    IndexedHeapEntry minimum = heap->entries[0];
+    heap->positions[minimum.item] = NOT_IN_HEAP;
+    if (key != NULL) {
+        *key = minimum.key;
+    }
+
+    /* Ostatni wpis trafia w miejsce zdjętego i jest spychany w dół. */
+    heap->count--;
+    if (heap->count > 0) {
+        siftDownIndexedHeap(heap, 0, heap->entries[heap->count]);
+    }
+    return minimum.item;
+}
+
+RadixHeap *initRadixHeap(size_t itemCount) {
+    if (itemCount >= NOT_IN_HEAP) {
+        return NULL;
+    }
+
+    RadixHeap *heap = malloc(sizeof(RadixHeap));
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    heap->keys = malloc(sizeof(HeapKey) * (itemCount + 1));
+    heap->next = malloc(sizeof(uint32_t) * (itemCount + 1));
+    heap->previous = malloc(sizeof(uint32_t) * (itemCount + 1));
+    heap->buckets = malloc(sizeof(uint8_t) * (itemCount + 1));
+    if (heap->keys == NULL || heap->next == NULL || heap->previous == NULL || heap->buckets == NULL) {
+        deleteRadixHeap(heap);
+        return NULL;
+    }
+
+    memset(heap->buckets, NOT_IN_BUCKET, sizeof(uint8_t) * itemCount);
+    for (size_t bucket = 0; bucket < RADIX_HEAP_BUCKETS; bucket++) {
+        heap->heads[bucket] = NOT_IN_HEAP;
+    }
+    heap->last.primary = 0;
+    heap->last.secondary = 0;
+    heap->count = 0;
+    heap->itemCount = itemCount;
+    return heap;
+}
+
+void deleteRadixHeap(RadixHeap *heap) {
+    if (heap == NULL) {
+        return;
+    }
+
+    free(heap->keys);
+    free(heap->next);
+    free(heap->previous);
+    free(heap->buckets);
+    free(heap);
+}
+
+bool isEmptyRadixHeap(const RadixHeap *heap) {
+    return heap == NULL || heap->count == 0;
+}
+
+void pushToRadixHeap(RadixHeap *heap, uint32_t item, HeapKey key) {
+    if (heap == NULL || item >= heap->itemCount) {
+        return;
+    }
+
+    if (heap->buckets[item] == NOT_IN_BUCKET) {
+        heap->count++;
+    } else if (isKeyLess(key, heap->keys[item])) {
+        unlinkFromBucket(heap, item);
+    } else {
+        return;
+    }
+    heap->keys[item] = key;
+    linkToBucket(heap, item);
+}
+
+void clearRadixHeap(RadixHeap *heap) {
+    if (heap == NULL) {
+        return;
+    }
+
+    for (size_t bucket = 0; bucket < RADIX_HEAP_BUCKETS; bucket++) {
+        for (uint32_t item = heap->heads[bucket]; item != NOT_IN_HEAP; item = heap->next[item]) {
+            heap->buckets[item] = NOT_IN_BUCKET;
+        }
+        heap->heads[bucket] = NOT_IN_HEAP;
+    }
+    heap->last.primary = 0;
+    heap->last.secondary = 0;
+    heap->count = 0;
+}
+
+HeapKey minimumKeyOfRadixHeap(RadixHeap *heap) {
+    fillFirstBucket(heap);
+    return heap->last;
+}
+
+uint32_t popFromRadixHeap(RadixHeap *heap, HeapKey *key) {
+    fillFirstBucket(heap);
+    uint32_t item = heap->heads[0];
+    unlinkFromBucket(heap, item);
+    heap->count--;
+    if (key != NULL) {
+        *key = heap->keys[item];
+    }
+    return item;
+}
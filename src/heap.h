@@ -1,6 +1,15 @@
 /** @file
  * Interfejs klasy przechowującej minimalny kopiec.
  *
+ * Oprócz ogólnego kopca wskaźników z komparatorem jest tu kopiec indeksowany,
+ * który trzyma klucze bezpośrednio w tablicy, zna pozycję każdego elementu
+ * i pozwala zmniejszyć jego klucz, więc nie alokuje pamięci przy dodawaniu.
+ * Kopiec pozycyjny ma ten sam interfejs, ale zamiast porównywać klucze trzyma je
+ * w kubełkach według najstarszego bitu, którym różnią się od ostatnio zdjętego klucza.
+ * Wymaga, żeby dodawane klucze nie były mniejsze od ostatnio zdjętego, co zachodzi
+ * w algorytmie Dijkstry, i wtedy każdy element jest przenoszony co najwyżej tyle razy,
+ * ile klucz ma bitów.
+ *
  * @author Antoni Żewierżejew <azewierzejew@gmail.com>
  * @date 29.03.2019
  */
@@ -9,10 +18,32 @@
 #define DROGI_HEAP_H
 
 #include <stdbool.h>
+#include <stdlib.h>
+#include <inttypes.h>
 
 /** Struktura przechowująca kopiec. */
 typedef struct HeapStruct Heap;
 
+/** Struktura przechowująca kopiec indeksowany. */
+typedef struct IndexedHeapStruct IndexedHeap;
+
+/** Struktura przechowująca kopiec pozycyjny. */
+typedef struct RadixHeapStruct RadixHeap;
+
+/** Struktura przechowująca klucz w kopcu indeksowanym i pozycyjnym. */
+typedef struct HeapKeyStruct HeapKey;
+
+/**
+ * Przechowuje klucz w kopcu indeksowanym i pozycyjnym.
+ * Klucze są porównywane leksykograficznie, najpierw @p primary, potem @p secondary.
+ */
+struct HeapKeyStruct {
+    /** Pierwsza część klucza. */
+    uint64_t primary;
+    /** Druga część klucza, rozstrzygająca przy równych pierwszych. */
+    uint32_t secondary;
+};
+
 /**
  * @brief Tworzy nowy kopiec.
  * Tworzy pusty kopiec przypisując mu komparator definiujący porządek.
@@ -56,4 +87,118 @@ bool addToHeap(Heap *heap, void **valuePtr);
  */
 void *getMinimumFromHeap(Heap *heap);
 
+/**
+ * @brief Tworzy nowy pusty kopiec indeksowany.
+ * Elementami kopca są liczby od @p 0 do @p itemCount - 1, każda może być na kopcu
+ * co najwyżej raz. Cała pamięć jest alokowana od razu.
+ * @param[in] itemCount - liczba możliwych elementów, mniejsza od @p UINT32_MAX.
+ * @return Wskaźnik na kopiec, @p NULL w wypadku niepowodzenia.
+ */
+IndexedHeap *initIndexedHeap(size_t itemCount);
+
+/**
+ * @brief Usuwa kopiec indeksowany.
+ * Jeśli kopiec to @p NULL nic nie robi.
+ * @param[in,out] heap - wskaźnik na kopiec.
+ */
+void deleteIndexedHeap(IndexedHeap *heap);
+
+/**
+ * Sprawdza czy kopiec indeksowany jest pusty.
+ * @param[in] heap - wskaźnik na kopiec.
+ * @return @p true lub @p false w zależności od stanu kopca.
+ */
+bool isEmptyIndexedHeap(const IndexedHeap *heap);
+
+/**
+ * @brief Dodaje element do kopca indeksowanego lub zmniejsza jego klucz.
+ * Jeśli element jest już na kopcu z kluczem nie większym od podanego nic nie robi.
+ * Nie alokuje pamięci.
+ * @param[in,out] heap - wskaźnik na kopiec;
+ * @param[in] item     - element, mniejszy od liczby możliwych elementów;
+ * @param[in] key      - klucz elementu.
+ */
+void pushToIndexedHeap(IndexedHeap *heap, uint32_t item, HeapKey key);
+
+/**
+ * @brief Usuwa wszystkie elementy z kopca indeksowanego.
+ * Działa w czasie proporcjonalnym do liczby elementów na kopcu.
+ * @param[in,out] heap - wskaźnik na kopiec.
+ */
+void clearIndexedHeap(IndexedHeap *heap);
+
+/**
+ * @brief Odczytuje najmniejszy klucz na kopcu indeksowanym.
+ * @param[in] heap - wskaźnik na niepusty kopiec.
+ * @return Najmniejszy klucz.
+ */
+HeapKey minimumKeyOfIndexedHeap(const IndexedHeap *heap);
+
+/**
+ * @brief Zdejmuje z kopca indeksowanego element o najmniejszym kluczu.
+ * W wypadku kilku takich samych kluczy zdejmuje jeden z nich.
+ * @param[in,out] heap - wskaźnik na niepusty kopiec;
+ * @param[out] key     - wskaźnik na miejsce na klucz elementu lub @p NULL.
+ * @return Zdjęty element.
+ */
+uint32_t popFromIndexedHeap(IndexedHeap *heap, HeapKey *key);
+
+/**
+ * @brief Tworzy nowy pusty kopiec pozycyjny.
+ * Elementami kopca są liczby od @p 0 do @p itemCount - 1, każda może być na kopcu
+ * co najwyżej raz. Cała pamięć jest alokowana od razu.
+ * @param[in] itemCount - liczba możliwych elementów, mniejsza od @p UINT32_MAX.
+ * @return Wskaźnik na kopiec, @p NULL w wypadku niepowodzenia.
+ */
+RadixHeap *initRadixHeap(size_t itemCount);
+
+/**
+ * @brief Usuwa kopiec pozycyjny.
+ * Jeśli kopiec to @p NULL nic nie robi.
+ * @param[in,out] heap - wskaźnik na kopiec.
+ */
+void deleteRadixHeap(RadixHeap *heap);
+
+/**
+ * Sprawdza czy kopiec pozycyjny jest pusty.
+ * @param[in] heap - wskaźnik na kopiec.
+ * @return @p true lub @p false w zależności od stanu kopca.
+ */
+bool isEmptyRadixHeap(const RadixHeap *heap);
+
+/**
+ * @brief Dodaje element do kopca pozycyjnego lub zmniejsza jego klucz.
+ * Klucz nie może być mniejszy od ostatnio zdjętego klucza.
+ * Jeśli element jest już na kopcu z kluczem nie większym od podanego nic nie robi.
+ * Nie alokuje pamięci.
+ * @param[in,out] heap - wskaźnik na kopiec;
+ * @param[in] item     - element, mniejszy od liczby możliwych elementów;
+ * @param[in] key      - klucz elementu.
+ */
+void pushToRadixHeap(RadixHeap *heap, uint32_t item, HeapKey key);
+
+/**
+ * @brief Usuwa wszystkie elementy z kopca pozycyjnego i zapomina ostatnio zdjęty klucz.
+ * Działa w czasie proporcjonalnym do liczby elementów na kopcu.
+ * @param[in,out] heap - wskaźnik na kopiec.
+ */
+void clearRadixHeap(RadixHeap *heap);
+
+/**
+ * @brief Odczytuje najmniejszy klucz na kopcu pozycyjnym.
+ * Może przenieść elementy między kubełkami, dlatego zmienia kopiec.
+ * @param[in,out] heap - wskaźnik na niepusty kopiec.
+ * @return Najmniejszy klucz.
+ */
+HeapKey minimumKeyOfRadixHeap(RadixHeap *heap);
+
+/**
+ * @brief Zdejmuje z kopca pozycyjnego element o najmniejszym kluczu.
+ * W wypadku kilku takich samych kluczy zdejmuje jeden z nich.
+ * @param[in,out] heap - wskaźnik na niepusty kopiec;
+ * @param[out] key     - wskaźnik na miejsce na klucz elementu lub @p NULL.
+ * @return Zdjęty element.
+ */
+uint32_t popFromRadixHeap(RadixHeap *heap, HeapKey *key);
+
 #endif /* DROGI_HEAP_H */
@@ -11,6 +11,11 @@
 #include "map_graph.h"
 #include "map_route.h"
 #include "map_find_route.h"
+#include "road_index.h"
+#include "map_csr.h"
+#include "map_reorder.h"
+#include "map_compact.h"
+#include "map_landmarks.h"
 
 #include "vector.h"
 #include "dict.h"
@@ -23,6 +28,31 @@
 #include <inttypes.h>
 
 
+/* Stałe. */
+
+/** Początkowa liczba miejsc na stosie wolnych id. */
+static const size_t INITIAL_FREE_IDS_CAPACITY = 16;
+/** Najmniejsza liczba miast, przy której miasta są przenumerowywane po wczytaniu serii odcinków. */
+static const size_t AUTO_REORDER_MIN_CITIES = 1024;
+/**
+ * Miasta są przenumerowywane po wczytaniu serii odcinków, gdy jest ich tyle razy więcej
+ * niż po ostatnim przenumerowaniu, więc koszt rozkłada się na dodane miasta.
+ */
+static const size_t AUTO_REORDER_GROWTH = 2;
+/**
+ * Słownik nazw jest zamrażany po wczytaniu serii odcinków, gdy od ostatniego zamrożenia
+ * przybyło co najmniej tyle razy mniej miast niż jest na mapie, więc koszt rozkłada się na dodane miasta.
+ */
+static const size_t AUTO_FREEZE_DIVISOR = 4;
+/** Najmniejsza liczba usuniętych odcinków, po której pamięć jest porządkowana automatycznie. */
+static const size_t AUTO_COMPACT_MIN_REMOVALS = 1024;
+/**
+ * Pamięć jest porządkowana automatycznie, gdy usuniętych odcinków jest więcej niż
+ * liczba miast podzielona przez tę stałą, więc koszt rozkłada się na usunięcia.
+ */
+static const size_t AUTO_COMPACT_DIVISOR = 4;
+
+
 /* Funkcje pomocnicze. */
 
 /**
@@ -36,14 +66,44 @@
 static bool checkForDuplicateIds(size_t **idsPtr, size_t idCount);
 
 /**
- * @brief Dodaje miasto do mapy.
- * Dla danej nazwy miasta tworzy je i dodaje do słownika.
+ * @brief Tworzy nowe miasto mapy.
+ * Funkcja przekazywana do słownika miast, wywoływana dla nazwy, której w nim nie ma.
+ * Id jest zatwierdzane dopiero po udanym utworzeniu miasta, więc brak pamięci
+ * nie zostawia luk w id. Gdy skończą się 32-bitowe id, miasto nie jest tworzone.
+ * @param[in,out] mapPtr - wskaźnik na mapę;
+ * @param[in] name       - nazwa miasta przechowywana przez słownik;
+ * @param[in] nameLength - długość nazwy.
+ * @return Wskaźnik na miasto lub @p NULL gdy brak pamięci.
+ */
+static void *createCity(void *mapPtr, const char *name, size_t nameLength);
+
+/**
+ * @brief Udostępnia miasto o danej nazwie, a jeśli go nie ma, to dodaje je do mapy.
  * Nie sprawdza poprawności nazwy.
+ * @param[in,out] map - wskaźnik na mapę;
+ * @param[in] cityKey - klucz nazwy miasta.
+ * @return Wskaźnik na miasto jeśli istnieje lub sie udało je dodać, @p NULL w p.p.
+ */
+static City *getOrAddCity(Map *map, CityKey cityKey);
+
+/**
+ * @brief Usuwa miasto, jeśli nie wychodzą z niego żadne odcinki.
+ * Takie miasto nie należy też do żadnej drogi krajowej, więc jest usuwane
+ * ze słownika miast, a jego id trafia na stos wolnych id.
+ * Jeśli brakuje pamięci, miasto pozostaje na mapie.
+ * Miasto jest usuwane ze słownika przez klucz podany przy komendzie, więc nazwa nie jest haszowana ponownie.
  * @param[in,out] map  - wskaźnik na mapę;
- * @param[in] cityName - nazwa miasta.
- * @return Wskaźnik na miasto jeśli sie udało dodać, @p NULL w p.p.
+ * @param[in,out] city - wskaźnik na miasto lub @p NULL;
+ * @param[in] cityKey  - klucz nazwy miasta.
+ */
+static void reclaimCityIfIsolated(Map *map, City *city, CityKey cityKey);
+
+/**
+ * @brief Wykonuje krok porządkowania pamięci, jeśli od ostatniego porządkowania usunięto dużo odcinków.
+ * Wywoływana po każdym usunięciu odcinka. Kolejne kroki są wykonywane przy kolejnych usunięciach.
+ * @param[in,out] map - wskaźnik na mapę.
  */
-static City *addCity(Map *map, const char *cityName);
+static void compactAfterChurn(Map *map);
 
 /**
  * @brief Porównuje dwie liczby typu @p size_t.
@@ -85,19 +145,66 @@ static bool checkForDuplicateIds(size_t **idsPtr, size_t idCount) {
     return true;
 }
 
-static City *addCity(Map *map, const char *cityName) {
-    City *city = NULL;
-    FAIL_IF(map == NULL);
+static void *createCity(void *mapPtr, const char *name, size_t nameLength) {
+    Map *map = mapPtr;
+
+    /* Najpierw są używane id zwolnione przez usunięte miasta. */
+    bool recycled = map->freeIdCount > 0;
+    size_t id = recycled ? map->freeIds[map->freeIdCount - 1] : map->cityCount;
+    City *city = id < NO_CITY_ID ? initCity(map->memory, name, nameLength, (uint32_t) id) : NULL;
+    if (city == NULL) {
+        return NULL;
+    }
 
-    city = initCity(cityName, map->cityCount);
-    FAIL_IF(city == NULL || !addToDict(map->cities, cityName, city));
-    map->cityCount++;
+    if (recycled) {
+        map->freeIdCount--;
+    } else {
+        map->cityCount++;
+    }
+    map->unfrozenCityCount++;
     return city;
+}
 
-    FAILURE:
+static void reclaimCityIfIsolated(Map *map, City *city, CityKey cityKey) {
+    if (city == NULL || city->roadCount > 0) {
+        return;
+    }
+
+    /* Miejsce na id jest zapewniane przed usunięciem miasta, żeby id nie przepadło. */
+    if (map->freeIdCount == map->freeIdCapacity) {
+        size_t newCapacity = map->freeIdCapacity == 0 ? INITIAL_FREE_IDS_CAPACITY : map->freeIdCapacity * 2;
+        uint32_t *newFreeIds = realloc(map->freeIds, sizeof(uint32_t) * newCapacity);
+        if (newFreeIds == NULL) {
+            return;
+        }
+        map->freeIds = newFreeIds;
+        map->freeIdCapacity = newCapacity;
+    }
+
+    if (!removeFromDict(map->cities, cityKey, NULL)) {
+        return;
+    }
 
-    deleteCity(city);
-    return NULL;
+    map->freeIds[map->freeIdCount++] = city->id;
+    deleteCity(map->memory, city);
+}
+
+static void compactAfterChurn(Map *map) {
+    map->removedRoadCount++;
+    size_t cityCount = map->cityCount;
+    if (map->removedRoadCount >= AUTO_COMPACT_MIN_REMOVALS &&
+        map->removedRoadCount * AUTO_COMPACT_DIVISOR >= cityCount) {
+        compactMapStep(map);
+    }
+}
+
+static City *getOrAddCity(Map *map, CityKey cityKey) {
+    if (map == NULL) {
+        return NULL;
+    }
+
+    /* Miasto korzysta z kopii nazwy trzymanej przez słownik. */
+    return getOrInsertInDict(map->cities, cityKey, createCity, map);
 }
 
 int compareSize_t(const void *aPtr, const void *bPtr) {
@@ -125,6 +232,28 @@ int compareSize_t(const void *aPtr, const void *bPtr) {
 
 /* Funkcje z interfejsu. */
 
+CityKey initCityKey(const char *cityName) {
+    return scanCityKey(cityName, '\0');
+}
+
+CityKey scanCityKey(const char *text, char terminator) {
+    CityKey key = scanDictKey(text, terminator, isCorrectNameChar);
+    if (key.length == 0) {
+        /* Pusta nazwa jest niepoprawna. */
+        key.word = NULL;
+    }
+    return key;
+}
+
+bool freezeCityNames(Map *map) {
+    if (map == NULL || !freezeDict(map->cities)) {
+        return false;
+    }
+
+    map->unfrozenCityCount = 0;
+    return true;
+}
+
 Map *newMap() {
     Map *map = malloc(sizeof(Map));
     if (map == NULL) {
@@ -132,15 +261,59 @@ Map *newMap() {
     }
 
     map->cities = initDict();
+    map->memory = initGraphMemory();
+    map->roadIndex = initRoadIndex();
+    map->csr = initCsrGraph();
+    map->searchWorkspace = initSearchWorkspace();
+    map->landmarks = initLandmarks();
     map->routes = calloc(MAX_ROUTE_ID + 1, sizeof(Route));
     map->cityCount = 0;
-    if (map->cities == NULL || map->routes == NULL) {
+    map->freeIds = NULL;
+    map->freeIdCount = 0;
+    map->freeIdCapacity = 0;
+    map->reorderedCityCount = 0;
+    map->unfrozenCityCount = 0;
+    map->compactionStage = COMPACTION_ADJACENCY;
+    map->compactionCursor = 0;
+    map->removedRoadCount = 0;
+    if (map->cities == NULL || map->memory == NULL || map->roadIndex == NULL || map->csr == NULL ||
+        map->searchWorkspace == NULL || map->landmarks == NULL || map->routes == NULL) {
         deleteMap(map);
         return NULL;
     }
     return map;
 }
 
+bool reorderMap(Map *map) {
+    if (map == NULL || !renumberCities(map)) {
+        return false;
+    }
+
+    map->reorderedCityCount = map->cityCount;
+    /* Słownik nazw został zbudowany od nowa, więc nie jest zamrożony. */
+    map->unfrozenCityCount = map->reorderedCityCount;
+    return true;
+}
+
+void finishBulkLoad(Map *map) {
+    if (map == NULL) {
+        return;
+    }
+
+    /* Brak pamięci nie jest błędem, wtedy mapa po prostu nie jest przenumerowana. */
+    size_t cityCount = map->cityCount;
+    if (cityCount >= AUTO_REORDER_MIN_CITIES && cityCount >= map->reorderedCityCount * AUTO_REORDER_GROWTH) {
+        reorderMap(map);
+    }
+    if (map->unfrozenCityCount > 0 && map->unfrozenCityCount * AUTO_FREEZE_DIVISOR >= cityCount) {
+        freezeCityNames(map);
+    }
+}
+
+bool compactMap(Map *map) {
+    return compactMapStep(map);
+}
+
 void deleteMap(Map *map) {
     if (map == NULL) {
         return;
@@ -152,64 +325,83 @@ void deleteMap(Map *map) {
         }
     }
 
-    deleteDict(map->cities, deleteCity);
+    deleteRoadIndex(map->roadIndex);
+    deleteCsrGraph(map->csr);
+    deleteSearchWorkspace(map->searchWorkspace);
+    deleteLandmarks(map->landmarks);
+    /* Miasta i odcinki są zwalniane naraz razem z pamięcią grafu. */
+    deleteDict(map->cities, NULL);
+    deleteGraphMemory(map->memory);
     free(map->routes);
+    free(map->freeIds);
     free(map);
 }
 
 bool addRoad(Map *map, const char *cityName1, const char *cityName2, unsigned length, int builtYear) {
+    return addRoadKeyed(map, initCityKey(cityName1), initCityKey(cityName2), length, builtYear);
+}
+
+bool addRoadKeyed(Map *map, CityKey cityKey1, CityKey cityKey2, unsigned length, int builtYear) {
     City *city1 = NULL;
     City *city2 = NULL;
     Road *road = NULL;
 
     FAIL_IF(map == NULL || builtYear == 0 || length == 0);
-    FAIL_IF(!checkName(cityName1) || !checkName(cityName2) || strcmp(cityName1, cityName2) == 0);
-
-    city1 = valueInDict(map->cities, cityName1);
-    city2 = valueInDict(map->cities, cityName2);
+    FAIL_IF(!checkCityKey(cityKey1) || !checkCityKey(cityKey2) || equalCityKeys(cityKey1, cityKey2));
 
     /* Jeśli nie ma miast to są dodawane. */
-    city1 = city1 == NULL ? addCity(map, cityName1) : city1;
-    city2 = city2 == NULL ? addCity(map, cityName2) : city2;
+    city1 = getOrAddCity(map, cityKey1);
+    city2 = getOrAddCity(map, cityKey2);
 
     FAIL_IF(city1 == NULL || city2 == NULL);
-    FAIL_IF(findRoad(city1, city2) != NULL);
+    FAIL_IF(findRoad(map->roadIndex, city1, city2) != NULL);
 
-    road = initRoad(builtYear, length, city1, city2);
+    road = initRoad(map->memory, builtYear, length, city1, city2);
     FAIL_IF(road == NULL);
-    FAIL_IF(!pushToVector(city1->roads, road));
-    FAIL_IF(!pushToVector(city2->roads, road));
+    FAIL_IF(!addRoadToCity(map->memory, city1, road));
+    FAIL_IF(!addRoadToCity(map->memory, city2, road));
+    FAIL_IF(!addToRoadIndex(map->roadIndex, road));
+    markCityChanged(map->csr, city1->id);
+    markCityChanged(map->csr, city2->id);
+    addRoadToLandmarks(map->landmarks, map, road);
 
     return true;
 
     FAILURE:
 
-    if (city1 != NULL) {
-        popFromVector(city1->roads, road, NULL);
+    if (map != NULL) {
+        removeRoadFromCity(map->memory, city1, road);
+        removeRoadFromCity(map->memory, city2, road);
+        deleteRoad(map->memory, road);
+        /* Nowo dodane miasta nie mogą zostać na mapie bez żadnego odcinka. */
+        reclaimCityIfIsolated(map, city1, cityKey1);
+        reclaimCityIfIsolated(map, city2, cityKey2);
     }
-    if (city2 != NULL) {
-        popFromVector(city2->roads, road, NULL);
-    }
-    deleteRoad(road);
     return false;
 }
 
 bool repairRoad(Map *map, const char *cityName1, const char *cityName2, int repairYear) {
+    return repairRoadKeyed(map, initCityKey(cityName1), initCityKey(cityName2), repairYear);
+}
+
+bool repairRoadKeyed(Map *map, CityKey cityKey1, CityKey cityKey2, int repairYear) {
     City *city1 = NULL;
     City *city2 = NULL;
     Road *road = NULL;
 
     FAIL_IF(map == NULL || repairYear == 0);
-    FAIL_IF(!checkName(cityName1) || !checkName(cityName2) || strcmp(cityName1, cityName2) == 0);
+    FAIL_IF(!checkCityKey(cityKey1) || !checkCityKey(cityKey2) || equalCityKeys(cityKey1, cityKey2));
 
-    city1 = valueInDict(map->cities, cityName1);
-    city2 = valueInDict(map->cities, cityName2);
-    road = findRoad(city1, city2);
+    city1 = valueInDictKeyed(map->cities, cityKey1);
+    city2 = valueInDictKeyed(map->cities, cityKey2);
+    road = findRoad(map->roadIndex, city1, city2);
 
     FAIL_IF(city1 == NULL || city2 == NULL || road == NULL);
     FAIL_IF(road->lastRepaired > repairYear);
 
     road->lastRepaired = repairYear;
+    markCityChanged(map->csr, city1->id);
+    markCityChanged(map->csr, city2->id);
     return true;
 
     FAILURE:
@@ -219,16 +411,21 @@ bool repairRoad(Map *map, const char *cityName1, const char *cityName2, int repa
 
 RoadStatus getRoadStatus(Map *map, const char *cityName1, const char *cityName2,
                          unsigned length, int repairYear) {
+    return getRoadStatusKeyed(map, initCityKey(cityName1), initCityKey(cityName2), length, repairYear);
+}
+
+RoadStatus getRoadStatusKeyed(Map *map, CityKey cityKey1, CityKey cityKey2,
+                              unsigned length, int repairYear) {
     City *city1 = NULL;
     City *city2 = NULL;
     Road *road = NULL;
 
     FAIL_IF(map == NULL || repairYear == 0 || length == 0);
-    FAIL_IF(!checkName(cityName1) || !checkName(cityName2) || strcmp(cityName1, cityName2) == 0);
+    FAIL_IF(!checkCityKey(cityKey1) || !checkCityKey(cityKey2) || equalCityKeys(cityKey1, cityKey2));
 
-    city1 = valueInDict(map->cities, cityName1);
-    city2 = valueInDict(map->cities, cityName2);
-    road = findRoad(city1, city2);
+    city1 = valueInDictKeyed(map->cities, cityKey1);
+    city2 = valueInDictKeyed(map->cities, cityKey2);
+    road = findRoad(map->roadIndex, city1, city2);
 
     if (road == NULL) {
         return ROAD_ADDABLE;
@@ -248,16 +445,20 @@ RoadStatus getRoadStatus(Map *map, const char *cityName1, const char *cityName2,
 }
 
 bool newRoute(Map *map, unsigned routeId, const char *cityName1, const char *cityName2) {
+    return newRouteKeyed(map, routeId, initCityKey(cityName1), initCityKey(cityName2));
+}
+
+bool newRouteKeyed(Map *map, unsigned routeId, CityKey cityKey1, CityKey cityKey2) {
     City *city1 = NULL;
     City *city2 = NULL;
     Vector *roads = NULL;
     Route *route = NULL;
 
     FAIL_IF(map == NULL || !checkRouteId(routeId) || map->routes[routeId] != NULL);
-    FAIL_IF(!checkName(cityName1) || !checkName(cityName2) || strcmp(cityName1, cityName2) == 0);
+    FAIL_IF(!checkCityKey(cityKey1) || !checkCityKey(cityKey2) || equalCityKeys(cityKey1, cityKey2));
 
-    city1 = valueInDict(map->cities, cityName1);
-    city2 = valueInDict(map->cities, cityName2);
+    city1 = valueInDictKeyed(map->cities, cityKey1);
+    city2 = valueInDictKeyed(map->cities, cityKey2);
     FAIL_IF(city1 == NULL || city2 == NULL);
 
     roads = findRoute(map, city1, city2, NULL).roads;
@@ -277,6 +478,26 @@ bool newRoute(Map *map, unsigned routeId, const char *cityName1, const char *cit
 }
 
 bool createRoute(Map *map, unsigned routeId, const char **cityNames, size_t cityCount) {
+    CityKey *cityKeys = NULL;
+    FAIL_IF(cityNames == NULL || cityCount < 2);
+
+    cityKeys = malloc(sizeof(CityKey) * cityCount);
+    FAIL_IF(cityKeys == NULL);
+    for (size_t i = 0; i < cityCount; i++) {
+        cityKeys[i] = initCityKey(cityNames[i]);
+    }
+
+    bool result = createRouteKeyed(map, routeId, cityKeys, cityCount);
+    free(cityKeys);
+    return result;
+
+    FAILURE:
+
+    free(cityKeys);
+    return false;
+}
+
+bool createRouteKeyed(Map *map, unsigned routeId, const CityKey *cityKeys, size_t cityCount) {
     Vector *roads = NULL;
     City *firstCity = NULL;
     City *lastCity = NULL;
@@ -284,19 +505,19 @@ bool createRoute(Map *map, unsigned routeId, const char **cityNames, size_t city
     Route *route = NULL;
 
     FAIL_IF(map == NULL || !checkRouteId(routeId) || map->routes[routeId] != NULL || cityCount < 2);
-    FAIL_IF(cityNames == NULL || !checkName(cityNames[0]));
+    FAIL_IF(cityKeys == NULL || !checkCityKey(cityKeys[0]));
 
     roads = initVector();
     usedCities = malloc(sizeof(size_t) * cityCount);
     FAIL_IF(roads == NULL || usedCities == NULL);
 
-    firstCity = valueInDict(map->cities, cityNames[0]);
+    firstCity = valueInDictKeyed(map->cities, cityKeys[0]);
     /* Nie ma sprawdzenia czy miasta są NULL bo wystarczy sprawdzać drogę. */
     lastCity = firstCity;
     for (size_t i = 0; i < cityCount - 1; i++) {
-        FAIL_IF(!checkName(cityNames[i + 1]));
-        City *nextCity = valueInDict(map->cities, cityNames[i + 1]);
-        Road *road = findRoad(lastCity, nextCity);
+        FAIL_IF(!checkCityKey(cityKeys[i + 1]));
+        City *nextCity = valueInDictKeyed(map->cities, cityKeys[i + 1]);
+        Road *road = findRoad(map->roadIndex, lastCity, nextCity);
         FAIL_IF(road == NULL || !pushToVector(roads, road));
         usedCities[i] = lastCity->id;
         lastCity = nextCity;
@@ -321,19 +542,23 @@ bool createRoute(Map *map, unsigned routeId, const char **cityNames, size_t city
 }
 
 bool extendRoute(Map *map, unsigned routeId, const char *cityName) {
+    return extendRouteKeyed(map, routeId, initCityKey(cityName));
+}
+
+bool extendRouteKeyed(Map *map, unsigned routeId, CityKey cityKey) {
     Vector *roads1 = NULL;
     Vector *roads2 = NULL;
-    FAIL_IF(map == NULL || !checkRouteId(routeId) || !checkName(cityName));
+    FAIL_IF(map == NULL || !checkRouteId(routeId) || !checkCityKey(cityKey));
 
     Route *route = map->routes[routeId];
-    City *city = valueInDict(map->cities, cityName);
+    City *city = valueInDictKeyed(map->cities, cityKey);
     FAIL_IF(city == NULL || route == NULL);
 
     {
         size_t usedRoadsCount = sizeOfVector(route->roads);
         Road **usedRoadsArray = (Road **) storageBlockOfVector(route->roads);
         for (size_t i = 0; i < usedRoadsCount; i++) {
-            FAIL_IF(usedRoadsArray[i]->end1 == city || usedRoadsArray[i]->end2 == city);
+            FAIL_IF(usedRoadsArray[i]->end1Id == city->id || usedRoadsArray[i]->end2Id == city->id);
         }
     }
 
@@ -413,22 +638,28 @@ bool extendRoute(Map *map, unsigned routeId, const char *cityName) {
 }
 
 bool removeRoad(Map *map, const char *cityName1, const char *cityName2) {
+    return removeRoadKeyed(map, initCityKey(cityName1), initCityKey(cityName2));
+}
+
+bool removeRoadKeyed(Map *map, CityKey cityKey1, CityKey cityKey2) {
     Road *road = NULL;
     int oldYear = 0;
     Vector **replacementParts = NULL;
     FAIL_IF(map == NULL);
-    FAIL_IF(!checkName(cityName1) || !checkName(cityName2) || strcmp(cityName1, cityName2) == 0);
+    FAIL_IF(!checkCityKey(cityKey1) || !checkCityKey(cityKey2) || equalCityKeys(cityKey1, cityKey2));
 
-    City *city1 = valueInDict(map->cities, cityName1);
-    City *city2 = valueInDict(map->cities, cityName2);
+    City *city1 = valueInDictKeyed(map->cities, cityKey1);
+    City *city2 = valueInDictKeyed(map->cities, cityKey2);
     FAIL_IF(city1 == NULL || city2 == NULL);
 
-    road = findRoad(city1, city2);
+    road = findRoad(map->roadIndex, city1, city2);
     FAIL_IF(road == NULL);
 
     /* Przeszukiwanie grafu nie będzie mogło użyć tego odcinka, bo jest "zablokowany". */
     oldYear = road->lastRepaired;
     road->lastRepaired = 0;
+    markCityChanged(map->csr, city1->id);
+    markCityChanged(map->csr, city2->id);
 
     replacementParts = calloc(MAX_ROUTE_ID + 1, sizeof(Vector *));
     FAIL_IF(replacementParts == NULL);
@@ -460,10 +691,16 @@ bool removeRoad(Map *map, const char *cityName1, const char *cityName2) {
         }
     }
 
-    popFromVector(city1->roads, road, NULL);
-    popFromVector(city2->roads, road, NULL);
+    removeRoadFromCity(map->memory, city1, road);
+    removeRoadFromCity(map->memory, city2, road);
+    removeFromRoadIndex(map->roadIndex, road);
     free(replacementParts);
-    deleteRoad(road);
+    deleteRoad(map->memory, road);
+    reclaimCityIfIsolated(map, city1, cityKey1);
+    reclaimCityIfIsolated(map, city2, cityKey2);
+    /* Usunięcie odcinka może tylko wydłużyć drogi, więc odległości dalej dają poprawne ograniczenia. */
+    markLandmarksStale(map->landmarks);
+    compactAfterChurn(map);
     return true;
 
     FAILURE:
@@ -476,6 +713,9 @@ bool removeRoad(Map *map, const char *cityName1, const char *cityName2) {
     free(replacementParts);
     if (road != NULL && oldYear != 0) {
         road->lastRepaired = oldYear;
+        /* Kopia mogła zostać zbudowana w trakcie szukania, gdy odcinek był zablokowany. */
+        markCityChanged(map->csr, road->end1Id);
+        markCityChanged(map->csr, road->end2Id);
     }
     return false;
 }
@@ -486,7 +726,7 @@ char const *getRouteDescription(Map *map, unsigned routeId) {
     }
 
     Route *route = map->routes[routeId];
-    return generateRouteDescription(route, routeId);
+    return generateRouteDescription(map->memory, route, routeId);
 }
 
 bool removeRoute(Map *map, unsigned routeId) {
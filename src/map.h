@@ -9,6 +9,8 @@
 #ifndef DROGI_MAP_H
 #define DROGI_MAP_H
 
+#include "dict.h"
+
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -36,6 +38,13 @@ typedef struct Map Map;
  */
 typedef enum RoadStatusEnum RoadStatus;
 
+/**
+ * Klucz nazwy miasta, czyli nazwa wraz z jej długością i haszem.
+ * Tworzony przez @ref initCityKey, pozwala nie sprawdzać i nie haszować
+ * tej samej nazwy przy każdej operacji na mapie.
+ */
+typedef DictKey CityKey;
+
 
 /**
  * @brief Tworzy nową strukturę.
@@ -165,6 +174,8 @@ bool extendRoute(Map *map, unsigned routeId, const char *cityName);
  * więcej niż jeden sposób takiego uzupełnienia, to dla każdego wariantu
  * wyznacza wśród dodawanych odcinków drogi ten, który był najdawniej wybudowany
  * lub remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
+ * Miasto, z którego nie wychodzi już żaden odcinek, jest usuwane z mapy,
+ * a jego id może zostać użyte przez nowe miasto.
  * @param[in,out] map    - wskaźnik na strukturę przechowującą mapę dróg;
  * @param[in] cityName1  - wskaźnik na napis reprezentujący nazwę miasta;
  * @param[in] cityName2  - wskaźnik na napis reprezentujący nazwę miasta.
@@ -203,4 +214,158 @@ char const *getRouteDescription(Map *map, unsigned routeId);
  */
 bool removeRoute(Map *map, unsigned routeId);
 
+/**
+ * @brief Zamraża słownik nazw miast.
+ * Przyspiesza wyszukiwanie miast po nazwie i zmniejsza zużycie pamięci słownika,
+ * gdy na mapie nie przybywa już miast. Dodanie nowego miasta
+ * przywraca zwykły słownik, więc mapa działa poprawnie niezależnie od wywołania.
+ * Wywołuje ją też @ref finishBulkLoad.
+ * @param[in,out] map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true, jeśli słownik został zamrożony.
+ * Wartość @p false, jeśli @p map to @p NULL lub nie udało się zaalokować pamięci.
+ */
+bool freezeCityNames(Map *map);
+
+/**
+ * @brief Przenumerowuje miasta mapy zgodnie z połączeniami między nimi.
+ * Sąsiednie miasta dostają bliskie numery, a miasta i odcinki są przenoszone
+ * w pamięci w tej samej kolejności, co przyspiesza szukanie dróg.
+ * Drogi krajowe i nazwy miast pozostają bez zmian. Koszt jest liniowy względem
+ * wielkości mapy, więc mapa nie wywołuje tej funkcji sama, a jedynie przez
+ * @ref finishBulkLoad.
+ * @param[in,out] map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true, jeśli miasta zostały przenumerowane.
+ * Wartość @p false, jeśli @p map to @p NULL lub nie udało się zaalokować pamięci,
+ * wtedy mapa pozostaje bez zmian.
+ */
+bool reorderMap(Map *map);
+
+/**
+ * @brief Kończy wczytywanie serii odcinków.
+ * Należy ją wywołać po serii dodań odcinków, zanim zaczną się szukania dróg.
+ * Jeśli od ostatniego przenumerowania miast przybyło co najmniej dwukrotnie,
+ * to przenumerowuje je przez @ref reorderMap, a jeśli od ostatniego zamrożenia
+ * przybyła co najmniej czwarta część miast, to zamraża słownik nazw przez
+ * @ref freezeCityNames. Koszt obu rozkłada się więc na dodane miasta.
+ * Brak pamięci nie jest błędem, wtedy mapa pozostaje bez zmian.
+ * @param[in,out] map - wskaźnik na strukturę przechowującą mapę dróg.
+ */
+void finishBulkLoad(Map *map);
+
+/**
+ * @brief Wykonuje kolejny krok porządkowania pamięci mapy.
+ * Po wielu usunięciach i dodaniach odcinków dopasowuje tablice odcinków miast
+ * i drogi krajowe do ich zawartości, przenosi miasta i odcinki z rzadko zajętych
+ * bloków pamięci do pozostałych, przepisuje słownik nazw, gdy przeważają w nim nazwy
+ * usuniętych miast, i oddaje zwolnioną pamięć systemowi. Jedno wywołanie
+ * wykonuje ograniczoną część pracy, więc nie wstrzymuje mapy na długo; porządkowanie
+ * kończy się, gdy funkcja zwróci @p true. Mapa wywołuje tę funkcję sama przy usuwaniu
+ * odcinków, jeśli od ostatniego porządkowania usunięto ich dużo.
+ * @param[in,out] map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true, jeśli porządkowanie zostało zakończone lub @p map to @p NULL.
+ * Wartość @p false, jeśli zostały kolejne kroki.
+ */
+bool compactMap(Map *map);
+
+/**
+ * @brief Tworzy klucz nazwy miasta.
+ * Sprawdza poprawność nazwy oraz liczy jej długość i hasz.
+ * Nie kopiuje nazwy, więc klucz jest ważny tak długo, jak napis @p cityName.
+ * @param[in] cityName - wskaźnik na napis reprezentujący nazwę miasta.
+ * @return Klucz nazwy miasta. Jeśli nazwa jest niepoprawna, to pole @p word
+ * klucza ma wartość @p NULL i każda funkcja przyjmująca klucz zakończy się niepowodzeniem.
+ */
+CityKey initCityKey(const char *cityName);
+
+/**
+ * @brief Tworzy klucz nazwy miasta kończącej się zerowym bajtem lub znakiem @p terminator.
+ * Działa jak @ref initCityKey, ale nazwa jest przeglądana tylko raz: w tym samym
+ * przejściu znajdowany jest jej koniec, sprawdzane są znaki i liczony jest hasz.
+ * Pozwala parserowi komend utworzyć klucz w chwili wydzielania parametru.
+ * @param[in] text       - wskaźnik na napis zaczynający się nazwą miasta;
+ * @param[in] terminator - znak kończący nazwę.
+ * @return Klucz nazwy miasta. Pole @p length zawsze jest długością napisu do końca nazwy,
+ * nawet gdy nazwa jest niepoprawna i pole @p word ma wartość @p NULL.
+ */
+CityKey scanCityKey(const char *text, char terminator);
+
+/**
+ * @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
+ * Działa jak @ref addRoad, ale przyjmuje klucze nazw miast.
+ * @param[in,out] map   - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityKey1  - klucz nazwy pierwszego miasta;
+ * @param[in] cityKey2  - klucz nazwy drugiego miasta;
+ * @param[in] length    - długość w km odcinka drogi;
+ * @param[in] builtYear - rok budowy odcinka drogi.
+ * @return Wartość taka sama jak dla @ref addRoad.
+ */
+bool addRoadKeyed(Map *map, CityKey cityKey1, CityKey cityKey2,
+                  unsigned length, int builtYear);
+
+/**
+ * @brief Modyfikuje rok ostatniego remontu odcinka drogi.
+ * Działa jak @ref repairRoad, ale przyjmuje klucze nazw miast.
+ * @param[in,out] map    - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityKey1   - klucz nazwy pierwszego miasta;
+ * @param[in] cityKey2   - klucz nazwy drugiego miasta;
+ * @param[in] repairYear - rok ostatniego remontu odcinka drogi.
+ * @return Wartość taka sama jak dla @ref repairRoad.
+ */
+bool repairRoadKeyed(Map *map, CityKey cityKey1, CityKey cityKey2, int repairYear);
+
+/**
+ * @brief Udostępnia stan drogi.
+ * Działa jak @ref getRoadStatus, ale przyjmuje klucze nazw miast.
+ * @param[in] map        - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityKey1   - klucz nazwy pierwszego miasta;
+ * @param[in] cityKey2   - klucz nazwy drugiego miasta;
+ * @param[in] length     - długość w km odcinka drogi;
+ * @param[in] repairYear - rok budowy/naprawy odcinka drogi.
+ * @return Wartość taka sama jak dla @ref getRoadStatus.
+ */
+RoadStatus getRoadStatusKeyed(Map *map, CityKey cityKey1, CityKey cityKey2,
+                              unsigned length, int repairYear);
+
+/**
+ * @brief Łączy dwa różne miasta drogą krajową.
+ * Działa jak @ref newRoute, ale przyjmuje klucze nazw miast.
+ * @param[in,out] map   - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId   - numer drogi krajowej;
+ * @param[in] cityKey1  - klucz nazwy pierwszego miasta;
+ * @param[in] cityKey2  - klucz nazwy drugiego miasta.
+ * @return Wartość taka sama jak dla @ref newRoute.
+ */
+bool newRouteKeyed(Map *map, unsigned routeId, CityKey cityKey1, CityKey cityKey2);
+
+/**
+ * @brief Tworzy drogę krajową przechodzącą przez konkretne miasta.
+ * Działa jak @ref createRoute, ale przyjmuje klucze nazw miast.
+ * @param[in,out] map  - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId  - numer drogi krajowej;
+ * @param[in] cityKeys - wskaźnik na tablicę kluczy nazw miast;
+ * @param[in] cityCount - liczba miast.
+ * @return Wartość taka sama jak dla @ref createRoute.
+ */
+bool createRouteKeyed(Map *map, unsigned routeId, const CityKey *cityKeys, size_t cityCount);
+
+/**
+ * @brief Wydłuża drogę krajową do podanego miasta.
+ * Działa jak @ref extendRoute, ale przyjmuje klucz nazwy miasta.
+ * @param[in,out] map  - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId  - numer drogi krajowej;
+ * @param[in] cityKey  - klucz nazwy miasta.
+ * @return Wartość taka sama jak dla @ref extendRoute.
+ */
+bool extendRouteKeyed(Map *map, unsigned routeId, CityKey cityKey);
+
+/**
+ * @brief Usuwa odcinek drogi między dwoma różnymi miastami.
+ * Działa jak @ref removeRoad, ale przyjmuje klucze nazw miast.
+ * @param[in,out] map  - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityKey1 - klucz nazwy pierwszego miasta;
+ * @param[in] cityKey2 - klucz nazwy drugiego miasta.
+ * @return Wartość taka sama jak dla @ref removeRoad.
+ */
+bool removeRoadKeyed(Map *map, CityKey cityKey1, CityKey cityKey2);
+
 #endif /* DROGI_MAP_H */
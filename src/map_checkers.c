@@ -18,25 +18,12 @@ const unsigned MAX_ROUTE_ID = 999;
 const size_t MAX_ROUTE_ID_LENGTH = 3;
 
 
-/* Funkcje pomocnicze. */
-
-/**
- * @brief Dla znaku sprawdza czy jest dopuszczalnym znakiem w nazwie.
- * @param[in] a - znak do sprawdzenia.
- * @return @p true lub @p false w zależności czy znak jest dopuszczalny.
- */
-static bool correctChar(char a);
-
-
-/* Implementacja funkcji pomocniczych. */
+/* Funkcje z interfejsu. */
 
-static bool correctChar(char a) {
+bool isCorrectNameChar(char a) {
     return !(0 <= a && a <= 31) && a != ';';
 }
 
-
-/* Funkcje z interfejsu. */
-
 bool checkName(const char *name) {
     if (name == NULL) {
         return false;
@@ -47,13 +34,26 @@ bool checkName(const char *name) {
     }
 
     for (const char *it = name; *it != '\0'; it++) {
-        if (!correctChar(*it)) {
+        if (!isCorrectNameChar(*it)) {
             return false;
         }
     }
     return true;
 }
 
+bool checkCityKey(CityKey cityKey) {
+    return cityKey.word != NULL;
+}
+
+bool equalCityKeys(CityKey cityKey1, CityKey cityKey2) {
+    if (cityKey1.word == NULL || cityKey2.word == NULL) {
+        return cityKey1.word == cityKey2.word;
+    }
+
+    return cityKey1.hash == cityKey2.hash && cityKey1.length == cityKey2.length &&
+           memcmp(cityKey1.word, cityKey2.word, cityKey1.length) == 0;
+}
+
 bool checkRouteId(unsigned routeId) {
     return routeId > 0 && routeId <= MAX_ROUTE_ID;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #ifndef DROGI_MAP_CHECKERS_H
 #define DROGI_MAP_CHECKERS_H
 
+#include "map.h"
+
 #include <stdlib.h>
 #include <stdbool.h>
 
@@ -20,6 +22,13 @@ extern const unsigned MAX_ROUTE_ID;
  */
 extern const size_t MAX_ROUTE_ID_LENGTH;
 
+/**
+ * @brief Dla znaku sprawdza czy jest dopuszczalnym znakiem w nazwie.
+ * @param[in] a - znak do sprawdzenia.
+ * @return @p true lub @p false w zależności czy znak jest dopuszczalny.
+ */
+bool isCorrectNameChar(char a);
+
 /**
  * @brief Sprawdza poprawność nazwy.
  * Sprawdza czy wskaźnik nie jest @p NULL, czy nazwa nie jest pusta
@@ -29,6 +38,24 @@ extern const size_t MAX_ROUTE_ID_LENGTH;
  */
 bool checkName(const char *name);
 
+/**
+ * @brief Sprawdza poprawność klucza nazwy.
+ * Klucz utworzony przez @ref initCityKey jest poprawny wtedy i tylko wtedy,
+ * gdy nazwa była poprawna, więc nazwa nie jest sprawdzana ponownie.
+ * @param[in] cityKey - klucz nazwy miasta.
+ * @return @p true lub @p false w zależności czy klucz jest poprawny.
+ */
+bool checkCityKey(CityKey cityKey);
+
+/**
+ * @brief Sprawdza czy klucze wskazują na tę samą nazwę.
+ * Porównuje najpierw hasze i długości, a napisy tylko gdy te są równe.
+ * @param[in] cityKey1 - klucz pierwszej nazwy;
+ * @param[in] cityKey2 - klucz drugiej nazwy.
+ * @return @p true jeśli nazwy są identyczne, @p false w p.p.
+ */
+bool equalCityKeys(CityKey cityKey1, CityKey cityKey2);
+
 /**
  * @brief Sprawdza poprawność indeksu drogi.
  * To znaczy, że indeks jest dodatni i nie większy niż @ref MAX_ROUTE_ID.
@@ -0,0 +1,202 @@
+/** @file
+ * Implementacja modułu porządkującego pamięć mapy po wielu zmianach odcinków.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include "map_compact.h"
+#include "map_types.h"
+#include "map_checkers.h"
+#include "map_graph.h"
+#include "map_csr.h"
+#include "road_index.h"
+
+#include "vector.h"
+#include "dict.h"
+#include "page_memory.h"
+#include "utility.h"
+
+#include <stdlib.h>
+
+
+/* Stałe. */
+
+/** Liczba id miast, których tablice odcinków są dopasowywane w jednym kroku. */
+static const size_t CITIES_PER_STEP = 4096;
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Poprawia wskaźniki dróg krajowych na przeniesione obiekty opróżnianego bloku.
+ * @param[in,out] map - wskaźnik na mapę;
+ * @param[in] kind    - rodzaj obiektów opróżnianego bloku.
+ */
+static void relocateRoutes(Map *map, GraphObjectKind kind);
+
+/**
+ * @brief Opróżnia jeden rzadko zajęty blok pamięci miast lub odcinków.
+ * Poprawia wszystkie wskaźniki spoza grafu na przeniesione obiekty.
+ * @param[in,out] map - wskaźnik na mapę;
+ * @param[in] kind    - rodzaj obiektów.
+ * @return @p true jeśli blok został zwrócony do systemu, @p false gdy żaden się
+ * nie nadaje lub brak pamięci.
+ */
+static bool evacuateGraphBlock(Map *map, GraphObjectKind kind);
+
+/**
+ * @brief Buduje słownik nazw miast od nowa, bez kopii nazw usuniętych miast.
+ * Nazwy miast wskazują potem na kopie w nowym słowniku.
+ * @param[in,out] map - wskaźnik na mapę.
+ * @return @p true jeśli słownik został zastąpiony, @p false gdy brak pamięci.
+ */
+static bool rebuildCityNames(Map *map);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static void relocateRoutes(Map *map, GraphObjectKind kind) {
+    for (size_t routeId = 0; routeId <= MAX_ROUTE_ID; routeId++) {
+        Route *route = map->routes[routeId];
+        if (route == NULL) {
+            continue;
+        }
+
+        if (kind == GRAPH_CITIES) {
+            route->end1 = relocatedCity(map->memory, route->end1);
+            route->end2 = relocatedCity(map->memory, route->end2);
+            continue;
+        }
+
+        size_t roadCount = sizeOfVector(route->roads);
+        Road **roads = (Road **) storageBlockOfVector(route->roads);
+        for (size_t i = 0; i < roadCount; i++) {
+            roads[i] = relocatedRoad(map->memory, roads[i]);
+        }
+    }
+}
+
+static bool evacuateGraphBlock(Map *map, GraphObjectKind kind) {
+    if (!beginGraphEvacuation(map->memory, kind)) {
+        return false;
+    }
+
+    void *oldObject;
+    void *object;
+    while ((object = evacuateNextObject(map->memory, kind, &oldObject)) != NULL) {
+        if (kind == GRAPH_CITIES) {
+            /* Zmiana wartości istniejącego słowa w słowniku nie alokuje pamięci. */
+            City *city = object;
+            addToDictKeyed(map->cities, initDictKey(nameOfCity(map->memory, city).text), city);
+        } else {
+            /* Kopia grafu trzyma tylko id miast, ale numery odcinków trzeba poprawić. */
+            updateInRoadIndex(map->roadIndex, object);
+            updateRoadInCsr(map->csr, object, numberOfRoad(map->memory, oldObject), numberOfRoad(map->memory, object));
+        }
+    }
+
+    relocateRoutes(map, kind);
+    return finishGraphEvacuation(map->memory, kind);
+}
+
+static bool rebuildCityNames(Map *map) {
+    DictKey *keys = NULL;
+    City **values = NULL;
+    Dict *cities = NULL;
+
+    size_t idBound = map->cityCount;
+    keys = malloc(sizeof(DictKey) * (idBound + 1));
+    values = malloc(sizeof(City *) * (idBound + 1));
+    FAIL_IF(keys == NULL || values == NULL);
+
+    size_t count = 0;
+    size_t cursor = 0;
+    DictEntry entry;
+    while (dictForEach(map->cities, &cursor, &entry)) {
+        keys[count] = initDictKey(entry.word);
+        values[count] = entry.value;
+        count++;
+    }
+    cities = dictBuildFromArray(keys, (void *const *) values, count);
+    FAIL_IF(cities == NULL);
+
+    /* Dalej nic nie jest alokowane. Nazwy miast wskazują odtąd na kopie w nowym słowniku. */
+    cursor = 0;
+    while (dictForEach(cities, &cursor, &entry)) {
+        setNameOfCity(map->memory, entry.value, entry.word, entry.length);
+    }
+    deleteDict(map->cities, NULL);
+    map->cities = cities;
+    /* Nowy słownik nie jest zamrożony. */
+    map->unfrozenCityCount = count;
+
+    free(keys);
+    free(values);
+    return true;
+
+    FAILURE:
+
+    free(keys);
+    free(values);
+    return false;
+}
+
+
+/* Funkcje z interfejsu. */
+
+bool compactMapStep(Map *map) {
+    if (map == NULL) {
+        return true;
+    }
+
+    switch (map->compactionStage) {
+        case COMPACTION_ADJACENCY: {
+            size_t idBound = map->cityCount;
+            size_t end = map->compactionCursor + CITIES_PER_STEP;
+            for (; map->compactionCursor < idBound && map->compactionCursor < end; map->compactionCursor++) {
+                shrinkRoadsOfCity(map->memory, cityOfId(map->memory, map->compactionCursor));
+            }
+            if (map->compactionCursor >= idBound) {
+                map->compactionCursor = 0;
+                map->compactionStage = COMPACTION_ROUTES;
+            }
+            return false;
+        }
+        case COMPACTION_ROUTES:
+            for (size_t routeId = 0; routeId <= MAX_ROUTE_ID; routeId++) {
+                if (map->routes[routeId] != NULL) {
+                    shrinkVector(map->routes[routeId]->roads);
+                }
+            }
+            map->compactionStage = COMPACTION_ROAD_BLOCKS;
+            return false;
+        case COMPACTION_ROAD_BLOCKS:
+            if (!compactRoadBlocks(map->memory)) {
+                map->compactionStage = COMPACTION_CITIES;
+            }
+            return false;
+        case COMPACTION_CITIES:
+            if (!evacuateGraphBlock(map, GRAPH_CITIES)) {
+                map->compactionStage = COMPACTION_ROADS;
+            }
+            return false;
+        case COMPACTION_ROADS:
+            if (!evacuateGraphBlock(map, GRAPH_ROADS)) {
+                map->compactionStage = COMPACTION_NAMES;
+            }
+            return false;
+        case COMPACTION_NAMES:
+            /* Brak pamięci nie jest błędem, wtedy słownik po prostu zostaje. */
+            if (deadWordBytesOfDict(map->cities) > liveWordBytesOfDict(map->cities)) {
+                rebuildCityNames(map);
+            }
+            map->compactionStage = COMPACTION_RELEASE;
+            return false;
+        default:
+            releaseFreeMemory();
+            map->compactionStage = COMPACTION_ADJACENCY;
+            map->removedRoadCount = 0;
+            return true;
+    }
+}
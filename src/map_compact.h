@@ -0,0 +1,36 @@
+/** @file
+ * Interfejs modułu porządkującego pamięć mapy po wielu zmianach odcinków.
+ *
+ * Po wielu usunięciach i dodaniach odcinków bloki pamięci miast i odcinków są
+ * zajęte tylko w części, a tablice odcinków miast i wektory dróg krajowych mają
+ * nadmiarowe miejsce. Porządkowanie dopasowuje tablice do ich zawartości, przenosi
+ * obiekty z rzadko zajętych bloków do pozostałych i zwraca puste bloki do systemu.
+ * Słownik nazw miast jest budowany od nowa, gdy nazwy usuniętych miast zajmują
+ * w nim więcej miejsca niż nazwy istniejących.
+ * Jest wykonywane w krokach o ograniczonym czasie, między którymi mapa może być
+ * normalnie używana.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_MAP_COMPACT_H
+#define DROGI_MAP_COMPACT_H
+
+#include "map_types.h"
+
+#include <stdbool.h>
+
+/**
+ * @brief Wykonuje kolejny krok porządkowania pamięci mapy.
+ * Jeden krok dopasowuje tablice odcinków ograniczonej liczby miast, wszystkie
+ * wektory dróg krajowych, opróżnia jeden blok pamięci albo przepisuje słownik
+ * nazw miast. Wskaźniki na miasta
+ * i odcinki sprzed wywołania mogą przestać być ważne. Gdy zabraknie pamięci,
+ * krok jest pomijany, a mapa pozostaje poprawna.
+ * @param[in,out] map - wskaźnik na mapę.
+ * @return @p true jeśli porządkowanie zostało zakończone, @p false jeśli są jeszcze kroki do wykonania.
+ */
+bool compactMapStep(Map *map);
+
+#endif /* DROGI_MAP_COMPACT_H */
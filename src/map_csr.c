@@ -0,0 +1,260 @@
+/** @file
+ * Implementacja modułu przechowującego zwartą kopię grafu mapy (CSR) do szukania dróg.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include "map_csr.h"
+#include "map_types.h"
+#include "map_graph.h"
+
+#include "dict.h"
+#include "page_memory.h"
+#include "utility.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+/* Stałe. */
+
+/** Najmniejsza liczba zmienionych miast, przy której kopia jest budowana od nowa. */
+static const size_t MIN_REBUILD_CHANGES = 64;
+/**
+ * Kopia jest budowana od nowa, gdy zmienionych miast jest więcej niż
+ * liczba miast podzielona przez tę stałą. Wtedy koszt budowy rozkłada się
+ * na co najmniej tyle zmian, ile jest miast w tej części.
+ */
+static const size_t REBUILD_DIVISOR = 8;
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Usuwa tablice kopii, ale nie samą strukturę.
+ * @param[in,out] graph - wskaźnik na kopię.
+ */
+static void deleteCsrArrays(CsrGraph *graph);
+
+/**
+ * @brief Buduje kopię aktualnego grafu mapy.
+ * @param[out] graph - wskaźnik na kopię, której tablice nie są zaalokowane;
+ * @param[in] map    - wskaźnik na mapę.
+ * @return @p true lub @p false w zależności od powodzenia alokacji,
+ * w razie niepowodzenia tablice kopii nie są zaalokowane.
+ */
+static bool buildCsrArrays(CsrGraph *graph, const Map *map);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static void deleteCsrArrays(CsrGraph *graph) {
+    freeStoragePages(graph->offsets, sizeof(uint32_t) * (graph->cityCount + 1));
+    freeStoragePages(graph->neighbors, sizeof(uint32_t) * (graph->roadCount + 1));
+    freeStoragePages(graph->lengths, sizeof(unsigned) * (graph->roadCount + 1));
+    freeStoragePages(graph->years, sizeof(int) * (graph->roadCount + 1));
+    freeStoragePages(graph->roadNumbers, sizeof(uint32_t) * (graph->roadCount + 1));
+    freeStoragePages(graph->changed, sizeof(bool) * (graph->cityCount + 1));
+    graph->offsets = NULL;
+    graph->neighbors = NULL;
+    graph->lengths = NULL;
+    graph->years = NULL;
+    graph->roadNumbers = NULL;
+    graph->changed = NULL;
+    graph->cityCount = 0;
+    graph->roadCount = 0;
+    graph->changedCount = 0;
+}
+
+static bool buildCsrArrays(CsrGraph *graph, const Map *map) {
+    size_t cityCount = map->cityCount;
+    graph->cityCount = cityCount;
+    graph->roadCount = 0;
+    graph->changedCount = 0;
+    graph->neighbors = NULL;
+    graph->lengths = NULL;
+    graph->years = NULL;
+    graph->roadNumbers = NULL;
+    graph->offsets = allocateStoragePages(sizeof(uint32_t) * (cityCount + 1));
+    graph->changed = allocateStoragePages(sizeof(bool) * (cityCount + 1));
+    FAIL_IF(graph->offsets == NULL || graph->changed == NULL);
+
+    /* Zablokowane odcinki są pomijane, tak jak robi to szukanie w aktualnym grafie. */
+    size_t cursor = 0;
+    DictEntry entry;
+    while (dictForEach(map->cities, &cursor, &entry)) {
+        City *city = entry.value;
+        const uint32_t *roads = roadNumbersOfCity(city);
+        uint32_t degree = 0;
+        for (size_t i = 0; i < city->roadCount; i++) {
+            if (otherRoadEndId(roadOfNumber(map->memory, roads[i]), city->id) != NO_CITY_ID) {
+                degree++;
+            }
+        }
+        graph->offsets[city->id + 1] = degree;
+    }
+
+    /* Indeksy są 32-bitowe, więc większa kopia nie jest budowana. */
+    size_t roadCount = 0;
+    for (size_t id = 0; id < cityCount; id++) {
+        roadCount += graph->offsets[id + 1];
+        FAIL_IF(roadCount > UINT32_MAX);
+        graph->offsets[id + 1] = (uint32_t) roadCount;
+    }
+
+    graph->roadCount = roadCount;
+    graph->neighbors = allocateStoragePages(sizeof(uint32_t) * (roadCount + 1));
+    graph->lengths = allocateStoragePages(sizeof(unsigned) * (roadCount + 1));
+    graph->years = allocateStoragePages(sizeof(int) * (roadCount + 1));
+    graph->roadNumbers = allocateStoragePages(sizeof(uint32_t) * (roadCount + 1));
+    FAIL_IF(graph->neighbors == NULL || graph->lengths == NULL || graph->years == NULL ||
+            graph->roadNumbers == NULL);
+
+    for (size_t id = 0; id < cityCount; id++) {
+        City *city = cityOfId(map->memory, id);
+        if (city == NULL) {
+            continue;
+        }
+
+        /* Odcinki są zapisywane w tej samej kolejności co w mieście. */
+        const uint32_t *roads = roadNumbersOfCity(city);
+        size_t position = graph->offsets[id];
+        for (size_t i = 0; i < city->roadCount; i++) {
+            const Road *road = roadOfNumber(map->memory, roads[i]);
+            uint32_t neighborId = otherRoadEndId(road, city->id);
+            if (neighborId == NO_CITY_ID) {
+                continue;
+            }
+            graph->neighbors[position] = neighborId;
+            graph->lengths[position] = road->length;
+            graph->years[position] = road->lastRepaired;
+            graph->roadNumbers[position] = roads[i];
+            position++;
+        }
+    }
+    return true;
+
+    FAILURE:
+
+    deleteCsrArrays(graph);
+    return false;
+}
+
+
+/* Funkcje z interfejsu. */
+
+CsrGraph *initCsrGraph(void) {
+    CsrGraph *graph = malloc(sizeof(CsrGraph));
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    graph->offsets = NULL;
+    graph->neighbors = NULL;
+    graph->lengths = NULL;
+    graph->years = NULL;
+    graph->roadNumbers = NULL;
+    graph->changed = NULL;
+    graph->cityCount = 0;
+    graph->roadCount = 0;
+    graph->changedCount = 0;
+    return graph;
+}
+
+void deleteCsrGraph(CsrGraph *graph) {
+    if (graph == NULL) {
+        return;
+    }
+
+    deleteCsrArrays(graph);
+    free(graph);
+}
+
+void markCityChanged(CsrGraph *graph, uint32_t cityId) {
+    if (graph == NULL || cityId >= graph->cityCount) {
+        return;
+    }
+
+    if (!graph->changed[cityId]) {
+        graph->changed[cityId] = true;
+        graph->changedCount++;
+    }
+}
+
+bool isCityInCsr(const CsrGraph *graph, uint32_t cityId) {
+    return graph != NULL && cityId < graph->cityCount && !graph->changed[cityId];
+}
+
+void resetCsrGraph(CsrGraph *graph) {
+    if (graph == NULL) {
+        return;
+    }
+
+    deleteCsrArrays(graph);
+}
+
+void updateRoadInCsr(CsrGraph *graph, const Road *road, uint32_t oldNumber, uint32_t number) {
+    if (graph == NULL || road == NULL) {
+        return;
+    }
+
+    uint32_t endIds[2] = {road->end1Id, road->end2Id};
+    for (size_t end = 0; end < 2; end++) {
+        if (endIds[end] >= graph->cityCount) {
+            continue;
+        }
+        for (size_t i = graph->offsets[endIds[end]]; i < graph->offsets[endIds[end] + 1]; i++) {
+            if (graph->roadNumbers[i] == oldNumber) {
+                graph->roadNumbers[i] = number;
+            }
+        }
+    }
+}
+
+size_t csrBlockCount(const CsrGraph *graph) {
+    if (graph == NULL) {
+        return 0;
+    }
+    return (graph->cityCount + CSR_BLOCK_CITIES - 1) / CSR_BLOCK_CITIES;
+}
+
+void prefetchCsrBlock(const CsrGraph *graph, size_t block) {
+    if (graph == NULL || block >= csrBlockCount(graph)) {
+        return;
+    }
+
+    size_t first = block * CSR_BLOCK_CITIES;
+    size_t last = first + CSR_BLOCK_CITIES < graph->cityCount ? first + CSR_BLOCK_CITIES : graph->cityCount;
+    size_t firstRoad = graph->offsets[first];
+    size_t roadCount = graph->offsets[last] - firstRoad;
+    prefetchStoragePages(graph->offsets + first, sizeof(uint32_t) * (last - first + 1));
+    prefetchStoragePages(graph->changed + first, sizeof(bool) * (last - first));
+    prefetchStoragePages(graph->neighbors + firstRoad, sizeof(uint32_t) * roadCount);
+    prefetchStoragePages(graph->lengths + firstRoad, sizeof(unsigned) * roadCount);
+    prefetchStoragePages(graph->years + firstRoad, sizeof(int) * roadCount);
+}
+
+void refreshCsrGraph(CsrGraph *graph, const Map *map) {
+    if (graph == NULL || map == NULL) {
+        return;
+    }
+
+    /* Miasta spoza kopii też są czytane z aktualnego grafu, więc liczą się jako zmienione. */
+    size_t cityCount = map->cityCount;
+    size_t changedCount = graph->changedCount;
+    if (cityCount > graph->cityCount) {
+        changedCount += cityCount - graph->cityCount;
+    }
+    if (changedCount < MIN_REBUILD_CHANGES || changedCount * REBUILD_DIVISOR < cityCount) {
+        return;
+    }
+
+    CsrGraph rebuilt;
+    if (!buildCsrArrays(&rebuilt, map)) {
+        return;
+    }
+
+    deleteCsrArrays(graph);
+    *graph = rebuilt;
+}
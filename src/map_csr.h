@@ -0,0 +1,131 @@
+/** @file
+ * Interfejs modułu przechowującego zwartą kopię grafu mapy (CSR) do szukania dróg.
+ *
+ * Kopia przechowuje dla każdego miasta ciągły fragment tablic z id sąsiadów
+ * i parametrami odcinków, więc przeglądanie sąsiadów nie wymaga chodzenia
+ * po wskaźnikach. Zmiany grafu po zbudowaniu kopii są zapisywane jako zbiór
+ * zmienionych miast (nakładka), dla których szukanie korzysta z aktualnego grafu.
+ * Gdy zmienionych miast jest dużo, kopia jest budowana od nowa.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_MAP_CSR_H
+#define DROGI_MAP_CSR_H
+
+#include "map_types.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Liczba kolejnych id miast w jednym bloku kopii, wczytywanym z wyprzedzeniem,
+ * gdy kopia jest trzymana w pliku. Po przenumerowaniu miast sąsiednie miasta
+ * mają bliskie id, więc blok obejmuje zwarty fragment mapy.
+ */
+#define CSR_BLOCK_CITIES 4096
+
+/**
+ * Przechowuje zwartą kopię grafu wraz z nakładką zmienionych miast.
+ * Parametry odcinków są w osobnych, równoległych tablicach, żeby szukanie
+ * mogło przetwarzać kilka kolejnych odcinków naraz.
+ */
+struct CsrGraphStruct {
+    /** Ograniczenie id miast w kopii, miasta o większych id są traktowane jako zmienione. */
+    size_t cityCount;
+    /**
+     * Tablica @p cityCount + 1 indeksów, odcinki miasta o id @p i
+     * zajmują miejsca od @p offsets[i] do @p offsets[i + 1] - 1.
+     * Kopia jest budowana tylko wtedy, gdy wszystkie indeksy mieszczą się na 32 bitach.
+     */
+    uint32_t *offsets;
+    /** Liczba odcinków w kopii, czyli długość tablic kolejnych odcinków bez jednego zapasowego miejsca. */
+    size_t roadCount;
+    /** Id drugich końców kolejnych odcinków. */
+    uint32_t *neighbors;
+    /** Długości kolejnych odcinków. */
+    unsigned *lengths;
+    /** Lata ostatniego remontu lub budowy kolejnych odcinków. */
+    int *years;
+    /** Numery kolejnych odcinków (@ref roadOfNumber), potrzebne do odtworzenia znalezionej drogi. */
+    uint32_t *roadNumbers;
+    /** Tablica znaczników, czy miasto zmieniło się od zbudowania kopii. */
+    bool *changed;
+    /** Liczba zaznaczonych miast. */
+    size_t changedCount;
+};
+
+/**
+ * @brief Tworzy pustą kopię grafu, w której wszystkie miasta są traktowane jako zmienione.
+ * @return Wskaźnik na kopię lub @p NULL gdy brak pamięci.
+ */
+CsrGraph *initCsrGraph(void);
+
+/**
+ * @brief Usuwa kopię grafu.
+ * Nie usuwa miast ani odcinków. Jeśli kopia to @p NULL nic nie robi.
+ * @param[in,out] graph - wskaźnik na kopię.
+ */
+void deleteCsrGraph(CsrGraph *graph);
+
+/**
+ * @brief Zaznacza, że zmieniły się odcinki wychodzące z miasta.
+ * Musi być wywołana po każdym dodaniu, usunięciu, zablokowaniu lub zmianie
+ * roku remontu odcinka, dla obu jego końców.
+ * @param[in,out] graph - wskaźnik na kopię lub @p NULL;
+ * @param[in] cityId    - id miasta.
+ */
+void markCityChanged(CsrGraph *graph, uint32_t cityId);
+
+/**
+ * @brief Sprawdza czy odcinki miasta można czytać z kopii.
+ * @param[in] graph  - wskaźnik na kopię lub @p NULL;
+ * @param[in] cityId - id miasta.
+ * @return @p true jeśli miasto jest w kopii i się nie zmieniło, @p false w p.p.
+ */
+bool isCityInCsr(const CsrGraph *graph, uint32_t cityId);
+
+/**
+ * @brief Porzuca kopię, po czym wszystkie miasta są traktowane jako zmienione.
+ * Używana, gdy zmienia się numeracja miast. Kopia zostanie zbudowana od nowa
+ * przy najbliższym wywołaniu @ref refreshCsrGraph.
+ * @param[in,out] graph - wskaźnik na kopię lub @p NULL.
+ */
+void resetCsrGraph(CsrGraph *graph);
+
+/**
+ * @brief Zapisuje w kopii nowy numer przeniesionego odcinka.
+ * Przegląda tylko odcinki obu końców w kopii, więc kopia nie musi być budowana od nowa.
+ * @param[in,out] graph - wskaźnik na kopię lub @p NULL;
+ * @param[in] road      - wskaźnik na odcinek w nowym miejscu;
+ * @param[in] oldNumber - stary numer odcinka;
+ * @param[in] number    - nowy numer odcinka.
+ */
+void updateRoadInCsr(CsrGraph *graph, const Road *road, uint32_t oldNumber, uint32_t number);
+
+/**
+ * @brief Wyznacza liczbę bloków kopii.
+ * @param[in] graph - wskaźnik na kopię lub @p NULL.
+ * @return Liczba bloków po @ref CSR_BLOCK_CITIES id miast.
+ */
+size_t csrBlockCount(const CsrGraph *graph);
+
+/**
+ * @brief Zleca wczytanie z wyprzedzeniem fragmentów tablic kopii dla bloku miast.
+ * Ma znaczenie tylko wtedy, gdy kopia jest trzymana w pliku, w p.p. nic nie robi.
+ * @param[in] graph - wskaźnik na kopię lub @p NULL;
+ * @param[in] block - numer bloku, mniejszy od @ref csrBlockCount.
+ */
+void prefetchCsrBlock(const CsrGraph *graph, size_t block);
+
+/**
+ * @brief Buduje kopię od nowa, jeśli nakładka jest zbyt duża.
+ * Jeśli zabraknie pamięci, to kopia zostaje bez zmian, dalej jest poprawna,
+ * tylko szukanie korzysta z niej w mniejszym stopniu.
+ * @param[in,out] graph - wskaźnik na kopię lub @p NULL;
+ * @param[in] map       - wskaźnik na mapę.
+ */
+void refreshCsrGraph(CsrGraph *graph, const Map *map);
+
+#endif /* DROGI_MAP_CSR_H */
@@ -8,23 +8,168 @@
 #include "map_find_route.h"
 #include "map_types.h"
 #include "map_graph.h"
+#include "map_csr.h"
+#include "map_landmarks.h"
 
 #include "heap.h"
+#include "page_memory.h"
 #include "utility.h"
 
 #include <inttypes.h>
 #include <limits.h>
+#include <string.h>
 
 
-/** Struktura dane potrzebne do wykorzystanie kopca w wyszukiwaniu najkrótszej drogi. */
-typedef struct RouteSearchHeapEntryStruct RouteSearchHeapEntry;
+/** Struktura przechowująca dystans w zwartej postaci. */
+typedef struct PackedDistanceStruct PackedDistance;
 
-/** Zawiera dane potrzebne do wykorzystania kopca w algorytmie Dijkstry. */
-struct RouteSearchHeapEntryStruct {
-    /** Łączny dystans drogi. */
-    Distance distance;
-    /** Miasto końcowe. */
-    City *city;
+/**
+ * Przechowuje dystans w 12 bajtach zamiast 16, bez dopełnienia do wyrównania
+ * 64-bitowej długości. Tak są zapisane dystanse w tablicy według id miast.
+ */
+struct PackedDistanceStruct {
+    /** Młodsze 32 bity łącznej długości. */
+    uint32_t lengthLow;
+    /** Starsze 32 bity łącznej długości. */
+    uint32_t lengthHigh;
+    /** Data najstarszej naprawy. */
+    int lastRepaired;
+};
+
+/** Struktura przechowująca dystans miasta w pamięci roboczej szukania. */
+typedef struct SearchSlotStruct SearchSlot;
+
+/**
+ * Przechowuje dystans miasta razem z numerem szukania, w którym został ustalony.
+ * Razem zajmują 16 bajtów, więc sprawdzenie ważności nie wymaga dodatkowego odczytu pamięci.
+ */
+struct SearchSlotStruct {
+    /** Dystans. */
+    PackedDistance distance;
+    /** Numer szukania, w którym dystans został ustalony. */
+    uint32_t stamp;
+};
+
+/**
+ * Typ wyliczeniowy określający kierunek szukania.
+ */
+enum SearchDirectionEnum {
+    /** Szukanie od drugiego miasta, jedyne w szukaniu jednokierunkowym. */
+            SEARCH_FORWARD,
+    /** Szukanie od pierwszego miasta, tylko w szukaniu dwukierunkowym. */
+            SEARCH_BACKWARD,
+    /** Liczba kierunków. */
+            SEARCH_DIRECTION_COUNT
+};
+
+/**
+ * Typ określający kierunek szukania.
+ */
+typedef enum SearchDirectionEnum SearchDirection;
+
+/** Struktura przechowująca kolejkę miast do rozpatrzenia. */
+typedef struct SearchQueueStruct SearchQueue;
+
+/**
+ * Przechowuje kolejkę miast do rozpatrzenia w algorytmie Dijkstry.
+ * Dokładnie jeden z kopców jest utworzony, zależnie od wybranego rodzaju kolejki.
+ */
+struct SearchQueueStruct {
+    /** Kopiec indeksowany lub @p NULL. */
+    IndexedHeap *heap;
+    /** Kopiec pozycyjny lub @p NULL. */
+    RadixHeap *radixHeap;
+};
+
+/**
+ * Przechowuje pamięć roboczą szukania dróg.
+ * Dystans miasta jest ważny tylko gdy jego znacznik jest równy numerowi bieżącego
+ * szukania, więc rozpoczęcie kolejnego szukania nie wymaga czyszczenia tablic,
+ * a szukanie dotyka tylko odwiedzanych miast.
+ */
+struct SearchWorkspaceStruct {
+    /** Liczba miast, na które są przydzielone tablice. */
+    size_t capacity;
+    /** Dystanse ze znacznikami według kierunków i id miast, @p NULL dla jeszcze nieużytych kierunków. */
+    SearchSlot *slots[SEARCH_DIRECTION_COUNT];
+    /** Numery szukań, w których miasta były zablokowane, według id miast. */
+    uint32_t *blockedStamps;
+    /** Liczba bloków kopii grafu, na które jest przydzielona tablica znaczników wczytania. */
+    size_t prefetchCapacity;
+    /** Numery szukań, które zleciły wczytanie bloków kopii trzymanej w pliku, według numerów bloków. */
+    uint32_t *prefetchStamps;
+    /** Numer bieżącego szukania, nigdy @p 0. */
+    uint32_t epoch;
+    /** Kolejki miast według kierunków, opróżniane na początku każdego szukania. */
+    SearchQueue queues[SEARCH_DIRECTION_COUNT];
+    /** Odcinki, przez które szukanie dwukierunkowe znalazło drogę o najlepszym dotąd dystansie. */
+    Vector *meetingRoads;
+};
+
+/** Struktura przechowująca odcinek widziany przez szukanie drogi. */
+typedef struct SearchEdgeStruct SearchEdge;
+
+/** Zawiera parametry odcinka, niezależnie od tego czy pochodzą z kopii grafu czy z samego odcinka. */
+struct SearchEdgeStruct {
+    /** Id drugiego końca odcinka. */
+    uint32_t cityId;
+    /** Długość odcinka. */
+    unsigned length;
+    /** Rok ostatniego remontu lub budowy odcinka. */
+    int lastRepaired;
+    /** Numer odcinka (@ref roadOfNumber). */
+    uint32_t roadNumber;
+};
+
+/** Struktura przechowująca stan jednego szukania drogi. */
+typedef struct RouteSearchStruct RouteSearch;
+
+/** Zawiera dane wspólne dla funkcji wykonujących jedno szukanie drogi. */
+struct RouteSearchStruct {
+    /** Kopia grafu. */
+    const CsrGraph *graph;
+    /** Pamięć grafu. */
+    const GraphMemory *memory;
+    /** Pamięć robocza szukania. */
+    SearchWorkspace *workspace;
+    /** Czy kopia jest w pliku i jej bloki trzeba wczytywać z wyprzedzeniem. */
+    bool prefetching;
+    /** Id pierwszego miasta, do którego prowadzi szukanie jednokierunkowe. */
+    uint32_t city1Id;
+    /** Id drugiego miasta, od którego zaczyna się szukanie jednokierunkowe. */
+    uint32_t city2Id;
+    /** Najlepszy dystans drogi przez odcinek łączący oba kierunki szukania. */
+    Distance meetingDistance;
+    /** Id końca odcinka spotkania od strony drugiego miasta. */
+    uint32_t meetingForwardId;
+    /** Odcinek spotkania widziany od końca od strony drugiego miasta. */
+    SearchEdge meetingEdge;
+    /** Odległości od punktów orientacyjnych lub @p NULL, gdy szukanie nie jest kierowane. */
+    const Landmarks *landmarks;
+    /** Odległości pierwszego miasta od punktów orientacyjnych. */
+    const uint64_t *targetDistances;
+};
+
+/** Struktura przechowująca stan przeglądania odcinków wychodzących z miasta. */
+typedef struct EdgeCursorStruct EdgeCursor;
+
+/**
+ * Pozwala przeglądać odcinki miasta z kopii grafu, jeśli miasto się w niej nie zmieniło,
+ * a w p.p. z aktualnej listy odcinków miasta.
+ */
+struct EdgeCursorStruct {
+    /** Kopia grafu, z której są czytane odcinki, lub @p NULL gdy są czytane z miasta. */
+    const CsrGraph *graph;
+    /** Id miasta, którego odcinki są przeglądane. */
+    uint32_t cityId;
+    /** Pamięć grafu, z której pochodzą odcinki miasta. */
+    const GraphMemory *memory;
+    /** Tablica numerów odcinków miasta, gdy nie są czytane z kopii. */
+    const uint32_t *roads;
+    /** Numer następnego odcinka. */
+    size_t position;
+    /** Numer za ostatnim odcinkiem. */
+    size_t end;
 };
 
 
@@ -34,41 +179,318 @@ struct RouteSearchHeapEntryStruct {
 static const Distance WORST_DISTANCE = {UINT64_MAX - UINT_MAX, INT_MIN};
 /** Stała oznaczająca dystans punktu do siebie samego. */
 static const Distance BASE_DISTANCE = {0, INT_MAX};
+/**
+ * Liczba odcinków przetwarzanych naraz przy relaksacji odcinków z kopii grafu.
+ * Osiem 64-bitowych długości zajmuje jedną linię pamięci podręcznej.
+ */
+#define RELAX_BLOCK_SIZE 8
+
+
+/* Zmienne globalne. */
+
+/** Rodzaj kolejki używanej przez szukanie drogi. */
+static SearchQueueKind searchQueueKind = SEARCH_QUEUE_RADIX;
+/** Sposób szukania drogi. */
+static SearchEngine searchEngine = SEARCH_ENGINE_BIDIRECTIONAL;
 
 
 /* Funkcje pomocnicze. */
 
 /**
- * @brief Tworzy nowy wpis do kopca.
- * Tworzy nowy wpis do kopca używanego w algorytmie Dijkstry.
- * Te wpisy można potem wrzucać na kopiec i zdejmować wpis z najmniejszym dystansem.
- * Wpisy te można usuwać zwykłem @p free.
- * @param[in] distance - dystans dla danego wpisu;
- * @param[in] city     - miasto do którego można dojść.
- * @return Wskaźnik na nowy wpis lub @p NULL jeśli zabrakło pamięci.
+ * @brief Zapisuje dystans w zwartej postaci.
+ * @param[in] distance - dystans.
+ * @return Zwarty dystans.
+ */
+static inline PackedDistance packDistance(Distance distance);
+
+/**
+ * @brief Odczytuje dystans zapisany w zwartej postaci.
+ * @param[in] packed - zwarty dystans.
+ * @return Dystans.
+ */
+static inline Distance unpackDistance(PackedDistance packed);
+
+/**
+ * @brief Zamienia dystans na klucz kopca indeksowanego.
+ * Klucze są w tym samym porządku co dystanse (@ref compareDistances),
+ * czyli późniejszy rok daje mniejszą drugą część klucza.
+ * @param[in] distance - dystans.
+ * @return Klucz.
+ */
+static inline HeapKey heapKeyOfDistance(Distance distance);
+
+/**
+ * @brief Tworzy pustą kolejkę wybranego rodzaju.
+ * @param[out] queue    - wskaźnik na kolejkę;
+ * @param[in] cityCount - liczba możliwych id miast.
+ * @return @p true lub @p false gdy zabrakło pamięci.
+ */
+static bool initSearchQueue(SearchQueue *queue, size_t cityCount);
+
+/**
+ * @brief Usuwa kopiec kolejki.
+ * @param[in,out] queue - wskaźnik na kolejkę.
+ */
+static void deleteSearchQueue(SearchQueue *queue);
+
+/**
+ * Sprawdza czy kolejka jest pusta.
+ * @param[in] queue - wskaźnik na kolejkę.
+ * @return @p true lub @p false w zależności od stanu kolejki.
+ */
+static inline bool isEmptySearchQueue(const SearchQueue *queue);
+
+/**
+ * @brief Opróżnia kolejkę.
+ * @param[in,out] queue - wskaźnik na kolejkę.
+ */
+static void clearSearchQueue(SearchQueue *queue);
+
+/**
+ * @brief Dodaje miasto do kolejki lub poprawia jego dystans.
+ * @param[in,out] queue - wskaźnik na kolejkę;
+ * @param[in] cityId    - id miasta;
+ * @param[in] distance  - dystans do miasta, nie mniejszy od ostatnio zdjętego.
+ */
+static inline void pushToSearchQueue(SearchQueue *queue, uint32_t cityId, Distance distance);
+
+/**
+ * @brief Zdejmuje z kolejki miasto o najlepszym dystansie.
+ * @param[in,out] queue - wskaźnik na niepustą kolejkę.
+ * @return Id miasta.
+ */
+static inline uint32_t popFromSearchQueue(SearchQueue *queue);
+
+/**
+ * @brief Odczytuje długość najlepszego dystansu w kolejce.
+ * @param[in,out] queue - wskaźnik na niepustą kolejkę.
+ * @return Długość.
+ */
+static inline uint64_t minimumLengthInSearchQueue(SearchQueue *queue);
+
+/**
+ * @brief Przygotowuje pamięć roboczą do nowego szukania.
+ * W razie potrzeby powiększa tablice do podanej liczby miast i tworzy tablice oraz kolejki
+ * wybranego rodzaju dla używanych kierunków, opróżnia kolejki oraz zaczyna nowy
+ * numer szukania, przez co wszystkie dystanse stają się nieważne.
+ * @param[in,out] workspace  - wskaźnik na pamięć roboczą;
+ * @param[in] cityCount      - liczba możliwych id miast;
+ * @param[in] directionCount - liczba używanych kierunków.
+ * @return @p true lub @p false gdy zabrakło pamięci.
+ */
+static bool prepareSearchWorkspace(SearchWorkspace *workspace, size_t cityCount, size_t directionCount);
+
+/**
+ * @brief Zwalnia tablice i kolejki pamięci roboczej.
+ * @param[in,out] workspace - wskaźnik na pamięć roboczą.
+ */
+static void freeSearchWorkspaceArrays(SearchWorkspace *workspace);
+
+/**
+ * @brief Zapewnia miejsce na znaczniki wczytania bloków kopii grafu.
+ * Nowa tablica jest wyzerowana, więc żaden jej znacznik nie jest aktualny.
+ * @param[in,out] workspace - wskaźnik na pamięć roboczą;
+ * @param[in] blockCount    - liczba bloków kopii.
+ * @return @p true lub @p false gdy zabrakło pamięci.
+ */
+static bool reservePrefetchStamps(SearchWorkspace *workspace, size_t blockCount);
+
+/**
+ * @brief Odczytuje dystans miasta w bieżącym szukaniu.
+ * @param[in] workspace - wskaźnik na pamięć roboczą;
+ * @param[in] direction - kierunek szukania;
+ * @param[in] cityId    - id miasta.
+ * @return Dystans lub @ref WORST_DISTANCE, jeśli miasto nie zostało jeszcze osiągnięte.
+ */
+static inline Distance searchDistanceOf(const SearchWorkspace *workspace, SearchDirection direction, uint32_t cityId);
+
+/**
+ * @brief Ustawia dystans miasta w bieżącym szukaniu.
+ * @param[in,out] workspace - wskaźnik na pamięć roboczą;
+ * @param[in] direction     - kierunek szukania;
+ * @param[in] cityId        - id miasta;
+ * @param[in] distance      - dystans.
+ */
+static inline void setSearchDistance(SearchWorkspace *workspace, SearchDirection direction, uint32_t cityId,
+                                     Distance distance);
+
+/**
+ * @brief Odczytuje dystans miasta, przez które może przejść droga.
+ * @param[in] workspace - wskaźnik na pamięć roboczą;
+ * @param[in] direction - kierunek szukania;
+ * @param[in] cityId    - id miasta.
+ * @return Dystans lub @ref WORST_DISTANCE, jeśli miasto nie zostało osiągnięte lub jest zablokowane.
+ */
+static inline Distance reachedDistanceOf(const SearchWorkspace *workspace, SearchDirection direction,
+                                         uint32_t cityId);
+
+/**
+ * @brief Blokuje miasta na użytych odcinkach we wszystkich używanych kierunkach.
+ * Zablokowane miasta dostają dystans, którego nie da się poprawić, więc nie trafiają do kolejek.
+ * Miasta końcowe nie są blokowane i nie mają jeszcze dystansu.
+ * @param[in,out] search     - stan szukania;
+ * @param[in] usedRoads      - wektor użytych odcinków lub @p NULL;
+ * @param[in] directionCount - liczba używanych kierunków.
+ */
+static void blockUsedCities(RouteSearch *search, const Vector *usedRoads, size_t directionCount);
+
+/**
+ * @brief Zleca wczytanie bloku kopii z miastem, gdy kopia jest w pliku i szukanie dotarło do bloku pierwszy raz.
+ * @param[in,out] search - stan szukania;
+ * @param[in] cityId     - id miasta.
+ */
+static inline void prefetchCityBlock(RouteSearch *search, uint32_t cityId);
+
+/**
+ * @brief Rozpoczyna przeglądanie odcinków wychodzących z miasta.
+ * @param[in] graph  - kopia grafu lub @p NULL;
+ * @param[in] memory - pamięć grafu, w której jest miasto;
+ * @param[in] cityId - id miasta.
+ * @return Stan przeglądania ustawiony przed pierwszym odcinkiem.
+ */
+static EdgeCursor initEdgeCursor(const CsrGraph *graph, const GraphMemory *memory, uint32_t cityId);
+
+/**
+ * @brief Udostępnia kolejny odcinek wychodzący z miasta.
+ * Pomija odcinki zablokowane.
+ * @param[in,out] cursor - stan przeglądania;
+ * @param[out] edge      - miejsce na parametry odcinka.
+ * @return @p true jeśli odcinek został udostępniony, @p false jeśli nie ma już odcinków.
+ */
+static inline bool nextSearchEdge(EdgeCursor *cursor, SearchEdge *edge);
+
+/**
+ * @brief Relaksuje odcinki miasta zapisane w kopii grafu.
+ * Przetwarza odcinki blokami po @ref RELAX_BLOCK_SIZE. Najpierw, bez rozgałęzień,
+ * liczy dla całego bloku dystanse kandydatów i maskę sąsiadów, dla których
+ * dystans jest lepszy, porównując leksykograficznie (długość, -rok), więc odczyty
+ * pól sąsiadów z bloku nie czekają na siebie nawzajem. Ta pętla nie jest wektoryzowana,
+ * bo pola sąsiadów są czytane spod dowolnych indeksów. Potem dla zaznaczonych sąsiadów,
+ * w kolejności odcinków, zapisuje dystans i dodaje sąsiada do kolejki lub poprawia jego dystans.
+ * @param[in] graph         - kopia grafu;
+ * @param[in] cityId        - id miasta, które jest w kopii i się nie zmieniło;
+ * @param[in] distance      - dystans do miasta;
+ * @param[in,out] workspace - pamięć robocza szukania.
  */
-static RouteSearchHeapEntry *initHeapEntry(Distance distance, City *city);
+static void relaxCsrEdges(const CsrGraph *graph, uint32_t cityId, Distance distance, SearchWorkspace *workspace);
 
 /**
- * @brief Komparator wpisów (@ref RouteSearchHeapEntry) do użycia w kopcu.
- * @param[in] heapEntry1Void - pierwszy wpis;
- * @param[in] heapEntry2Void - drugi wpis.
- * @return @p -1, @p 0 lub @p 1 w zależności od stosunku wpisów.
+ * @brief Szuka algorytmem Dijkstry od drugiego miasta, aż dojdzie do pierwszego.
+ * @param[in,out] search - stan szukania.
  */
-static int compareRouteSearchHeapEntries(void *heapEntry1Void, void *heapEntry2Void);
+static void searchOneWay(RouteSearch *search);
+
+/**
+ * @brief Odtwarza drogę po szukaniu jednokierunkowym.
+ * Idąc od pierwszego miasta sprawdza, skąd mógł zostać uzyskany dystans i na ile sposobów.
+ * @param[in] search - stan szukania;
+ * @param[out] route - pusty wektor na odcinki drogi, od pierwszego miasta.
+ * @return Liczba dróg, jak w @ref RouteSearchAnswer.count.
+ */
+static int traceRouteOneWay(const RouteSearch *search, Vector *route);
+
+/**
+ * @brief Wyznacza dolne ograniczenie długości drogi od miasta do pierwszego miasta.
+ * Jest to największa różnica odległości obu miast od tego samego punktu orientacyjnego.
+ * Jeśli z któregoś punktu da się dojść tylko do jednego z miast, to leżą one
+ * w różnych spójnych składowych.
+ * @param[in] search - stan szukania;
+ * @param[in] cityId - id miasta.
+ * @return Ograniczenie, @p 0 gdy szukanie nie jest kierowane
+ * lub @ref NO_LANDMARK_DISTANCE gdy z miasta nie da się dojść do pierwszego miasta.
+ */
+static inline uint64_t landmarkBoundOf(const RouteSearch *search, uint32_t cityId);
+
+/**
+ * @brief Szuka algorytmem A* od drugiego miasta do pierwszego.
+ * Kluczem miasta w kolejce jest dystans z długością powiększoną o ograniczenie
+ * z @ref landmarkBoundOf, a rok zostaje bez zmian, więc remisy długości są rozstrzygane
+ * tak jak w @ref compareDistances. Ograniczenia są spójne, więc klucze zdejmowane
+ * z kolejki nie maleją. Szukanie kończy się dopiero, gdy najmniejsza długość w kolejce przekracza
+ * długość drogi do pierwszego miasta, bo wtedy wszystkie miasta na najlepszych drogach
+ * mają już dokładne dystanse, tak jak potrzebuje @ref traceRouteOneWay.
+ * @param[in,out] search - stan szukania.
+ * @return Liczba miast zdjętych z kolejki.
+ */
+static size_t searchWithLandmarks(RouteSearch *search);
+
+/**
+ * @brief Zapamiętuje drogę przez odcinek łączący oba kierunki szukania.
+ * Jeśli dystans jest lepszy od najlepszego dotąd, zastępuje zapamiętane spotkanie,
+ * a jeśli jest równy, to tylko dopisuje odcinek do odcinków spotkania.
+ * @param[in,out] search - stan szukania;
+ * @param[in] distance   - dystans całej drogi;
+ * @param[in] forwardId  - id końca odcinka od strony drugiego miasta;
+ * @param[in] edge       - odcinek widziany od tego końca.
+ * @return @p true lub @p false gdy zabrakło pamięci.
+ */
+static bool recordMeeting(RouteSearch *search, Distance distance, uint32_t forwardId, const SearchEdge *edge);
+
+/**
+ * @brief Przegląda odcinki miasta zdjętego z kolejki w szukaniu dwukierunkowym.
+ * Poprawia dystanse sąsiadów w kierunku miasta, a dla sąsiadów osiągniętych
+ * w drugim kierunku zapamiętuje drogę przez odcinek.
+ * @param[in,out] search - stan szukania;
+ * @param[in] direction  - kierunek szukania;
+ * @param[in] cityId     - id miasta;
+ * @param[in] distance   - dystans do miasta.
+ * @return @p true lub @p false gdy zabrakło pamięci.
+ */
+static bool scanEdgesBothWays(RouteSearch *search, SearchDirection direction, uint32_t cityId, Distance distance);
+
+/**
+ * @brief Szuka algorytmem Dijkstry jednocześnie od obu miast.
+ * Za każdym razem rozwija kierunek z krótszym dystansem na początku kolejki.
+ * Kończy, gdy suma długości na początkach kolejek przekracza długość najlepszej
+ * znalezionej drogi. Wtedy każde miasto na każdej najlepszej drodze jest rozpatrzone
+ * w którymś kierunku, więc każda najlepsza droga ma odcinek, którego końce zostały
+ * rozpatrzone w przeciwnych kierunkach, i jest on wśród odcinków spotkania.
+ * Nierówność jest ostra, bo przy równych długościach lepsza mogłaby być data naprawy.
+ * @param[in,out] search - stan szukania.
+ * @return @p true lub @p false gdy zabrakło pamięci.
+ */
+static bool searchBothWays(RouteSearch *search);
+
+/**
+ * @brief Szuka sąsiada miasta, przez którego prowadzi droga o danym dystansie.
+ * Sąsiad pasuje, gdy jego dystans w danym kierunku razem z odcinkiem do miasta
+ * i z dystansem pozostałej części drogi daje dystans całej drogi.
+ * @param[in] search    - stan szukania;
+ * @param[in] direction - kierunek, w którym są czytane dystanse sąsiadów;
+ * @param[in] cityId    - id miasta;
+ * @param[in] rest      - dystans części drogi od miasta do końca przeciwnego kierunkowi;
+ * @param[in] total     - dystans całej drogi;
+ * @param[in] skippedId - id sąsiada do pominięcia lub @ref NO_CITY_ID;
+ * @param[out] edge     - miejsce na odcinek do znalezionego sąsiada.
+ * @return Id pierwszego pasującego sąsiada lub @ref NO_CITY_ID, gdy takiego nie ma.
+ */
+static uint32_t findMatchingNeighbor(const RouteSearch *search, SearchDirection direction, uint32_t cityId,
+                                     Distance rest, Distance total, uint32_t skippedId, SearchEdge *edge);
+
+/**
+ * @brief Odtwarza drogę po szukaniu dwukierunkowym i sprawdza czy jest jedyna.
+ * Droga jest składana od odcinka spotkania w obie strony. Potem w każdym mieście drogi
+ * sprawdzane jest, czy inny sąsiad daje ten sam dystans, z dystansami z obu kierunków.
+ * Każda inna najlepsza droga albo odchodzi od znalezionej w mieście rozpatrzonym
+ * w odpowiednim kierunku, albo ma odcinek spotkania poza znalezioną drogą.
+ * @param[in] search - stan szukania;
+ * @param[out] route - pusty wektor na odcinki drogi, od pierwszego miasta.
+ * @return Liczba dróg, jak w @ref RouteSearchAnswer.count.
+ */
+static int traceRouteBothWays(const RouteSearch *search, Vector *route);
 
 /**
  * @brief Dodaje drogę do dystansu.
  * Do odległości dodaje długość odcinka oraz bierze minimum z roku naprawy odcinka i roku naprawy w dystansie.
  * @param[in] distance - dystans;
- * @param[in] road     - odcinek drogowy.
+ * @param[in] edge     - odcinek drogowy.
  * @return Sumaryczny dystans.
  */
-static Distance addRoadToDistance(Distance distance, Road *road);
+static Distance addEdgeToDistance(Distance distance, const SearchEdge *edge);
 
 /**
  * @brief Dodaje dwa dystanse.
- * Działa tak samo jak @ref addRoadToDistance, ale dodaje dystans a nie odcinek.
+ * Działa tak samo jak @ref addEdgeToDistance, ale dodaje dystans a nie odcinek.
  * @param[in] distance1 - pierwszy dystans;
  * @param[in] distance2 - drugi dystans.
  * @return Sumaryczny dystans.
@@ -78,228 +500,840 @@ static Distance combineDistances(Distance distance1, Distance distance2);
 
 /* Implementacja funkcji pomocniczych. */
 
-static RouteSearchHeapEntry *initHeapEntry(Distance distance, City *city) {
-    RouteSearchHeapEntry *entry = malloc(sizeof(RouteSearchHeapEntry));
-    if (entry == NULL) {
-        return NULL;
+static inline PackedDistance packDistance(Distance distance) {
+    PackedDistance packed;
+    packed.lengthLow = (uint32_t) distance.length;
+    packed.lengthHigh = (uint32_t) (distance.length >> 32);
+    packed.lastRepaired = distance.lastRepaired;
+    return packed;
+}
+
+static inline Distance unpackDistance(PackedDistance packed) {
+    Distance distance;
+    distance.length = ((uint64_t) packed.lengthHigh << 32) | packed.lengthLow;
+    distance.lastRepaired = packed.lastRepaired;
+    return distance;
+}
+
+static inline HeapKey heapKeyOfDistance(Distance distance) {
+    HeapKey key;
+    key.primary = distance.length;
+    key.secondary = (uint32_t) ((int64_t) INT_MAX - distance.lastRepaired);
+    return key;
+}
+
+static bool initSearchQueue(SearchQueue *queue, size_t cityCount) {
+    queue->heap = NULL;
+    queue->radixHeap = NULL;
+    if (searchQueueKind == SEARCH_QUEUE_RADIX) {
+        queue->radixHeap = initRadixHeap(cityCount);
+        return queue->radixHeap != NULL;
     }
+    queue->heap = initIndexedHeap(cityCount);
+    return queue->heap != NULL;
+}
 
-    entry->distance = distance;
-    entry->city = city;
-    return entry;
+static void deleteSearchQueue(SearchQueue *queue) {
+    deleteIndexedHeap(queue->heap);
+    deleteRadixHeap(queue->radixHeap);
+    queue->heap = NULL;
+    queue->radixHeap = NULL;
 }
 
-static int compareRouteSearchHeapEntries(void *heapEntry1Void, void *heapEntry2Void) {
-    RouteSearchHeapEntry *entry1 = heapEntry1Void;
-    RouteSearchHeapEntry *entry2 = heapEntry2Void;
-    if (entry1 == NULL || entry2 == NULL) {
-        return 0;
+static void clearSearchQueue(SearchQueue *queue) {
+    clearIndexedHeap(queue->heap);
+    clearRadixHeap(queue->radixHeap);
+}
+
+static inline bool isEmptySearchQueue(const SearchQueue *queue) {
+    if (queue->radixHeap != NULL) {
+        return isEmptyRadixHeap(queue->radixHeap);
     }
+    return isEmptyIndexedHeap(queue->heap);
+}
 
-    return compareDistances(entry1->distance, entry2->distance);
+static inline void pushToSearchQueue(SearchQueue *queue, uint32_t cityId, Distance distance) {
+    if (queue->radixHeap != NULL) {
+        pushToRadixHeap(queue->radixHeap, cityId, heapKeyOfDistance(distance));
+    } else {
+        pushToIndexedHeap(queue->heap, cityId, heapKeyOfDistance(distance));
+    }
 }
 
-static Distance addRoadToDistance(Distance distance, Road *road) {
-    Distance newDistance = distance;
-    newDistance.length += road->length;
-    if (road->lastRepaired < newDistance.lastRepaired) {
-        newDistance.lastRepaired = road->lastRepaired;
+static inline uint32_t popFromSearchQueue(SearchQueue *queue) {
+    if (queue->radixHeap != NULL) {
+        return popFromRadixHeap(queue->radixHeap, NULL);
     }
-    return newDistance;
+    return popFromIndexedHeap(queue->heap, NULL);
 }
 
-static Distance combineDistances(Distance distance1, Distance distance2) {
-    Distance newDistance = distance1;
-    newDistance.length += distance2.length;
-    if (distance2.lastRepaired < newDistance.lastRepaired) {
-        newDistance.lastRepaired = distance2.lastRepaired;
+static inline uint64_t minimumLengthInSearchQueue(SearchQueue *queue) {
+    if (queue->radixHeap != NULL) {
+        return minimumKeyOfRadixHeap(queue->radixHeap).primary;
     }
-    return newDistance;
+    return minimumKeyOfIndexedHeap(queue->heap).primary;
 }
 
+static bool prepareSearchWorkspace(SearchWorkspace *workspace, size_t cityCount, size_t directionCount) {
+    if (cityCount > workspace->capacity) {
+        /* Tablice rosną dwukrotnie, żeby dodawanie miast nie powodowało ciągłego przydzielania. */
+        size_t capacity = workspace->capacity * 2 > cityCount ? workspace->capacity * 2 : cityCount;
+        freeSearchWorkspaceArrays(workspace);
+        workspace->blockedStamps = allocatePages(sizeof(uint32_t) * capacity);
+        workspace->capacity = capacity;
+        workspace->epoch = 0;
+        if (workspace->blockedStamps == NULL) {
+            freeSearchWorkspaceArrays(workspace);
+            return false;
+        }
+    }
 
-int compareDistances(Distance distance1, Distance distance2) {
-    if (distance1.length < distance2.length) {
-        return -1;
+    for (size_t direction = 0; direction < directionCount; direction++) {
+        /* Nowe tablice są wyzerowane, więc żaden ich znacznik nie jest aktualny. */
+        if (workspace->slots[direction] == NULL) {
+            workspace->slots[direction] = allocatePages(sizeof(SearchSlot) * workspace->capacity);
+            if (workspace->slots[direction] == NULL) {
+                return false;
+            }
+        }
+
+        SearchQueue *queue = &workspace->queues[direction];
+        if ((queue->radixHeap != NULL) != (searchQueueKind == SEARCH_QUEUE_RADIX)) {
+            deleteSearchQueue(queue);
+        }
+        if (queue->heap == NULL && queue->radixHeap == NULL && !initSearchQueue(queue, workspace->capacity)) {
+            return false;
+        }
+        clearSearchQueue(queue);
     }
-    if (distance1.length > distance2.length) {
-        return 1;
+
+    workspace->epoch++;
+    if (workspace->epoch == 0) {
+        /* Po przekręceniu się licznika stare znaczniki mogłyby wyglądać na aktualne. */
+        for (size_t direction = 0; direction < SEARCH_DIRECTION_COUNT; direction++) {
+            for (size_t i = 0; workspace->slots[direction] != NULL && i < workspace->capacity; i++) {
+                workspace->slots[direction][i].stamp = 0;
+            }
+        }
+        memset(workspace->blockedStamps, 0, sizeof(uint32_t) * workspace->capacity);
+        if (workspace->prefetchStamps != NULL) {
+            memset(workspace->prefetchStamps, 0, sizeof(uint32_t) * workspace->prefetchCapacity);
+        }
+        workspace->epoch = 1;
     }
+    clearVector(workspace->meetingRoads);
+    return true;
+}
 
-    if (distance1.lastRepaired > distance2.lastRepaired) {
-        return -1;
+static void freeSearchWorkspaceArrays(SearchWorkspace *workspace) {
+    for (size_t direction = 0; direction < SEARCH_DIRECTION_COUNT; direction++) {
+        freePages(workspace->slots[direction], sizeof(SearchSlot) * workspace->capacity);
+        deleteSearchQueue(&workspace->queues[direction]);
+        workspace->slots[direction] = NULL;
     }
-    if (distance1.lastRepaired < distance2.lastRepaired) {
-        return 1;
+    freePages(workspace->blockedStamps, sizeof(uint32_t) * workspace->capacity);
+    workspace->blockedStamps = NULL;
+    workspace->capacity = 0;
+    freePages(workspace->prefetchStamps, sizeof(uint32_t) * workspace->prefetchCapacity);
+    workspace->prefetchStamps = NULL;
+    workspace->prefetchCapacity = 0;
+}
+
+static bool reservePrefetchStamps(SearchWorkspace *workspace, size_t blockCount) {
+    if (blockCount <= workspace->prefetchCapacity) {
+        return true;
     }
-    return 0;
+
+    size_t capacity = workspace->prefetchCapacity * 2 > blockCount ? workspace->prefetchCapacity * 2 : blockCount;
+    uint32_t *stamps = allocatePages(sizeof(uint32_t) * capacity);
+    if (stamps == NULL) {
+        return false;
+    }
+    freePages(workspace->prefetchStamps, sizeof(uint32_t) * workspace->prefetchCapacity);
+    workspace->prefetchStamps = stamps;
+    workspace->prefetchCapacity = capacity;
+    return true;
 }
 
-RouteSearchAnswer findRoute(const Map *map, City *city1, City *city2, const Vector *usedRoads) {
-    /*
-     * Do szukania najkrótszej ścieżki wykorzystywany jest algorytm Dijkstry.
-     * Jest to wariant kopcowy, czyli dystanse do rozpatrzenia wrzucamy na minimalny kopiec.
-     * Dystanse są wrzucane dla każdej poprawy jaką da się zrobić, czyli może jedno miasto być kilka razy na kopcu.
-     * Jednak wtedy dystanse będą różne (ściśle mniejsze z każdym kolejnym dodaniem).
-     */
-    Distance *distances = NULL;
-    bool *blockedCities = NULL;
-    Heap *heap = NULL;
-    Vector *route = NULL;
-    RouteSearchHeapEntry *entry = NULL;
+static inline Distance searchDistanceOf(const SearchWorkspace *workspace, SearchDirection direction, uint32_t cityId) {
+    const SearchSlot *slot = &workspace->slots[direction][cityId];
+    if (slot->stamp != workspace->epoch) {
+        return WORST_DISTANCE;
+    }
+    return unpackDistance(slot->distance);
+}
 
-    RouteSearchAnswer answer;
-    answer.count = -1;
-    answer.roads = NULL;
-    answer.distance = WORST_DISTANCE;
-    FAIL_IF(map == NULL || city1 == NULL || city2 == NULL);
+static inline void setSearchDistance(SearchWorkspace *workspace, SearchDirection direction, uint32_t cityId,
+                                     Distance distance) {
+    workspace->slots[direction][cityId].distance = packDistance(distance);
+    workspace->slots[direction][cityId].stamp = workspace->epoch;
+}
 
-    size_t cityCount = map->cityCount;
-    distances = malloc(sizeof(Distance) * cityCount);
-    FAIL_IF(distances == NULL);
+static inline Distance reachedDistanceOf(const SearchWorkspace *workspace, SearchDirection direction,
+                                         uint32_t cityId) {
+    if (workspace->slots[direction][cityId].stamp != workspace->epoch ||
+        workspace->blockedStamps[cityId] == workspace->epoch) {
+        return WORST_DISTANCE;
+    }
+    return unpackDistance(workspace->slots[direction][cityId].distance);
+}
 
-    for (size_t i = 0; i < cityCount; i++) {
-        distances[i] = WORST_DISTANCE;
+static void blockUsedCities(RouteSearch *search, const Vector *usedRoads, size_t directionCount) {
+    SearchWorkspace *workspace = search->workspace;
+    size_t usedRoadsCount = sizeOfVector(usedRoads);
+    Road **usedRoadsArray = (Road **) storageBlockOfVector(usedRoads);
+    for (size_t i = 0; i < usedRoadsCount; i++) {
+        uint32_t endIds[2] = {usedRoadsArray[i]->end1Id, usedRoadsArray[i]->end2Id};
+        for (size_t j = 0; j < 2; j++) {
+            for (size_t direction = 0; direction < directionCount; direction++) {
+                setSearchDistance(workspace, direction, endIds[j], BASE_DISTANCE);
+            }
+            workspace->blockedStamps[endIds[j]] = workspace->epoch;
+        }
     }
 
-    /* Dla danych użytych już odcinków, nie można przechodzić przez miasta na tychże odcinkach. */
-    blockedCities = calloc(cityCount, sizeof(bool));
-    FAIL_IF(blockedCities == NULL);
-    {
-        size_t usedRoadsCount = sizeOfVector(usedRoads);
-        Road **usedRoadsArray = (Road **) storageBlockOfVector(usedRoads);
-        for (size_t i = 0; i < usedRoadsCount; i++) {
-            blockedCities[usedRoadsArray[i]->end1->id] = true;
-            blockedCities[usedRoadsArray[i]->end2->id] = true;
-        }
-        /* Miasta końcowe mogą wystąpić na liście, więc trzeba je odznaczyć. */
-        blockedCities[city1->id] = false;
-        blockedCities[city2->id] = false;
-    }
-
-    heap = initHeap(compareRouteSearchHeapEntries);
-    FAIL_IF(heap == NULL);
-
-    distances[city2->id] = BASE_DISTANCE;
-    {
-        /* Szukana jest droga z city2 do city1, żeby odbudowując ją od tyłu była w dobrej kolejności. */
-        entry = initHeapEntry(distances[city2->id], city2);
-        FAIL_IF(entry == NULL || !addToHeap(heap, (void **) &entry));
-    }
-
-    while (!isEmptyHeap(heap)) {
-        RouteSearchHeapEntry *nextEntry = getMinimumFromHeap(heap);
-        FAIL_IF(nextEntry == NULL);
-        Distance distance = nextEntry->distance;
-        City *city = nextEntry->city;
-        free(nextEntry);
-
-        if (blockedCities[city->id] || compareDistances(distance, distances[city->id]) > 0) {
-            /* Nie można tędy przejść lub dystans jest nieoptymalny,
-             * czyli wierzchołek już był rozważony wcześniej. */
-            continue;
+    /* Miasta końcowe mogą wystąpić na liście, więc trzeba je odznaczyć. */
+    uint32_t endIds[2] = {search->city1Id, search->city2Id};
+    for (size_t j = 0; j < 2; j++) {
+        for (size_t direction = 0; direction < directionCount; direction++) {
+            workspace->slots[direction][endIds[j]].stamp = 0;
         }
+        workspace->blockedStamps[endIds[j]] = 0;
+    }
+}
+
+static inline void prefetchCityBlock(RouteSearch *search, uint32_t cityId) {
+    size_t block = cityId / CSR_BLOCK_CITIES;
+    SearchWorkspace *workspace = search->workspace;
+    if (search->prefetching && isCityInCsr(search->graph, cityId) &&
+        workspace->prefetchStamps[block] != workspace->epoch) {
+        workspace->prefetchStamps[block] = workspace->epoch;
+        prefetchCsrBlock(search->graph, block);
+    }
+}
 
-        distances[city->id] = distance;
+static EdgeCursor initEdgeCursor(const CsrGraph *graph, const GraphMemory *memory, uint32_t cityId) {
+    EdgeCursor cursor;
+    cursor.cityId = cityId;
+    cursor.memory = memory;
+    if (isCityInCsr(graph, cityId)) {
+        cursor.graph = graph;
+        cursor.roads = NULL;
+        cursor.position = graph->offsets[cityId];
+        cursor.end = graph->offsets[cityId + 1];
+    } else {
+        const City *city = cityOfId(memory, cityId);
+        cursor.graph = NULL;
+        cursor.roads = roadNumbersOfCity(city);
+        cursor.position = 0;
+        cursor.end = city->roadCount;
+    }
+    return cursor;
+}
 
-        if (city == city1) {
-            /* Została już znaleziona cała ścieżka, więc nie ma potrzeby kontynuować. */
-            break;
+static inline bool nextSearchEdge(EdgeCursor *cursor, SearchEdge *edge) {
+    if (cursor->graph != NULL) {
+        if (cursor->position == cursor->end) {
+            return false;
         }
 
-        size_t roadCount = sizeOfVector(city->roads);
-        Road **roads = (Road **) storageBlockOfVector(city->roads);
-        for (size_t i = 0; i < roadCount; i++) {
-            Road *road = roads[i];
-            City *newCity = otherRoadEnd(road, city);
-            if (newCity == NULL) {
-                continue;
-            }
+        /* Kopia zawiera tylko niezablokowane odcinki. */
+        const CsrGraph *graph = cursor->graph;
+        size_t position = cursor->position++;
+        edge->cityId = graph->neighbors[position];
+        edge->length = graph->lengths[position];
+        edge->lastRepaired = graph->years[position];
+        edge->roadNumber = graph->roadNumbers[position];
+        return true;
+    }
 
-            Distance newDistance = addRoadToDistance(distance, road);
+    while (cursor->position < cursor->end) {
+        uint32_t roadNumber = cursor->roads[cursor->position++];
+        const Road *road = roadOfNumber(cursor->memory, roadNumber);
+        uint32_t cityId = otherRoadEndId(road, cursor->cityId);
+        if (cityId != NO_CITY_ID) {
+            edge->cityId = cityId;
+            edge->length = road->length;
+            edge->lastRepaired = road->lastRepaired;
+            edge->roadNumber = roadNumber;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void relaxCsrEdges(const CsrGraph *graph, uint32_t cityId, Distance distance, SearchWorkspace *workspace) {
+    size_t begin = graph->offsets[cityId];
+    size_t end = graph->offsets[cityId + 1];
+    const SearchSlot *slots = workspace->slots[SEARCH_FORWARD];
+    uint32_t epoch = workspace->epoch;
+    for (size_t block = begin; block < end; block += RELAX_BLOCK_SIZE) {
+        size_t count = end - block < RELAX_BLOCK_SIZE ? end - block : RELAX_BLOCK_SIZE;
+        uint64_t lengths[RELAX_BLOCK_SIZE];
+        int years[RELAX_BLOCK_SIZE];
+        bool better[RELAX_BLOCK_SIZE];
 
-            if (compareDistances(newDistance, distances[newCity->id]) < 0) {
-                /* Da się uzyskać lepszy dystans do newCity, czyli dodawane jest wejście na kopiec. */
-                distances[newCity->id] = newDistance;
-                entry = initHeapEntry(newDistance, newCity);
+        for (size_t i = 0; i < count; i++) {
+            /* Sąsiad nieosiągnięty w bieżącym szukaniu ma zawsze gorszy dystans. */
+            const SearchSlot *slot = &slots[graph->neighbors[block + i]];
+            Distance current = unpackDistance(slot->distance);
+            int year = graph->years[block + i];
+            lengths[i] = distance.length + graph->lengths[block + i];
+            years[i] = year < distance.lastRepaired ? year : distance.lastRepaired;
+            better[i] = (slot->stamp != epoch) | (lengths[i] < current.length) |
+                        ((lengths[i] == current.length) & (years[i] > current.lastRepaired));
+        }
 
-                FAIL_IF(entry == NULL || !addToHeap(heap, (void **) &entry));
+        /* Sąsiedzi w bloku są różni, więc aktualizacje nie wpływają na maskę. */
+        for (size_t i = 0; i < count; i++) {
+            if (!better[i]) {
+                continue;
             }
+
+            uint32_t neighbor = graph->neighbors[block + i];
+            Distance newDistance = {lengths[i], years[i]};
+            setSearchDistance(workspace, SEARCH_FORWARD, neighbor, newDistance);
+            pushToSearchQueue(&workspace->queues[SEARCH_FORWARD], neighbor, newDistance);
         }
     }
+}
 
-    deleteHeap(heap, free);
-    heap = NULL;
+static Distance addEdgeToDistance(Distance distance, const SearchEdge *edge) {
+    Distance newDistance = distance;
+    newDistance.length += edge->length;
+    if (edge->lastRepaired < newDistance.lastRepaired) {
+        newDistance.lastRepaired = edge->lastRepaired;
+    }
+    return newDistance;
+}
 
-    /* Żeby nie przejść przez zablokowane miasta, ustawiany jest dla nich najgorszy wynik. */
-    for (size_t i = 0;
-         i < cityCount; i++) {
-        if (blockedCities[i]) {
-            distances[i] = WORST_DISTANCE;
-        }
+static Distance combineDistances(Distance distance1, Distance distance2) {
+    Distance newDistance = distance1;
+    newDistance.length += distance2.length;
+    if (distance2.lastRepaired < newDistance.lastRepaired) {
+        newDistance.lastRepaired = distance2.lastRepaired;
     }
+    return newDistance;
+}
 
-    free(blockedCities);
-    blockedCities = NULL;
+static void searchOneWay(RouteSearch *search) {
+    SearchWorkspace *workspace = search->workspace;
+    SearchQueue *queue = &workspace->queues[SEARCH_FORWARD];
 
-    route = initVector();
-    FAIL_IF(route == NULL);
+    /* Szukana jest droga z city2 do city1, żeby odbudowując ją od tyłu była w dobrej kolejności. */
+    setSearchDistance(workspace, SEARCH_FORWARD, search->city2Id, BASE_DISTANCE);
+    pushToSearchQueue(queue, search->city2Id, BASE_DISTANCE);
 
-    City *position = city1;
-    Distance currentDistance = BASE_DISTANCE;
-    Distance endDistance = distances[city1->id];
-    answer.distance = endDistance;
-    while (position != city2) {
-        /* Idąc od końca sprawdzane jest skąd mógł zostać uzyskany dystans i na ile sposobów. */
-        City *newPosition = NULL;
-        Distance newCurrentDistance = WORST_DISTANCE;
-        size_t roadCount = sizeOfVector(position->roads);
-        Road **roads = (Road **) storageBlockOfVector(position->roads);
+    while (!isEmptySearchQueue(queue)) {
+        /* Zdjęte miasto ma już optymalny dystans, zapisany w pamięci roboczej. */
+        uint32_t cityId = popFromSearchQueue(queue);
+        Distance distance = searchDistanceOf(workspace, SEARCH_FORWARD, cityId);
 
-        for (size_t i = 0; i < roadCount; i++) {
-            Road *road = roads[i];
-            City *newCity = otherRoadEnd(road, position);
-            if (newCity == NULL) {
-                continue;
+        if (cityId == search->city1Id) {
+            /* Została już znaleziona cała ścieżka, więc nie ma potrzeby kontynuować. */
+            break;
+        }
+
+        if (isCityInCsr(search->graph, cityId)) {
+            prefetchCityBlock(search, cityId);
+            relaxCsrEdges(search->graph, cityId, distance, workspace);
+            continue;
+        }
+
+        EdgeCursor cursor = initEdgeCursor(search->graph, search->memory, cityId);
+        SearchEdge edge;
+        while (nextSearchEdge(&cursor, &edge)) {
+            Distance newDistance = addEdgeToDistance(distance, &edge);
+
+            if (compareDistances(newDistance, searchDistanceOf(workspace, SEARCH_FORWARD, edge.cityId)) < 0) {
+                /* Da się uzyskać lepszy dystans do newCity, czyli jest ono dodawane na kopiec lub poprawiane. */
+                setSearchDistance(workspace, SEARCH_FORWARD, edge.cityId, newDistance);
+                pushToSearchQueue(queue, edge.cityId, newDistance);
             }
+        }
+    }
+}
 
-            Distance newDistance = addRoadToDistance(distances[newCity->id], road);
+static int traceRouteOneWay(const RouteSearch *search, Vector *route) {
+    const SearchWorkspace *workspace = search->workspace;
+    uint32_t position = search->city1Id;
+    Distance currentDistance = BASE_DISTANCE;
+    Distance endDistance = reachedDistanceOf(workspace, SEARCH_FORWARD, search->city1Id);
+    while (position != search->city2Id) {
+        /* Idąc od końca sprawdzane jest skąd mógł zostać uzyskany dystans i na ile sposobów. */
+        uint32_t newPosition = NO_CITY_ID;
+        Distance newCurrentDistance = WORST_DISTANCE;
+        EdgeCursor cursor = initEdgeCursor(search->graph, search->memory, position);
+        SearchEdge edge;
+        while (nextSearchEdge(&cursor, &edge)) {
+            /* Zablokowane miasta mają najgorszy dystans, żeby nie przejść przez nie. */
+            Distance newDistance = addEdgeToDistance(reachedDistanceOf(workspace, SEARCH_FORWARD, edge.cityId), &edge);
             newDistance = combineDistances(newDistance, currentDistance);
 
             /* Sprawdzenie czy da się uzyskać dobry dystans przychodząc z [newCity]. */
             if (compareDistances(newDistance, endDistance) == 0) {
 
-                /* Jeśli [newPosition != NULL] to są dwie możliwe drogi. */
-                if (newPosition != NULL || !pushToVector(route, road)) {
-                    answer.count = 2;
-                    FAIL;
+                /* Jeśli [newPosition != NO_CITY_ID] to są dwie możliwe drogi. */
+                if (newPosition != NO_CITY_ID || !pushToVector(route, roadOfNumber(search->memory, edge.roadNumber))) {
+                    return 2;
                 }
-                newPosition = newCity;
-                newCurrentDistance = addRoadToDistance(currentDistance, road);
+                newPosition = edge.cityId;
+                newCurrentDistance = addEdgeToDistance(currentDistance, &edge);
             }
         }
 
-        if (newPosition == NULL) {
+        if (newPosition == NO_CITY_ID) {
             /* Nie ma żadnego rozwiązania. */
-            answer.count = 0;
-            FAIL;
+            return 0;
         }
 
         position = newPosition;
         currentDistance = newCurrentDistance;
     }
+    return 1;
+}
+
+static inline uint64_t landmarkBoundOf(const RouteSearch *search, uint32_t cityId) {
+    if (search->landmarks == NULL) {
+        return 0;
+    }
+
+    const uint64_t *distances = search->landmarks->distances + (size_t) cityId * LANDMARK_COUNT;
+    uint64_t bound = 0;
+    for (size_t i = 0; i < LANDMARK_COUNT; i++) {
+        uint64_t target = search->targetDistances[i];
+        if ((target == NO_LANDMARK_DISTANCE) != (distances[i] == NO_LANDMARK_DISTANCE)) {
+            return NO_LANDMARK_DISTANCE;
+        }
+        if (target == NO_LANDMARK_DISTANCE) {
+            continue;
+        }
+
+        uint64_t difference = target > distances[i] ? target - distances[i] : distances[i] - target;
+        if (difference > bound) {
+            bound = difference;
+        }
+    }
+    return bound;
+}
+
+static size_t searchWithLandmarks(RouteSearch *search) {
+    SearchWorkspace *workspace = search->workspace;
+    SearchQueue *queue = &workspace->queues[SEARCH_FORWARD];
+    size_t work = 0;
+
+    Distance key = BASE_DISTANCE;
+    key.length = landmarkBoundOf(search, search->city2Id);
+    if (key.length == NO_LANDMARK_DISTANCE) {
+        /* Nie ma żadnej drogi, więc nie ma czego szukać. */
+        return work;
+    }
+    setSearchDistance(workspace, SEARCH_FORWARD, search->city2Id, BASE_DISTANCE);
+    pushToSearchQueue(queue, search->city2Id, key);
+
+    while (!isEmptySearchQueue(queue)) {
+        /* Dopóki pierwsze miasto nie jest osiągnięte, jego dystans jest najgorszy. */
+        Distance targetDistance = reachedDistanceOf(workspace, SEARCH_FORWARD, search->city1Id);
+        if (minimumLengthInSearchQueue(queue) > targetDistance.length) {
+            break;
+        }
+
+        uint32_t cityId = popFromSearchQueue(queue);
+        Distance distance = searchDistanceOf(workspace, SEARCH_FORWARD, cityId);
+        work++;
+
+        prefetchCityBlock(search, cityId);
+        EdgeCursor cursor = initEdgeCursor(search->graph, search->memory, cityId);
+        SearchEdge edge;
+        while (nextSearchEdge(&cursor, &edge)) {
+            Distance newDistance = addEdgeToDistance(distance, &edge);
+
+            if (compareDistances(newDistance, searchDistanceOf(workspace, SEARCH_FORWARD, edge.cityId)) < 0) {
+                setSearchDistance(workspace, SEARCH_FORWARD, edge.cityId, newDistance);
+                key = newDistance;
+                key.length += landmarkBoundOf(search, edge.cityId);
+                pushToSearchQueue(queue, edge.cityId, key);
+            }
+        }
+    }
+    return work;
+}
+
+static bool recordMeeting(RouteSearch *search, Distance distance, uint32_t forwardId, const SearchEdge *edge) {
+    int comparison = compareDistances(distance, search->meetingDistance);
+    if (comparison > 0) {
+        return true;
+    }
+
+    if (comparison < 0) {
+        search->meetingDistance = distance;
+        search->meetingForwardId = forwardId;
+        search->meetingEdge = *edge;
+        clearVector(search->workspace->meetingRoads);
+    }
+    return pushToVector(search->workspace->meetingRoads, roadOfNumber(search->memory, edge->roadNumber));
+}
+
+static bool scanEdgesBothWays(RouteSearch *search, SearchDirection direction, uint32_t cityId, Distance distance) {
+    SearchWorkspace *workspace = search->workspace;
+    SearchDirection otherDirection = direction == SEARCH_FORWARD ? SEARCH_BACKWARD : SEARCH_FORWARD;
+    EdgeCursor cursor = initEdgeCursor(search->graph, search->memory, cityId);
+    SearchEdge edge;
+    while (nextSearchEdge(&cursor, &edge)) {
+        Distance newDistance = addEdgeToDistance(distance, &edge);
+
+        Distance otherDistance = reachedDistanceOf(workspace, otherDirection, edge.cityId);
+        if (compareDistances(otherDistance, WORST_DISTANCE) != 0) {
+            /* Sąsiad jest osiągnięty z drugiej strony, więc przez ten odcinek prowadzi cała droga. */
+            Distance total = combineDistances(newDistance, otherDistance);
+            bool recorded;
+            if (direction == SEARCH_FORWARD) {
+                recorded = recordMeeting(search, total, cityId, &edge);
+            } else {
+                SearchEdge reversed = edge;
+                reversed.cityId = cityId;
+                recorded = recordMeeting(search, total, edge.cityId, &reversed);
+            }
+            if (!recorded) {
+                return false;
+            }
+        }
+
+        if (compareDistances(newDistance, searchDistanceOf(workspace, direction, edge.cityId)) < 0) {
+            setSearchDistance(workspace, direction, edge.cityId, newDistance);
+            pushToSearchQueue(&workspace->queues[direction], edge.cityId, newDistance);
+        }
+    }
+    return true;
+}
+
+static bool searchBothWays(RouteSearch *search) {
+    SearchWorkspace *workspace = search->workspace;
+    SearchQueue *forwardQueue = &workspace->queues[SEARCH_FORWARD];
+    SearchQueue *backwardQueue = &workspace->queues[SEARCH_BACKWARD];
+
+    search->meetingDistance = WORST_DISTANCE;
+    search->meetingForwardId = NO_CITY_ID;
+    setSearchDistance(workspace, SEARCH_FORWARD, search->city2Id, BASE_DISTANCE);
+    pushToSearchQueue(forwardQueue, search->city2Id, BASE_DISTANCE);
+    setSearchDistance(workspace, SEARCH_BACKWARD, search->city1Id, BASE_DISTANCE);
+    pushToSearchQueue(backwardQueue, search->city1Id, BASE_DISTANCE);
+
+    while (!isEmptySearchQueue(forwardQueue) && !isEmptySearchQueue(backwardQueue)) {
+        uint64_t forwardLength = minimumLengthInSearchQueue(forwardQueue);
+        uint64_t backwardLength = minimumLengthInSearchQueue(backwardQueue);
+        if (forwardLength + backwardLength > search->meetingDistance.length) {
+            break;
+        }
+
+        SearchDirection direction = forwardLength <= backwardLength ? SEARCH_FORWARD : SEARCH_BACKWARD;
+        uint32_t cityId = popFromSearchQueue(&workspace->queues[direction]);
+        prefetchCityBlock(search, cityId);
+        if (!scanEdgesBothWays(search, direction, cityId, searchDistanceOf(workspace, direction, cityId))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t findMatchingNeighbor(const RouteSearch *search, SearchDirection direction, uint32_t cityId,
+                                     Distance rest, Distance total, uint32_t skippedId, SearchEdge *edge) {
+    EdgeCursor cursor = initEdgeCursor(search->graph, search->memory, cityId);
+    while (nextSearchEdge(&cursor, edge)) {
+        if (edge->cityId == skippedId) {
+            continue;
+        }
+
+        /* Zablokowane miasta mają najgorszy dystans, żeby nie przejść przez nie. */
+        Distance distance = addEdgeToDistance(reachedDistanceOf(search->workspace, direction, edge->cityId), edge);
+        if (compareDistances(combineDistances(distance, rest), total) == 0) {
+            return edge->cityId;
+        }
+    }
+    return NO_CITY_ID;
+}
+
+static int traceRouteBothWays(const RouteSearch *search, Vector *route) {
+    const SearchWorkspace *workspace = search->workspace;
+    Distance total = search->meetingDistance;
+    if (search->meetingForwardId == NO_CITY_ID) {
+        /* Nie ma żadnego rozwiązania. */
+        return 0;
+    }
+
+    /*
+     * Część od odcinka spotkania do city1 jest składana dystansami od city1,
+     * z dystansem części od city2 do odcinka spotkania wziętym z szukania.
+     */
+    SearchEdge edge;
+    uint32_t position = search->meetingEdge.cityId;
+    Distance prefix = addEdgeToDistance(searchDistanceOf(workspace, SEARCH_FORWARD, search->meetingForwardId),
+                                        &search->meetingEdge);
+    Distance suffix = BASE_DISTANCE;
+    while (position != search->city1Id) {
+        uint32_t newPosition = findMatchingNeighbor(search, SEARCH_BACKWARD, position, prefix, total, NO_CITY_ID, &edge);
+        if (newPosition == NO_CITY_ID) {
+            return 0;
+        }
+        if (!pushToVector(route, roadOfNumber(search->memory, edge.roadNumber))) {
+            return -1;
+        }
+        prefix = addEdgeToDistance(prefix, &edge);
+        suffix = addEdgeToDistance(suffix, &edge);
+        position = newPosition;
+    }
+
+    /* Odcinki zostały dodane od odcinka spotkania, a droga ma zaczynać się w city1. */
+    size_t count = sizeOfVector(route);
+    void **roads = storageBlockOfVector(route);
+    for (size_t i = 0; i < count / 2; i++) {
+        void *road = roads[i];
+        roads[i] = roads[count - 1 - i];
+        roads[count - 1 - i] = road;
+    }
+
+    /* Część od odcinka spotkania do city2 jest składana z dokładnym dystansem reszty drogi. */
+    if (!pushToVector(route, roadOfNumber(search->memory, search->meetingEdge.roadNumber))) {
+        return -1;
+    }
+    suffix = addEdgeToDistance(suffix, &search->meetingEdge);
+    position = search->meetingForwardId;
+    while (position != search->city2Id) {
+        uint32_t newPosition = findMatchingNeighbor(search, SEARCH_FORWARD, position, suffix, total, NO_CITY_ID, &edge);
+        if (newPosition == NO_CITY_ID) {
+            return 0;
+        }
+        if (!pushToVector(route, roadOfNumber(search->memory, edge.roadNumber))) {
+            return -1;
+        }
+        suffix = addEdgeToDistance(suffix, &edge);
+        position = newPosition;
+    }
+
+    /* Sprawdzenie czy w którymś mieście drogi inny sąsiad daje ten sam dystans. */
+    count = sizeOfVector(route);
+    roads = storageBlockOfVector(route);
+    position = search->city1Id;
+    suffix = BASE_DISTANCE;
+    for (size_t i = 0; i < count; i++) {
+        Road *road = roads[i];
+        uint32_t nextPosition = otherRoadEndId(road, position);
+        if (findMatchingNeighbor(search, SEARCH_FORWARD, position, suffix, total, nextPosition, &edge) != NO_CITY_ID) {
+            return 2;
+        }
+        SearchEdge roadEdge = {nextPosition, road->length, road->lastRepaired, numberOfRoad(search->memory, road)};
+        suffix = addEdgeToDistance(suffix, &roadEdge);
+        position = nextPosition;
+    }
+
+    position = search->city2Id;
+    prefix = BASE_DISTANCE;
+    for (size_t i = count; i > 0; i--) {
+        Road *road = roads[i - 1];
+        uint32_t nextPosition = otherRoadEndId(road, position);
+        if (findMatchingNeighbor(search, SEARCH_BACKWARD, position, prefix, total, nextPosition, &edge) != NO_CITY_ID) {
+            return 2;
+        }
+        SearchEdge roadEdge = {nextPosition, road->length, road->lastRepaired, numberOfRoad(search->memory, road)};
+        prefix = addEdgeToDistance(prefix, &roadEdge);
+        position = nextPosition;
+    }
+
+    /* Każda najlepsza droga ma odcinek spotkania, więc odcinek spotkania poza drogą oznacza drugą drogę. */
+    size_t meetingCount = sizeOfVector(workspace->meetingRoads);
+    void **meetingRoads = storageBlockOfVector(workspace->meetingRoads);
+    for (size_t i = 0; i < meetingCount; i++) {
+        if (!existsInVector(route, meetingRoads[i])) {
+            return 2;
+        }
+    }
+    return 1;
+}
+
+
+SearchWorkspace *initSearchWorkspace(void) {
+    SearchWorkspace *workspace = malloc(sizeof(SearchWorkspace));
+    if (workspace == NULL) {
+        return NULL;
+    }
+
+    workspace->capacity = 0;
+    workspace->blockedStamps = NULL;
+    workspace->prefetchCapacity = 0;
+    workspace->prefetchStamps = NULL;
+    workspace->epoch = 0;
+    for (size_t direction = 0; direction < SEARCH_DIRECTION_COUNT; direction++) {
+        workspace->slots[direction] = NULL;
+        workspace->queues[direction].heap = NULL;
+        workspace->queues[direction].radixHeap = NULL;
+    }
+    workspace->meetingRoads = initVector();
+    if (workspace->meetingRoads == NULL) {
+        free(workspace);
+        return NULL;
+    }
+    return workspace;
+}
+
+void deleteSearchWorkspace(SearchWorkspace *workspace) {
+    if (workspace == NULL) {
+        return;
+    }
+
+    freeSearchWorkspaceArrays(workspace);
+    deleteVector(workspace->meetingRoads, NULL);
+    free(workspace);
+}
+
+bool parseSearchQueueKind(const char *text, SearchQueueKind *kind) {
+    if (text == NULL || kind == NULL) {
+        return false;
+    }
+
+    if (strcmp(text, "heap") == 0) {
+        *kind = SEARCH_QUEUE_HEAP;
+    } else if (strcmp(text, "radix") == 0) {
+        *kind = SEARCH_QUEUE_RADIX;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void setSearchQueueKind(SearchQueueKind kind) {
+    searchQueueKind = kind;
+}
+
+const char *describeSearchQueueKind(SearchQueueKind kind) {
+    if (kind == SEARCH_QUEUE_RADIX) {
+        return "radix heap";
+    }
+    return "4-ary heap";
+}
+
+bool parseSearchEngine(const char *text, SearchEngine *engine) {
+    if (text == NULL || engine == NULL) {
+        return false;
+    }
+
+    if (strcmp(text, "dijkstra") == 0) {
+        *engine = SEARCH_ENGINE_DIJKSTRA;
+    } else if (strcmp(text, "bidirectional") == 0) {
+        *engine = SEARCH_ENGINE_BIDIRECTIONAL;
+    } else if (strcmp(text, "alt") == 0) {
+        *engine = SEARCH_ENGINE_ALT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void setSearchEngine(SearchEngine engine) {
+    searchEngine = engine;
+}
+
+const char *describeSearchEngine(SearchEngine engine) {
+    if (engine == SEARCH_ENGINE_BIDIRECTIONAL) {
+        return "bidirectional Dijkstra";
+    }
+    if (engine == SEARCH_ENGINE_ALT) {
+        return "A* with landmarks";
+    }
+    return "one-way Dijkstra";
+}
+
+int compareDistances(Distance distance1, Distance distance2) {
+    if (distance1.length < distance2.length) {
+        return -1;
+    }
+    if (distance1.length > distance2.length) {
+        return 1;
+    }
+
+    if (distance1.lastRepaired > distance2.lastRepaired) {
+        return -1;
+    }
+    if (distance1.lastRepaired < distance2.lastRepaired) {
+        return 1;
+    }
+    return 0;
+}
+
+RouteSearchAnswer findRoute(const Map *map, City *city1, City *city2, const Vector *usedRoads) {
+    /*
+     * Do szukania najkrótszej ścieżki wykorzystywany jest algorytm Dijkstry,
+     * od drugiego miasta albo jednocześnie od obu miast, albo algorytm A*
+     * kierowany odległościami od punktów orientacyjnych.
+     * Jest to wariant kopcowy, czyli miasta do rozpatrzenia wrzucamy do kolejki priorytetowej,
+     * indeksowanego kopca lub kopca pozycyjnego. Każde miasto jest w kolejce co najwyżej raz,
+     * a przy poprawie dystansu jego klucz jest zmniejszany, więc pętla szukania niczego nie alokuje.
+     * Tablice dystansów i kolejki są w pamięci roboczej mapy i przeżywają szukanie,
+     * a nieaktualne dystanse są rozpoznawane po numerze szukania.
+     * Całe szukanie działa na id miast, wskaźniki na miasta są potrzebne tylko
+     * dla miast, które zmieniły się od zbudowania kopii grafu.
+     */
+    RouteSearch search;
+    search.prefetching = false;
+    search.landmarks = NULL;
+    search.targetDistances = NULL;
+    Vector *route = NULL;
+
+    RouteSearchAnswer answer;
+    answer.count = -1;
+    answer.roads = NULL;
+    answer.distance = WORST_DISTANCE;
+    FAIL_IF(map == NULL || city1 == NULL || city2 == NULL);
+
+    /* Miasta, które nie zmieniły się od zbudowania kopii, są czytane z kopii. */
+    refreshCsrGraph(map->csr, map);
+    search.graph = map->csr;
+    search.memory = map->memory;
+    search.workspace = map->searchWorkspace;
+    search.city1Id = city1->id;
+    search.city2Id = city2->id;
+
+    bool bothWays = searchEngine == SEARCH_ENGINE_BIDIRECTIONAL && search.city1Id != search.city2Id;
+    bool towardsTarget = searchEngine == SEARCH_ENGINE_ALT && search.city1Id != search.city2Id;
+    if (towardsTarget && prepareLandmarks(map->landmarks, map) &&
+        search.city1Id < map->landmarks->capacity && search.city2Id < map->landmarks->capacity) {
+        /* Bez odległości szukanie A* działa jak algorytm Dijkstry. */
+        search.landmarks = map->landmarks;
+        search.targetDistances = map->landmarks->distances + (size_t) search.city1Id * LANDMARK_COUNT;
+    }
+    size_t directionCount = bothWays ? SEARCH_DIRECTION_COUNT : 1;
+    FAIL_IF(!prepareSearchWorkspace(search.workspace, map->cityCount, directionCount));
+    if (isStorageInFile()) {
+        /* Kopia w pliku jest wczytywana blokami, gdy szukanie pierwszy raz do nich dotrze. */
+        FAIL_IF(!reservePrefetchStamps(search.workspace, csrBlockCount(search.graph) + 1));
+        search.prefetching = true;
+    }
+
+    /* Dla danych użytych już odcinków, nie można przechodzić przez miasta na tychże odcinkach. */
+    blockUsedCities(&search, usedRoads, directionCount);
+
+    route = initVector();
+    FAIL_IF(route == NULL);
+
+    if (bothWays) {
+        FAIL_IF(!searchBothWays(&search));
+        answer.distance = search.meetingDistance;
+        answer.count = traceRouteBothWays(&search, route);
+    } else {
+        if (towardsTarget) {
+            addLandmarkSearchWork(map->landmarks, searchWithLandmarks(&search));
+        } else {
+            searchOneWay(&search);
+        }
+        answer.distance = reachedDistanceOf(search.workspace, SEARCH_FORWARD, search.city1Id);
+        answer.count = traceRouteOneWay(&search, route);
+    }
+    FAIL_IF(answer.count != 1);
 
-    free(distances);
     answer.roads = route;
-    answer.count = 1;
     return answer;
 
     FAILURE:
 
-    free(entry);
-    free(distances);
-    free(blockedCities);
-    deleteHeap(heap, free);
     deleteVector(route, NULL);
     return answer;
 }
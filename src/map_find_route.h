@@ -10,6 +10,40 @@
 
 #include "map_types.h"
 
+#include <stdbool.h>
+
+/**
+ * Typ wyliczeniowy określający kolejkę priorytetową używaną przez szukanie drogi.
+ */
+enum SearchQueueKindEnum {
+    /** Indeksowany kopiec czwórkowy, porównujący klucze. */
+            SEARCH_QUEUE_HEAP,
+    /** Kopiec pozycyjny, trzymający klucze w kubełkach według bitów. */
+            SEARCH_QUEUE_RADIX
+};
+
+/**
+ * Typ wyliczeniowy określający sposób szukania drogi.
+ */
+enum SearchEngineEnum {
+    /** Algorytm Dijkstry od drugiego miasta do pierwszego. */
+            SEARCH_ENGINE_DIJKSTRA,
+    /** Algorytm Dijkstry jednocześnie od obu miast, spotykający się w środku. */
+            SEARCH_ENGINE_BIDIRECTIONAL,
+    /** Algorytm A* od drugiego miasta do pierwszego, z ograniczeniami z punktów orientacyjnych. */
+            SEARCH_ENGINE_ALT
+};
+
+/**
+ * Typ określający kolejkę priorytetową używaną przez szukanie drogi.
+ */
+typedef enum SearchQueueKindEnum SearchQueueKind;
+
+/**
+ * Typ określający sposób szukania drogi.
+ */
+typedef enum SearchEngineEnum SearchEngine;
+
 /** Struktura przechowująca łączny dystans dla drogi. */
 typedef struct DistanceStruct Distance;
 
@@ -45,10 +79,70 @@ struct RouteSearchAnswerStruct {
  */
 int compareDistances(Distance distance1, Distance distance2);
 
+/**
+ * @brief Odczytuje rodzaj kolejki z napisu.
+ * @param[in] text  - napis @p heap lub @p radix;
+ * @param[out] kind - wskaźnik na miejsce na rodzaj kolejki.
+ * @return @p true lub @p false gdy napis jest niepoprawny.
+ */
+bool parseSearchQueueKind(const char *text, SearchQueueKind *kind);
+
+/**
+ * @brief Ustawia rodzaj kolejki używanej przez kolejne szukania drogi.
+ * Domyślnie używany jest kopiec pozycyjny.
+ * @param[in] kind - rodzaj kolejki.
+ */
+void setSearchQueueKind(SearchQueueKind kind);
+
+/**
+ * @brief Opisuje rodzaj kolejki dla człowieka.
+ * @param[in] kind - rodzaj kolejki.
+ * @return Stały napis.
+ */
+const char *describeSearchQueueKind(SearchQueueKind kind);
+
+/**
+ * @brief Odczytuje sposób szukania z napisu.
+ * @param[in] text    - napis @p dijkstra, @p bidirectional lub @p alt;
+ * @param[out] engine - wskaźnik na miejsce na sposób szukania.
+ * @return @p true lub @p false gdy napis jest niepoprawny.
+ */
+bool parseSearchEngine(const char *text, SearchEngine *engine);
+
+/**
+ * @brief Ustawia sposób szukania używany przez kolejne szukania drogi.
+ * Domyślnie szukanie jest dwukierunkowe.
+ * @param[in] engine - sposób szukania.
+ */
+void setSearchEngine(SearchEngine engine);
+
+/**
+ * @brief Opisuje sposób szukania dla człowieka.
+ * @param[in] engine - sposób szukania.
+ * @return Stały napis.
+ */
+const char *describeSearchEngine(SearchEngine engine);
+
+/**
+ * @brief Tworzy pustą pamięć roboczą szukania dróg.
+ * Tablice są przydzielane przy pierwszym szukaniu i rosną razem z liczbą miast.
+ * @return Wskaźnik na pamięć roboczą lub @p NULL gdy brak pamięci.
+ */
+SearchWorkspace *initSearchWorkspace(void);
+
+/**
+ * @brief Usuwa pamięć roboczą szukania dróg.
+ * Jeśli pamięć robocza to @p NULL nic nie robi.
+ * @param[in,out] workspace - wskaźnik na pamięć roboczą.
+ */
+void deleteSearchWorkspace(SearchWorkspace *workspace);
+
 /**
  * @brief Szuka drogi pomiędzy dwoma miastami.
  * Dla danej mapy i miast końcowych szuka najbardziej optymalnej drogi.
  * Nie przechodzi przez miasta, które są końcem jakiejś użytej drogi.
+ * Korzysta z pamięci roboczej mapy, więc dla jednej mapy nie może działać w kilku wątkach naraz.
+ * Czas działania zależy od liczby odwiedzonych miast, a nie od liczby wszystkich miast.
  * @param[in] map   - wskaźnik na strukturę przechowującą mapę dróg;
  * @param[in] city1 - wskaźnik na pierwsze miasto;
  * @param[in] city2 - wskaźnik na drugie miasto;
@@ -5,126 +5,580 @@
  * @date 05.06.2019
  */
 
-#define _GNU_SOURCE
-
 #include "map_graph.h"
 #include "map_types.h"
+#include "road_index.h"
 
-#include "utility.h"
+#include "slab.h"
+#include "page_memory.h"
 
 #include <string.h>
 
 
+/* Stałe. */
+
+/** Liczba klas bloków odcinków, wystarcza na dowolną liczbę odcinków mieszczącą się w pamięci. */
+#define ROAD_BLOCK_CLASS_COUNT 48
+
+/** Początkowa liczba miejsc w tablicy miast. */
+static const size_t INITIAL_CITY_TABLE_SIZE = 64;
+/** Numer miejsca odcinka, który nie jest w tablicy odcinków danego końca. */
+static const uint32_t NO_ROAD_SLOT = UINT32_MAX;
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca miejsca odcinka w tablicach odcinków jego końców. */
+typedef struct RoadSlotsStruct RoadSlots;
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje miejsca odcinka w tablicach odcinków jego końców. */
+struct RoadSlotsStruct {
+    /** Numer odcinka w tablicy odcinków pierwszego końca. */
+    uint32_t end1Slot;
+    /** Numer odcinka w tablicy odcinków drugiego końca. */
+    uint32_t end2Slot;
+};
+
+/** Przechowuje przydzielacze wszystkich obiektów grafu. */
+struct GraphMemoryStruct {
+    /** Przydzielacz miast. */
+    SlabAllocator *cities;
+    /** Przydzielacz odcinków. */
+    SlabAllocator *roads;
+    /**
+     * Przydzielacze bloków odcinków miast, blok klasy @p k mieści
+     * @ref INLINE_ROAD_COUNT * 2^(k+1) numerów odcinków. Tworzone przy pierwszym użyciu.
+     */
+    SlabAllocator *roadBlocks[ROAD_BLOCK_CLASS_COUNT];
+    /** Tablica miast według id w bloku z @ref allocateStoragePages, @p NULL dla wolnych id. */
+    City **cityTable;
+    /** Tablica nazw miast według id, równoległa do tablicy miast. */
+    CityName *cityNames;
+    /** Liczba miejsc w tablicy miast i w tablicy nazw. */
+    size_t cityTableSize;
+    /**
+     * Tablica miejsc odcinków w tablicach ich końców według numerów miejsc odcinków
+     * w przydzielaczu, trzymana osobno, żeby odcinek zajmował 16 bajtów.
+     */
+    RoadSlots *roadSlots;
+    /** Liczba miejsc w tablicy miejsc odcinków. */
+    size_t roadSlotTableSize;
+};
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Wyznacza klasę bloku odcinków o danej pojemności.
+ * @param[in] space - liczba miejsc w bloku, większa od @ref INLINE_ROAD_COUNT.
+ * @return Klasa bloku.
+ */
+static size_t roadBlockClass(size_t space);
+
+/**
+ * @brief Przydziela blok odcinków.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] space      - liczba miejsc w bloku, większa od @ref INLINE_ROAD_COUNT.
+ * @return Wskaźnik na blok lub @p NULL gdy brak pamięci.
+ */
+static uint32_t *allocateRoadBlock(GraphMemory *memory, size_t space);
+
+/**
+ * @brief Zwraca blok odcinków do pamięci grafu.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in,out] block  - wskaźnik na blok;
+ * @param[in] space      - liczba miejsc w bloku.
+ */
+static void freeRoadBlock(GraphMemory *memory, uint32_t *block, size_t space);
+
+/**
+ * @brief Udostępnia numer miejsca odcinka w tablicy odcinków jego końca.
+ * @param[in] memory - pamięć grafu, z której pochodzi odcinek;
+ * @param[in] number - numer odcinka;
+ * @param[in] city   - wskaźnik na koniec odcinka.
+ * @return Wskaźnik na pole z numerem miejsca.
+ */
+static uint32_t *roadSlotIn(const GraphMemory *memory, uint32_t number, const City *city);
+
+/**
+ * @brief Przenosi tablicę do większego bloku danych grafu.
+ * Nowy blok jest przydzielany przez @ref allocateStoragePages, a stary zwalniany.
+ * @param[in,out] array - wskaźnik na stary blok lub @p NULL;
+ * @param[in] oldSize   - rozmiar starego bloku w bajtach;
+ * @param[in] newSize   - rozmiar nowego bloku w bajtach, nie mniejszy od starego.
+ * @return Wskaźnik na nowy blok, wyzerowany za skopiowaną częścią, lub @p NULL
+ * gdy brak pamięci, wtedy stary blok jest bez zmian.
+ */
+static void *growStorageArray(void *array, size_t oldSize, size_t newSize);
+
+/**
+ * @brief Zapewnia miejsce w tablicy miejsc odcinków na odcinek o danym numerze miejsca.
+ * Tablica rośnie do ograniczenia numerów w przydzielaczu odcinków, co najmniej dwukrotnie.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] number     - numer miejsca odcinka w przydzielaczu.
+ * @return @p true lub @p false w zależności od powodzenia alokacji.
+ */
+static bool reserveRoadSlots(GraphMemory *memory, size_t number);
+
+/**
+ * @brief Zapewnia miejsce w tablicy miast i w tablicy nazw na dane id.
+ * Tablica rośnie co najmniej dwukrotnie, nowe miejsca są puste.
+ * Gdy brak pamięci, obie tablice są bez zmian.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] id         - id miasta.
+ * @return @p true lub @p false w zależności od powodzenia alokacji.
+ */
+static bool reserveCityId(GraphMemory *memory, uint32_t id);
+
+/**
+ * @brief Udostępnia przydzielacz obiektów danego rodzaju.
+ * @param[in] memory - pamięć grafu;
+ * @param[in] kind   - rodzaj obiektów.
+ * @return Wskaźnik na przydzielacz.
+ */
+static SlabAllocator *slabOfKind(const GraphMemory *memory, GraphObjectKind kind);
+
+/**
+ * @brief Znajduje miasto, do którego należy blok odcinków.
+ * @param[in] memory - pamięć grafu;
+ * @param[in] block  - wskaźnik na blok odcinków, używany przez jakieś miasto.
+ * @return Wskaźnik na miasto.
+ */
+static City *ownerOfRoadBlock(const GraphMemory *memory, const uint32_t *block);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static size_t roadBlockClass(size_t space) {
+    size_t blockClass = 0;
+    while ((size_t) INLINE_ROAD_COUNT << (blockClass + 1) < space) {
+        blockClass++;
+    }
+    return blockClass;
+}
+
+static uint32_t *allocateRoadBlock(GraphMemory *memory, size_t space) {
+    size_t blockClass = roadBlockClass(space);
+    if (blockClass >= ROAD_BLOCK_CLASS_COUNT) {
+        return NULL;
+    }
+
+    if (memory->roadBlocks[blockClass] == NULL) {
+        memory->roadBlocks[blockClass] = initSlabAllocator(sizeof(uint32_t) * space);
+    }
+    return allocateFromSlab(memory->roadBlocks[blockClass]);
+}
+
+static void freeRoadBlock(GraphMemory *memory, uint32_t *block, size_t space) {
+    freeToSlab(memory->roadBlocks[roadBlockClass(space)], block);
+}
+
+static uint32_t *roadSlotIn(const GraphMemory *memory, uint32_t number, const City *city) {
+    RoadSlots *slots = &memory->roadSlots[number];
+    return roadOfNumber(memory, number)->end1Id == city->id ? &slots->end1Slot : &slots->end2Slot;
+}
+
+static void *growStorageArray(void *array, size_t oldSize, size_t newSize) {
+    void *newArray = allocateStoragePages(newSize);
+    if (newArray == NULL) {
+        return NULL;
+    }
+
+    if (oldSize > 0) {
+        memcpy(newArray, array, oldSize);
+    }
+    freeStoragePages(array, oldSize);
+    return newArray;
+}
+
+static bool reserveRoadSlots(GraphMemory *memory, size_t number) {
+    if (number < memory->roadSlotTableSize) {
+        return true;
+    }
+
+    size_t newSize = objectNumberLimit(memory->roads);
+    if (newSize < memory->roadSlotTableSize * 2) {
+        newSize = memory->roadSlotTableSize * 2;
+    }
+    RoadSlots *newSlots = growStorageArray(memory->roadSlots, sizeof(RoadSlots) * memory->roadSlotTableSize,
+                                           sizeof(RoadSlots) * newSize);
+    if (newSlots == NULL) {
+        return false;
+    }
+    memory->roadSlots = newSlots;
+    memory->roadSlotTableSize = newSize;
+    return true;
+}
+
+static bool reserveCityId(GraphMemory *memory, uint32_t id) {
+    if (id < memory->cityTableSize) {
+        return true;
+    }
+
+    size_t newSize = memory->cityTableSize == 0 ? INITIAL_CITY_TABLE_SIZE : memory->cityTableSize * 2;
+    if (newSize <= id) {
+        newSize = (size_t) id + 1;
+    }
+    /* Nowe bloki są wyzerowane, więc nowe miejsca w tablicy miast są puste. */
+    City **newTable = allocateStoragePages(sizeof(City *) * newSize);
+    CityName *newNames = allocateStoragePages(sizeof(CityName) * newSize);
+    if (newTable == NULL || newNames == NULL) {
+        freeStoragePages(newTable, sizeof(City *) * newSize);
+        freeStoragePages(newNames, sizeof(CityName) * newSize);
+        return false;
+    }
+
+    if (memory->cityTableSize > 0) {
+        memcpy(newTable, memory->cityTable, sizeof(City *) * memory->cityTableSize);
+        memcpy(newNames, memory->cityNames, sizeof(CityName) * memory->cityTableSize);
+    }
+    freeStoragePages(memory->cityTable, sizeof(City *) * memory->cityTableSize);
+    freeStoragePages(memory->cityNames, sizeof(CityName) * memory->cityTableSize);
+    memory->cityTable = newTable;
+    memory->cityNames = newNames;
+    memory->cityTableSize = newSize;
+    return true;
+}
+
+static SlabAllocator *slabOfKind(const GraphMemory *memory, GraphObjectKind kind) {
+    return kind == GRAPH_CITIES ? memory->cities : memory->roads;
+}
+
+static City *ownerOfRoadBlock(const GraphMemory *memory, const uint32_t *block) {
+    /* Miasto z blokiem ma co najmniej jeden odcinek, więc to jeden z jego końców. */
+    const Road *road = roadOfNumber(memory, block[0]);
+    City *city = memory->cityTable[road->end1Id];
+    if (city->roadSpace > INLINE_ROAD_COUNT && city->roads.heapRoads == block) {
+        return city;
+    }
+    return memory->cityTable[road->end2Id];
+}
+
+
 /* Funkcje z interfejsu. */
 
-Road *initRoad(int builtYear, unsigned length, City *end1, City *end2) {
-    Road *road = malloc(sizeof(Road));
+GraphMemory *initGraphMemory(void) {
+    GraphMemory *memory = malloc(sizeof(GraphMemory));
+    if (memory == NULL) {
+        return NULL;
+    }
+
+    memory->cities = initSlabAllocator(sizeof(City));
+    memory->roads = initSlabAllocator(sizeof(Road));
+    for (size_t i = 0; i < ROAD_BLOCK_CLASS_COUNT; i++) {
+        memory->roadBlocks[i] = NULL;
+    }
+    memory->cityTable = NULL;
+    memory->cityNames = NULL;
+    memory->cityTableSize = 0;
+    memory->roadSlots = NULL;
+    memory->roadSlotTableSize = 0;
+
+    if (memory->cities == NULL || memory->roads == NULL) {
+        deleteGraphMemory(memory);
+        return NULL;
+    }
+    return memory;
+}
+
+void deleteGraphMemory(GraphMemory *memory) {
+    if (memory == NULL) {
+        return;
+    }
+
+    deleteSlabAllocator(memory->cities);
+    deleteSlabAllocator(memory->roads);
+    for (size_t i = 0; i < ROAD_BLOCK_CLASS_COUNT; i++) {
+        deleteSlabAllocator(memory->roadBlocks[i]);
+    }
+    freeStoragePages(memory->cityTable, sizeof(City *) * memory->cityTableSize);
+    freeStoragePages(memory->cityNames, sizeof(CityName) * memory->cityTableSize);
+    freeStoragePages(memory->roadSlots, sizeof(RoadSlots) * memory->roadSlotTableSize);
+    free(memory);
+}
+
+Road *initRoad(GraphMemory *memory, int builtYear, unsigned length, City *end1, City *end2) {
+    Road *road = allocateFromSlab(memory->roads);
     if (road == NULL) {
         return NULL;
     }
 
+    size_t number = objectNumberInSlab(memory->roads, road);
+    if (number >= NO_ROAD_NUMBER || !reserveRoadSlots(memory, number)) {
+        freeToSlab(memory->roads, road);
+        return NULL;
+    }
+
     road->lastRepaired = builtYear;
     road->length = length;
-    road->end1 = end1;
-    road->end2 = end2;
+    road->end1Id = end1->id;
+    road->end2Id = end2->id;
+    memory->roadSlots[number].end1Slot = NO_ROAD_SLOT;
+    memory->roadSlots[number].end2Slot = NO_ROAD_SLOT;
     return road;
 }
 
-void deleteRoad(void *roadVoid) {
-    Road *road = roadVoid;
-    if (road == NULL) {
-        return;
+void deleteRoad(GraphMemory *memory, Road *road) {
+    freeToSlab(memory->roads, road);
+}
+
+City *initCity(GraphMemory *memory, const char *name, size_t nameLength, uint32_t id) {
+    if (id == NO_CITY_ID || !reserveCityId(memory, id)) {
+        return NULL;
+    }
+
+    City *city = allocateFromSlab(memory->cities);
+    if (city == NULL) {
+        return NULL;
     }
 
-    free(road);
+    city->id = id;
+    city->roadCount = 0;
+    city->roadSpace = INLINE_ROAD_COUNT;
+    memory->cityTable[id] = city;
+    memory->cityNames[id].text = name;
+    memory->cityNames[id].length = nameLength;
+    return city;
 }
 
-void deleteRoadHalfway(void *roadVoid) {
-    Road *road = roadVoid;
-    if (road == NULL) {
+void deleteCity(GraphMemory *memory, City *city) {
+    if (city == NULL) {
         return;
     }
 
-    /* Droga musi być usunięta z obu końców i nie ma roku 0,
-     * więc rok naprawy 0 oznacza zablokowanie, droga usunięta z jednego końca jest blokowana. */
-    if (road->lastRepaired == 0) {
-        deleteRoad(road);
-    } else {
-        road->lastRepaired = 0;
+    if (city->roadSpace > INLINE_ROAD_COUNT) {
+        freeRoadBlock(memory, city->roads.heapRoads, city->roadSpace);
     }
+    memory->cityTable[city->id] = NULL;
+    freeToSlab(memory->cities, city);
 }
 
-City *initCity(const char *name, size_t id) {
-    City *city = malloc(sizeof(City));
-    FAIL_IF(city == NULL);
-
-    if (name != NULL) {
-        city->name = strdup(name);
-    } else {
-        city->name = NULL;
+City *cityOfId(const GraphMemory *memory, uint32_t id) {
+    if (memory == NULL || id >= memory->cityTableSize) {
+        return NULL;
     }
-    city->roads = initVector();
-    city->id = id;
+    return memory->cityTable[id];
+}
 
-    FAIL_IF(city->name == NULL || city->roads == NULL);
+CityName nameOfCity(const GraphMemory *memory, const City *city) {
+    return memory->cityNames[city->id];
+}
 
-    return city;
+void setNameOfCity(GraphMemory *memory, const City *city, const char *name, size_t nameLength) {
+    memory->cityNames[city->id].text = name;
+    memory->cityNames[city->id].length = nameLength;
+}
+
+bool addRoadToCity(GraphMemory *memory, City *city, Road *road) {
+    if (city == NULL || road == NULL) {
+        return false;
+    }
 
-    FAILURE:
+    if (city->roadCount == city->roadSpace) {
+        /* Odcinki są przenoszone do dwukrotnie większego bloku. */
+        if (city->roadSpace > UINT32_MAX / 2) {
+            return false;
+        }
+        uint32_t newSpace = city->roadSpace * 2;
+        uint32_t *newRoads = allocateRoadBlock(memory, newSpace);
+        if (newRoads == NULL) {
+            return false;
+        }
+
+        memcpy(newRoads, roadNumbersOfCity(city), sizeof(uint32_t) * city->roadCount);
+        if (city->roadSpace > INLINE_ROAD_COUNT) {
+            freeRoadBlock(memory, city->roads.heapRoads, city->roadSpace);
+        }
+        city->roads.heapRoads = newRoads;
+        city->roadSpace = newSpace;
+    }
 
-    deleteCity(city);
-    return NULL;
+    uint32_t number = numberOfRoad(memory, road);
+    uint32_t *roads = (uint32_t *) roadNumbersOfCity(city);
+    *roadSlotIn(memory, number, city) = city->roadCount;
+    roads[city->roadCount++] = number;
+    return true;
 }
 
-void deleteCity(void *cityVoid) {
-    City *city = cityVoid;
-    if (city == NULL) {
+void removeRoadFromCity(GraphMemory *memory, City *city, Road *road) {
+    if (city == NULL || road == NULL) {
         return;
     }
 
-    free(city->name);
-    deleteVector(city->roads, deleteRoadHalfway);
-    free(city);
+    /* Odcinek, którego nie udało się dodać do miasta, ma numer miejsca NO_ROAD_SLOT. */
+    uint32_t number = numberOfRoad(memory, road);
+    uint32_t *roads = (uint32_t *) roadNumbersOfCity(city);
+    uint32_t *slot = roadSlotIn(memory, number, city);
+    if (*slot >= city->roadCount || roads[*slot] != number) {
+        return;
+    }
+
+    uint32_t last = roads[--city->roadCount];
+    roads[*slot] = last;
+    *roadSlotIn(memory, last, city) = *slot;
+    *slot = NO_ROAD_SLOT;
+
+    /* Gdy odcinków zostaje mało, wracają do miasta, z zapasem żeby nie przenosić ich co chwilę. */
+    if (city->roadSpace > INLINE_ROAD_COUNT && city->roadCount <= INLINE_ROAD_COUNT / 2) {
+        uint32_t *heapRoads = city->roads.heapRoads;
+        memcpy(city->roads.inlineRoads, heapRoads, sizeof(uint32_t) * city->roadCount);
+        freeRoadBlock(memory, heapRoads, city->roadSpace);
+        city->roadSpace = INLINE_ROAD_COUNT;
+    }
+}
+
+const uint32_t *roadNumbersOfCity(const City *city) {
+    if (city->roadSpace == INLINE_ROAD_COUNT) {
+        return city->roads.inlineRoads;
+    }
+    return city->roads.heapRoads;
+}
+
+Road *roadOfNumber(const GraphMemory *memory, uint32_t number) {
+    return objectOfNumberInSlab(memory->roads, number);
+}
+
+uint32_t numberOfRoad(const GraphMemory *memory, const Road *road) {
+    return (uint32_t) objectNumberInSlab(memory->roads, road);
 }
 
-City *otherRoadEnd(const Road *road, const City *end) {
+uint32_t otherRoadEndId(const Road *road, uint32_t endId) {
     if (road == NULL || road->lastRepaired == 0) {
-        return NULL;
+        return NO_CITY_ID;
     }
 
-    if (road->end1 == end) {
-        return road->end2;
+    if (road->end1Id == endId) {
+        return road->end2Id;
     }
-    if (road->end2 == end) {
-        return road->end1;
+    if (road->end2Id == endId) {
+        return road->end1Id;
     }
-    return NULL;
+    return NO_CITY_ID;
 }
 
-Road *findRoad(const City *city1, const City *city2) {
-    if (city1 == NULL || city2 == NULL) {
+City *otherRoadEnd(const GraphMemory *memory, const Road *road, const City *end) {
+    if (end == NULL) {
         return NULL;
     }
+    return cityOfId(memory, otherRoadEndId(road, end->id));
+}
+
+Road *findRoad(const RoadIndex *roadIndex, const City *city1, const City *city2) {
+    Road *road = findInRoadIndex(roadIndex, city1, city2);
+    if (road == NULL || road->lastRepaired == 0) {
+        return NULL;
+    }
+    return road;
+}
+
+void shrinkRoadsOfCity(GraphMemory *memory, City *city) {
+    if (city == NULL || city->roadSpace == INLINE_ROAD_COUNT) {
+        return;
+    }
 
-    size_t len = sizeOfVector(city1->roads);
+    uint32_t *heapRoads = city->roads.heapRoads;
+    if (city->roadCount <= INLINE_ROAD_COUNT) {
+        memcpy(city->roads.inlineRoads, heapRoads, sizeof(uint32_t) * city->roadCount);
+        freeRoadBlock(memory, heapRoads, city->roadSpace);
+        city->roadSpace = INLINE_ROAD_COUNT;
+        return;
+    }
 
-    /* Dla wydajności zamieniane są miasta jeśli z drugiego wychodzi mniej odcinków. */
-    {
-        size_t len2 = sizeOfVector(city2->roads);
-        if (len > len2) {
-            const City *tmp = city1;
-            city1 = city2;
-            city2 = tmp;
-            len = len2;
+    uint32_t newSpace = INLINE_ROAD_COUNT * 2;
+    while (newSpace < city->roadCount) {
+        newSpace *= 2;
+    }
+    if (newSpace == city->roadSpace) {
+        return;
+    }
+
+    uint32_t *newRoads = allocateRoadBlock(memory, newSpace);
+    if (newRoads == NULL) {
+        return;
+    }
+    memcpy(newRoads, heapRoads, sizeof(uint32_t) * city->roadCount);
+    freeRoadBlock(memory, heapRoads, city->roadSpace);
+    city->roads.heapRoads = newRoads;
+    city->roadSpace = newSpace;
+}
+
+bool compactRoadBlocks(GraphMemory *memory) {
+    for (size_t blockClass = 0; blockClass < ROAD_BLOCK_CLASS_COUNT; blockClass++) {
+        SlabAllocator *slab = memory->roadBlocks[blockClass];
+        if (!beginSlabEvacuation(slab)) {
+            continue;
+        }
+
+        uint32_t *block;
+        while ((block = nextEvacuatedObject(slab)) != NULL) {
+            City *city = ownerOfRoadBlock(memory, block);
+            uint32_t *newBlock = allocateFromSlab(slab);
+            if (newBlock == NULL) {
+                break;
+            }
+            memcpy(newBlock, block, sizeof(uint32_t) * city->roadCount);
+            city->roads.heapRoads = newBlock;
+            markObjectMoved(slab, block, newBlock);
         }
+        return finishSlabEvacuation(slab);
     }
+    return false;
+}
 
-    Road *road = NULL;
-    Road **roads = (Road **) storageBlockOfVector(city1->roads);
-    for (size_t i = 0; i < len && road == NULL; i++) {
-        if (city2 == otherRoadEnd(roads[i], city1)) {
-            road = roads[i];
+bool beginGraphEvacuation(GraphMemory *memory, GraphObjectKind kind) {
+    return beginSlabEvacuation(slabOfKind(memory, kind));
+}
+
+void *evacuateNextObject(GraphMemory *memory, GraphObjectKind kind, void **oldObject) {
+    SlabAllocator *slab = slabOfKind(memory, kind);
+    void *object = nextEvacuatedObject(slab);
+    void *newObject = object == NULL ? NULL : allocateFromSlab(slab);
+    if (newObject == NULL) {
+        return NULL;
+    }
+    if (kind == GRAPH_ROADS && (objectNumberInSlab(slab, newObject) >= NO_ROAD_NUMBER ||
+                                !reserveRoadSlots(memory, objectNumberInSlab(slab, newObject)))) {
+        freeToSlab(slab, newObject);
+        return NULL;
+    }
+
+    if (kind == GRAPH_CITIES) {
+        City *city = newObject;
+        *city = *(City *) object;
+        memory->cityTable[city->id] = city;
+    } else {
+        Road *road = newObject;
+        *road = *(Road *) object;
+        uint32_t oldNumber = numberOfRoad(memory, object);
+        uint32_t number = numberOfRoad(memory, road);
+        RoadSlots slots = memory->roadSlots[oldNumber];
+        memory->roadSlots[number] = slots;
+        /* Odcinek, którego nie ma w tablicy danego końca, ma tam numer miejsca NO_ROAD_SLOT. */
+        City *end1 = memory->cityTable[road->end1Id];
+        City *end2 = memory->cityTable[road->end2Id];
+        if (slots.end1Slot < end1->roadCount && roadNumbersOfCity(end1)[slots.end1Slot] == oldNumber) {
+            ((uint32_t *) roadNumbersOfCity(end1))[slots.end1Slot] = number;
+        }
+        if (slots.end2Slot < end2->roadCount && roadNumbersOfCity(end2)[slots.end2Slot] == oldNumber) {
+            ((uint32_t *) roadNumbersOfCity(end2))[slots.end2Slot] = number;
         }
     }
-    return road;
+    markObjectMoved(slab, object, newObject);
+    *oldObject = object;
+    return newObject;
+}
+
+City *relocatedCity(const GraphMemory *memory, City *city) {
+    return forwardedObject(memory->cities, city);
+}
+
+Road *relocatedRoad(const GraphMemory *memory, Road *road) {
+    return forwardedObject(memory->roads, road);
+}
+
+bool finishGraphEvacuation(GraphMemory *memory, GraphObjectKind kind) {
+    return finishSlabEvacuation(slabOfKind(memory, kind));
 }
@@ -10,66 +10,247 @@
 
 #include "map_types.h"
 
+/**
+ * Typ wyliczeniowy określający rodzaj obiektów grafu przenoszonych przy porządkowaniu pamięci.
+ */
+enum GraphObjectKindEnum {
+    /** Miasta. */
+            GRAPH_CITIES,
+    /** Odcinki drogowe. */
+            GRAPH_ROADS
+};
+
+/**
+ * Typ określający rodzaj obiektów grafu przenoszonych przy porządkowaniu pamięci.
+ */
+typedef enum GraphObjectKindEnum GraphObjectKind;
+
+/**
+ * @brief Tworzy pamięć grafu.
+ * Pamięć grafu przydziela miasta, odcinki i bloki odcinków miast
+ * z dużych bloków, a przy usuwaniu zwalnia je wszystkie naraz.
+ * Trzyma też tablicę miast według id, przez którą są rozwiązywane końce odcinków,
+ * i osobną tablicę nazw miast według id.
+ * @return Wskaźnik na pamięć grafu albo @p NULL jeśli zabrakło pamięci.
+ */
+GraphMemory *initGraphMemory(void);
+
+/**
+ * @brief Usuwa pamięć grafu razem ze wszystkimi miastami i odcinkami z niej przydzielonymi.
+ * Nie przegląda pojedynczych miast ani odcinków. Jeśli pamięć to @p NULL nic nie robi.
+ * @param[in,out] memory - wskaźnik na pamięć grafu.
+ */
+void deleteGraphMemory(GraphMemory *memory);
+
 /**
  * @brief Tworzy nową drogę.
- * @param[in] builtYear - rok budowy drogi;
- * @param[in] length    - długość drogi;
- * @param[in] end1      - jeden koniec drogi;
- * @param[in] end2      - drogi koniec drogi.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] builtYear  - rok budowy drogi;
+ * @param[in] length     - długość drogi;
+ * @param[in] end1       - jeden koniec drogi;
+ * @param[in] end2       - drogi koniec drogi.
  * @return Wskaźnik na nową drogą albo @p NULL jeśli zabrakło pamięci.
  */
-Road *initRoad(int builtYear, unsigned length, City *end1, City *end2);
+Road *initRoad(GraphMemory *memory, int builtYear, unsigned length, City *end1, City *end2);
 
 /**
  * @brief Usuwa drogę z pamięci.
- * Przyjmuje (void *) dla zgodności z generycznymi modułami.
- * @param[in,out] roadVoid - wskaźnik na drogę do usunięcia.
+ * Jeśli droga to @p NULL nic nie robi.
+ * @param[in,out] memory - pamięć grafu, z której pochodzi droga;
+ * @param[in,out] road   - wskaźnik na drogę do usunięcia.
+ */
+void deleteRoad(GraphMemory *memory, Road *road);
+
+/**
+ * @brief Tworzy nowe miasto i zapisuje je w tablicy miast pod danym id.
+ * Nie kopiuje nazwy miasta, napis musi istnieć dłużej niż miasto.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] name       - nazwa miasta;
+ * @param[in] nameLength - długość nazwy miasta;
+ * @param[in] id         - wolne id miasta, mniejsze od @ref NO_CITY_ID.
+ * @return Wskaźnik na nowe miasto albo @p NULL jeśli zabrakło pamięci lub id jest niepoprawne.
  */
-void deleteRoad(void *roadVoid);
+City *initCity(GraphMemory *memory, const char *name, size_t nameLength, uint32_t id);
 
 /**
- * @brief Usuwa drogę w połowie.
- * Jeśli droga jest w zablokowanym stanie to ją usuwa,
- * a jeśli nie jest to ją blokuje.
- * Przyjmuje (void *) dla zgodności z generycznymi modułami.
- * @param[in,out] roadVoid - wskaźnik na drogę do usunięcia.
+ * @brief Usuwa miasto z pamięci i zwalnia jego id w tablicy miast.
+ * Nie usuwa nazwy miasta, bo należy ona do słownika miast, ani odcinków miasta,
+ * które powinny zostać usunięte wcześniej. Jeśli miasto to @p NULL nic nie robi.
+ * @param[in,out] memory - pamięć grafu, z której pochodzi miasto;
+ * @param[in,out] city   - wskaźnik na miasto do usunięcia.
  */
-void deleteRoadHalfway(void *roadVoid);
+void deleteCity(GraphMemory *memory, City *city);
 
 /**
- * @brief Tworzy nowe miasto.
- * Kopiuje przy tym nazwę miasta.
- * @param[in] name - nazwa miasta;
- * @param[in] id   - indeks miasta.
- * @return Wskaźnik na nowe miasto albo @p NULL jeśli zabrakło pamięci.
+ * @brief Udostępnia miasto o danym id.
+ * @param[in] memory - pamięć grafu;
+ * @param[in] id     - id miasta.
+ * @return Wskaźnik na miasto lub @p NULL jeśli nie ma miasta o takim id.
  */
-City *initCity(const char *name, size_t id);
+City *cityOfId(const GraphMemory *memory, uint32_t id);
 
 /**
- * @brief Usuwa miasto z pamięci.
- * Przyjmuje (void *) dla zgodności z generycznymi modułami.
- * @param[in,out] cityVoid - wskaźnik na miasto do usunięcia.
+ * @brief Udostępnia nazwę miasta.
+ * @param[in] memory - pamięć grafu, z której pochodzi miasto;
+ * @param[in] city   - wskaźnik na miasto.
+ * @return Nazwa miasta.
  */
-void deleteCity(void *cityVoid);
+CityName nameOfCity(const GraphMemory *memory, const City *city);
+
+/**
+ * @brief Zmienia napis nazwy miasta, np. gdy nazwy zostały skopiowane do nowego słownika.
+ * Nie kopiuje nazwy miasta, napis musi istnieć dłużej niż miasto.
+ * @param[in,out] memory - pamięć grafu, z której pochodzi miasto;
+ * @param[in] city       - wskaźnik na miasto;
+ * @param[in] name       - nazwa miasta;
+ * @param[in] nameLength - długość nazwy miasta.
+ */
+void setNameOfCity(GraphMemory *memory, const City *city, const char *name, size_t nameLength);
+
+/**
+ * @brief Dodaje odcinek do odcinków wychodzących z miasta.
+ * Dopóki odcinków jest niewiele, są one przechowywane w samym mieście,
+ * a dopiero potem w osobnym bloku z pamięci grafu.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in,out] city   - wskaźnik na miasto;
+ * @param[in] road       - wskaźnik na odcinek.
+ * @return @p true lub @p false w zależności od powodzenia alokacji.
+ */
+bool addRoadToCity(GraphMemory *memory, City *city, Road *road);
+
+/**
+ * @brief Usuwa odcinek z odcinków wychodzących z miasta.
+ * Na miejsce odcinka wstawia ostatni odcinek i poprawia zapisany w nim numer miejsca,
+ * więc działa w czasie stałym. Jeśli odcinka nie ma w mieście nic nie robi.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in,out] city   - wskaźnik na miasto;
+ * @param[in] road       - wskaźnik na odcinek.
+ */
+void removeRoadFromCity(GraphMemory *memory, City *city, Road *road);
+
+/**
+ * @brief Udostępnia tablicę numerów odcinków wychodzących z miasta.
+ * Tablica ma @p city->roadCount elementów i jest ważna do następnej zmiany odcinków miasta.
+ * Odcinki o tych numerach udostępnia @ref roadOfNumber.
+ * @param[in] city - wskaźnik na miasto.
+ * @return Wskaźnik na tablicę numerów odcinków.
+ */
+const uint32_t *roadNumbersOfCity(const City *city);
+
+/**
+ * @brief Udostępnia odcinek o danym numerze.
+ * Działa w czasie stałym. Numer odcinka zmienia się tylko przy jego przeniesieniu
+ * przez @ref evacuateNextObject.
+ * @param[in] memory - pamięć grafu, z której pochodzi odcinek;
+ * @param[in] number - numer istniejącego odcinka, mniejszy od @ref NO_ROAD_NUMBER.
+ * @return Wskaźnik na odcinek.
+ */
+Road *roadOfNumber(const GraphMemory *memory, uint32_t number);
+
+/**
+ * @brief Wyznacza numer odcinka.
+ * Szuka bloku pamięci odcinka, więc działa w czasie logarytmicznym od liczby bloków.
+ * @param[in] memory - pamięć grafu, z której pochodzi odcinek;
+ * @param[in] road   - wskaźnik na odcinek.
+ * @return Numer odcinka, mniejszy od @ref NO_ROAD_NUMBER.
+ */
+uint32_t numberOfRoad(const GraphMemory *memory, const Road *road);
+
+/**
+ * @brief Znajduje id drugiego końca drogi.
+ * @param[in] road  - droga;
+ * @param[in] endId - id pierwszego końca.
+ * @return Id drugiego końca drogi, chyba że droga jest zablokowana,
+ * nie istnieje lub @p endId nie jest id jej końca, wtedy zwraca @ref NO_CITY_ID.
+ */
+uint32_t otherRoadEndId(const Road *road, uint32_t endId);
 
 /**
  * @brief Znajduje drugi koniec drogi.
  * Dla podanej drogi i miasta znajduje drugi koniec drogi.
- * @param[in] road - drugi koniec;
- * @param[in] end  - pierwszy koniec.
+ * @param[in] memory - pamięć grafu, w której są miasta;
+ * @param[in] road   - droga;
+ * @param[in] end    - pierwszy koniec.
  * @return Wskaźnik na drugi koniec drogi, chyba że droga jest zablokowana,
  * nie istnieje lub @p end nie jest jej końcem, wtedy zwraca @p NULL.
  */
-City *otherRoadEnd(const Road *road, const City *end);
+City *otherRoadEnd(const GraphMemory *memory, const Road *road, const City *end);
 
 /**
  * @brief znajduje drogę pomiędzy miastami.
  * Dla danych dwóch miast znajduje drogę, która je łączy (i nie jest zablokowana).
- * Jeśli jest wiele takich dróg zwraca dowolną.
- * @param[in] city1 - jeden koniec drogi;
- * @param[in] city2 - drugi koniec drogi.
+ * Korzysta z indeksu odcinków, więc nie zależy od liczby dróg wychodzących z miast.
+ * @param[in] roadIndex - indeks odcinków mapy;
+ * @param[in] city1     - jeden koniec drogi;
+ * @param[in] city2     - drugi koniec drogi.
  * @return Wskaźnik na drogę lub @p NULL jeśli takiej nie ma.
  */
-Road *findRoad(const City *city1, const City *city2);
+Road *findRoad(const RoadIndex *roadIndex, const City *city1, const City *city2);
+
+/**
+ * @brief Dopasowuje miejsce na odcinki miasta do ich liczby.
+ * Odcinki są przenoszone do najmniejszego bloku, w którym się mieszczą,
+ * albo z powrotem do miasta. Gdy brak pamięci zostawia je na miejscu.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in,out] city   - wskaźnik na miasto.
+ */
+void shrinkRoadsOfCity(GraphMemory *memory, City *city);
+
+/**
+ * @brief Opróżnia jeden rzadko zajęty blok pamięci bloków odcinków miast.
+ * Bloki odcinków są wskazywane tylko przez swoje miasta, więc nie trzeba
+ * niczego poprawiać poza grafem.
+ * @param[in,out] memory - pamięć grafu.
+ * @return @p true jeśli blok pamięci został zwrócony do systemu, @p false gdy
+ * żaden blok się nie nadaje lub brak pamięci.
+ */
+bool compactRoadBlocks(GraphMemory *memory);
+
+/**
+ * @brief Rozpoczyna opróżnianie rzadko zajętego bloku pamięci miast lub odcinków.
+ * Kolejne obiekty bloku przenosi @ref evacuateNextObject. Do zakończenia przez
+ * @ref finishGraphEvacuation nie wolno zmieniać grafu, a wskaźniki spoza grafu
+ * należy poprawić przez @ref relocatedCity i @ref relocatedRoad.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] kind       - rodzaj obiektów.
+ * @return @p true jeśli blok został wybrany, @p false gdy żaden się nie nadaje.
+ */
+bool beginGraphEvacuation(GraphMemory *memory, GraphObjectKind kind);
+
+/**
+ * @brief Przenosi kolejny obiekt opróżnianego bloku.
+ * Poprawia odwołania wewnątrz grafu, czyli tablicę miast i tablice odcinków miast.
+ * Przeniesiony odcinek dostaje nowy numer (@ref numberOfRoad).
+ * @param[in,out] memory     - pamięć grafu;
+ * @param[in] kind           - rodzaj obiektów;
+ * @param[out] oldObject     - wskaźnik na miejsce na stary adres obiektu.
+ * @return Nowy adres obiektu lub @p NULL gdy nie ma więcej obiektów lub brak pamięci.
+ */
+void *evacuateNextObject(GraphMemory *memory, GraphObjectKind kind, void **oldObject);
+
+/**
+ * @brief Wyznacza aktualne miejsce miasta w czasie opróżniania bloku.
+ * @param[in] memory - pamięć grafu;
+ * @param[in] city   - wskaźnik na miasto lub jego stare miejsce.
+ * @return Wskaźnik na miasto.
+ */
+City *relocatedCity(const GraphMemory *memory, City *city);
+
+/**
+ * @brief Wyznacza aktualne miejsce odcinka w czasie opróżniania bloku.
+ * @param[in] memory - pamięć grafu;
+ * @param[in] road   - wskaźnik na odcinek lub jego stare miejsce.
+ * @return Wskaźnik na odcinek.
+ */
+Road *relocatedRoad(const GraphMemory *memory, Road *road);
+
+/**
+ * @brief Kończy opróżnianie bloku pamięci miast lub odcinków.
+ * @param[in,out] memory - pamięć grafu;
+ * @param[in] kind       - rodzaj obiektów.
+ * @return @p true jeśli blok został zwrócony do systemu, @p false gdy zabrakło
+ * pamięci i część obiektów została na miejscu.
+ */
+bool finishGraphEvacuation(GraphMemory *memory, GraphObjectKind kind);
 
 #endif /* DROGI_MAP_GRAPH_H */
@@ -0,0 +1,618 @@
+/** @file
+ * Implementacja modułu przechowującego odległości od punktów orientacyjnych mapy.
+ *
+ * Punkty orientacyjne są rozdzielane między największe spójne składowe proporcjonalnie
+ * do ich wielkości. W składowej każdy kolejny punkt to miasto najdalsze (w liczbie
+ * odcinków) od już wybranych, znajdowane przeszukiwaniem wszerz. Odległości od punktów są liczone
+ * algorytmem Dijkstry, każdy punkt przez jeden wątek, do osobnych kolumn,
+ * które są potem przepisywane do tablicy wierszy miast.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "map_landmarks.h"
+#include "map_types.h"
+#include "map_graph.h"
+
+#include "heap.h"
+#include "page_memory.h"
+#include "utility.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca zadanie liczenia odległości od punktów orientacyjnych. */
+typedef struct LandmarkJobStruct LandmarkJob;
+
+/** Struktura przechowująca spójną składową, między które są rozdzielane punkty orientacyjne. */
+typedef struct LandmarkComponentStruct LandmarkComponent;
+
+
+/* Deklaracje struktur. */
+
+/** Zawiera dane wspólne dla wątków liczących odległości od kolejnych punktów. */
+struct LandmarkJobStruct {
+    /** Wskaźnik na mapę, która nie zmienia się w trakcie liczenia. */
+    const Map *map;
+    /** Ograniczenie id miast na mapie. */
+    size_t cityCount;
+    /** Id punktów orientacyjnych. */
+    const uint32_t *landmarkIds;
+    /** Liczba punktów orientacyjnych. */
+    size_t landmarkCount;
+    /** Tablica kolumn odległości, kolumna punktu @p j zaczyna się na miejscu @p j * @p cityCount. */
+    uint64_t *columns;
+    /** Numer następnego punktu do wzięcia przez wątek. */
+    atomic_size_t next;
+    /** Liczba punktów, dla których kolumny zostały policzone. */
+    atomic_size_t done;
+};
+
+/** Zawiera położenie składowej w kolejności przeszukiwania i liczbę jej punktów. */
+struct LandmarkComponentStruct {
+    /** Miejsce pierwszego miasta składowej w tablicy kolejności. */
+    size_t begin;
+    /** Liczba miast składowej. */
+    size_t size;
+    /** Liczba punktów orientacyjnych przydzielonych składowej. */
+    size_t landmarkCount;
+};
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Zapewnia miejsce na odległości miast o id mniejszych od danego ograniczenia.
+ * Tablica rośnie co najmniej dwukrotnie, nowe wiersze są wypełniane @ref NO_LANDMARK_DISTANCE.
+ * @param[in,out] landmarks - wskaźnik na odległości;
+ * @param[in] cityCount     - ograniczenie id miast.
+ * @return @p true lub @p false gdy brak pamięci, wtedy tablica jest bez zmian.
+ */
+static bool reserveLandmarkCities(Landmarks *landmarks, size_t cityCount);
+
+/**
+ * @brief Znajduje drugi koniec odcinka, również gdy odcinek jest zablokowany.
+ * Odległości liczone przez zablokowane odcinki są tylko mniejsze, więc ograniczenia
+ * pozostają poprawne również po przywróceniu odcinka, którego nie udało się usunąć.
+ * @param[in] road   - wskaźnik na odcinek;
+ * @param[in] cityId - id jednego końca.
+ * @return Id drugiego końca.
+ */
+static inline uint32_t landmarkRoadEndId(const Road *road, uint32_t cityId);
+
+/**
+ * @brief Poprawia odległości w liczbie odcinków przeszukiwaniem wszerz od miasta.
+ * Nie wchodzi do miast, do których zapisana odległość nie jest większa,
+ * więc po kolejnych wywołaniach tablica zawiera odległość od najbliższego z miast.
+ * @param[in] map      - wskaźnik na mapę;
+ * @param[in] startId  - id miasta, od którego jest przeszukiwanie;
+ * @param[in,out] hops - tablica odległości według id miast;
+ * @param[out] queue   - tablica na kolejkę, mieszcząca wszystkie miasta.
+ */
+static void relaxHopsFrom(const Map *map, uint32_t startId, uint32_t *hops, uint32_t *queue);
+
+/**
+ * @brief Dzieli miasta mające odcinki na spójne składowe przeszukiwaniem wszerz.
+ * Miasta jednej składowej zajmują w tablicy kolejności ciągły fragment.
+ * @param[in] map         - wskaźnik na mapę;
+ * @param[in] cityCount   - ograniczenie id miast na mapie;
+ * @param[out] order      - tablica na id miast w kolejności przeszukiwania;
+ * @param[in,out] hops    - tablica wypełniona @p UINT32_MAX, w której odwiedzone miasta są zerowane;
+ * @param[out] largest    - tablica na @ref LANDMARK_COUNT największych składowych, malejąco.
+ * @return Liczba składowych zapisanych w @p largest.
+ */
+static size_t orderComponents(const Map *map, size_t cityCount, uint32_t *order, uint32_t *hops,
+                              LandmarkComponent *largest);
+
+/**
+ * @brief Rozdziela punkty orientacyjne między składowe.
+ * Każdy kolejny punkt trafia do składowej o największej liczbie miast na punkt
+ * po jego dodaniu, więc liczby punktów są mniej więcej proporcjonalne do wielkości.
+ * @param[in,out] components - tablica składowych z wyzerowanymi liczbami punktów;
+ * @param[in] componentCount - liczba składowych.
+ */
+static void distributeLandmarks(LandmarkComponent *components, size_t componentCount);
+
+/**
+ * @brief Wybiera punkty orientacyjne.
+ * @param[in,out] landmarks - wskaźnik na odległości;
+ * @param[in] map           - wskaźnik na mapę;
+ * @param[in] cityCount     - ograniczenie id miast na mapie.
+ * @return @p true lub @p false gdy brak pamięci, wtedy punkty są bez zmian.
+ */
+static bool selectLandmarks(Landmarks *landmarks, const Map *map, size_t cityCount);
+
+/**
+ * @brief Sprawdza czy wszystkie punkty orientacyjne są dalej na mapie.
+ * @param[in] landmarks - wskaźnik na odległości;
+ * @param[in] map       - wskaźnik na mapę;
+ * @param[in] cityCount - ograniczenie id miast na mapie.
+ * @return @p true jeśli jest jakiś punkt i wszystkie są miastami mapy, @p false w p.p.
+ */
+static bool areLandmarksOnMap(const Landmarks *landmarks, const Map *map, size_t cityCount);
+
+/**
+ * @brief Liczy algorytmem Dijkstry odległości od punktu orientacyjnego do wszystkich miast.
+ * @param[in] map        - wskaźnik na mapę;
+ * @param[in] landmarkId - id punktu;
+ * @param[out] column    - tablica na odległości według id miast;
+ * @param[in] cityCount  - ograniczenie id miast na mapie;
+ * @param[in,out] heap   - pusty kopiec na wszystkie miasta, pusty również po wykonaniu.
+ */
+static void computeLandmarkColumn(const Map *map, uint32_t landmarkId, uint64_t *column, size_t cityCount,
+                                  RadixHeap *heap);
+
+/**
+ * @brief Liczy kolumny odległości dla kolejnych nie wziętych jeszcze punktów zadania.
+ * Jest wykonywana jednocześnie przez kilka wątków. Jeśli zabraknie pamięci na kopiec,
+ * to nie bierze żadnego punktu.
+ * @param[in,out] jobPtr - wskaźnik na zadanie.
+ * @return @p NULL.
+ */
+static void *runLandmarkJob(void *jobPtr);
+
+/**
+ * @brief Wyznacza liczbę wątków liczących odległości.
+ * @param[in] landmarkCount - liczba punktów orientacyjnych.
+ * @return Liczba od @p 1 do @p landmarkCount, nie większa od liczby dostępnych procesorów.
+ */
+static size_t landmarkThreadCount(size_t landmarkCount);
+
+/**
+ * @brief Szacuje dodatkową pracę szukań od czasu, gdy odległości przestały być dokładne.
+ * @param[in] landmarks - wskaźnik na odległości.
+ * @return Liczba miast zdjętych z kolejek ponad średnią dla dokładnych odległości.
+ */
+static size_t excessSearchWork(const Landmarks *landmarks);
+
+/**
+ * @brief Liczy od nowa odległości od punktów orientacyjnych.
+ * Punkty są wybierane od nowa, jeśli któregoś nie ma już na mapie.
+ * @param[in,out] landmarks - wskaźnik na odległości;
+ * @param[in] map           - wskaźnik na mapę.
+ * @return @p true lub @p false gdy brak pamięci, wtedy odległości są bez zmian.
+ */
+static bool refreshLandmarks(Landmarks *landmarks, const Map *map);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static bool reserveLandmarkCities(Landmarks *landmarks, size_t cityCount) {
+    if (cityCount <= landmarks->capacity) {
+        return true;
+    }
+
+    size_t capacity = landmarks->capacity * 2 > cityCount ? landmarks->capacity * 2 : cityCount;
+    uint64_t *distances = allocateStoragePages(sizeof(uint64_t) * LANDMARK_COUNT * capacity);
+    if (distances == NULL) {
+        return false;
+    }
+
+    size_t oldSize = LANDMARK_COUNT * landmarks->capacity;
+    for (size_t i = 0; i < oldSize; i++) {
+        distances[i] = landmarks->distances[i];
+    }
+    for (size_t i = oldSize; i < LANDMARK_COUNT * capacity; i++) {
+        distances[i] = NO_LANDMARK_DISTANCE;
+    }
+    freeStoragePages(landmarks->distances, sizeof(uint64_t) * oldSize);
+    landmarks->distances = distances;
+    landmarks->capacity = capacity;
+    return true;
+}
+
+static inline uint32_t landmarkRoadEndId(const Road *road, uint32_t cityId) {
+    return road->end1Id == cityId ? road->end2Id : road->end1Id;
+}
+
+static void relaxHopsFrom(const Map *map, uint32_t startId, uint32_t *hops, uint32_t *queue) {
+    size_t head = 0;
+    size_t tail = 0;
+    hops[startId] = 0;
+    queue[tail++] = startId;
+    while (head < tail) {
+        uint32_t cityId = queue[head++];
+        const City *city = cityOfId(map->memory, cityId);
+        const uint32_t *roads = roadNumbersOfCity(city);
+        for (size_t i = 0; i < city->roadCount; i++) {
+            uint32_t neighborId = landmarkRoadEndId(roadOfNumber(map->memory, roads[i]), cityId);
+            if (hops[cityId] + 1 < hops[neighborId]) {
+                hops[neighborId] = hops[cityId] + 1;
+                queue[tail++] = neighborId;
+            }
+        }
+    }
+}
+
+static size_t orderComponents(const Map *map, size_t cityCount, uint32_t *order, uint32_t *hops,
+                              LandmarkComponent *largest) {
+    size_t componentCount = 0;
+    size_t tail = 0;
+    for (size_t startId = 0; startId < cityCount; startId++) {
+        const City *start = cityOfId(map->memory, startId);
+        if (start == NULL || start->roadCount == 0 || hops[startId] != UINT32_MAX) {
+            continue;
+        }
+
+        /* Tablica kolejności służy jednocześnie za kolejkę przeszukiwania. */
+        LandmarkComponent component = {tail, 0, 0};
+        size_t head = tail;
+        hops[startId] = 0;
+        order[tail++] = startId;
+        while (head < tail) {
+            uint32_t cityId = order[head++];
+            const City *city = cityOfId(map->memory, cityId);
+            const uint32_t *roads = roadNumbersOfCity(city);
+            for (size_t i = 0; i < city->roadCount; i++) {
+                uint32_t neighborId = landmarkRoadEndId(roadOfNumber(map->memory, roads[i]), cityId);
+                if (hops[neighborId] == UINT32_MAX) {
+                    hops[neighborId] = 0;
+                    order[tail++] = neighborId;
+                }
+            }
+        }
+        component.size = tail - component.begin;
+
+        /* Składowe są trzymane malejąco według liczby miast. */
+        size_t position = componentCount < LANDMARK_COUNT ? componentCount++ : LANDMARK_COUNT;
+        while (position > 0 && largest[position - 1].size < component.size) {
+            if (position < LANDMARK_COUNT) {
+                largest[position] = largest[position - 1];
+            }
+            position--;
+        }
+        if (position < LANDMARK_COUNT) {
+            largest[position] = component;
+        }
+    }
+    return componentCount;
+}
+
+static void distributeLandmarks(LandmarkComponent *components, size_t componentCount) {
+    for (size_t landmark = 0; landmark < LANDMARK_COUNT; landmark++) {
+        /* Kolejny punkt dostaje składowa o największej liczbie miast na jeden punkt po jego dodaniu. */
+        LandmarkComponent *best = NULL;
+        for (size_t i = 0; i < componentCount; i++) {
+            LandmarkComponent *component = &components[i];
+            if (component->landmarkCount < component->size &&
+                (best == NULL || component->size * (best->landmarkCount + 1) >
+                                 best->size * (component->landmarkCount + 1))) {
+                best = component;
+            }
+        }
+        if (best == NULL) {
+            return;
+        }
+        best->landmarkCount++;
+    }
+}
+
+static bool selectLandmarks(Landmarks *landmarks, const Map *map, size_t cityCount) {
+    uint32_t *order = malloc(sizeof(uint32_t) * cityCount);
+    uint32_t *hops = malloc(sizeof(uint32_t) * cityCount);
+    uint32_t *queue = malloc(sizeof(uint32_t) * cityCount);
+    FAIL_IF(order == NULL || hops == NULL || queue == NULL);
+
+    for (size_t id = 0; id < cityCount; id++) {
+        hops[id] = UINT32_MAX;
+    }
+    LandmarkComponent components[LANDMARK_COUNT];
+    size_t componentCount = orderComponents(map, cityCount, order, hops, components);
+    FAIL_IF(componentCount == 0);
+    distributeLandmarks(components, componentCount);
+    for (size_t id = 0; id < cityCount; id++) {
+        hops[id] = UINT32_MAX;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < componentCount; i++) {
+        const uint32_t *cityIds = order + components[i].begin;
+        size_t size = components[i].size;
+        if (components[i].landmarkCount > 0) {
+            relaxHopsFrom(map, cityIds[0], hops, queue);
+        }
+
+        for (size_t landmark = 0; landmark < components[i].landmarkCount; landmark++) {
+            /* Następny punkt to najdalsze miasto składowej, pierwszy jest najdalszy od jej pierwszego miasta. */
+            uint32_t farthestId = NO_CITY_ID;
+            uint32_t farthestHops = 0;
+            for (size_t j = 0; j < size; j++) {
+                if (hops[cityIds[j]] > farthestHops) {
+                    farthestId = cityIds[j];
+                    farthestHops = hops[cityIds[j]];
+                }
+            }
+            if (farthestId == NO_CITY_ID) {
+                /* Wszystkie miasta składowej są już punktami. */
+                break;
+            }
+
+            if (landmark == 0) {
+                for (size_t j = 0; j < size; j++) {
+                    hops[cityIds[j]] = UINT32_MAX;
+                }
+            }
+            landmarks->cityIds[count++] = farthestId;
+            relaxHopsFrom(map, farthestId, hops, queue);
+        }
+    }
+    landmarks->count = count;
+
+    free(order);
+    free(hops);
+    free(queue);
+    return true;
+
+    FAILURE:
+
+    free(order);
+    free(hops);
+    free(queue);
+    return false;
+}
+
+static bool areLandmarksOnMap(const Landmarks *landmarks, const Map *map, size_t cityCount) {
+    if (landmarks->count == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < landmarks->count; i++) {
+        uint32_t cityId = landmarks->cityIds[i];
+        if (cityId >= cityCount || cityOfId(map->memory, cityId) == NULL ||
+            cityOfId(map->memory, cityId)->roadCount == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void computeLandmarkColumn(const Map *map, uint32_t landmarkId, uint64_t *column, size_t cityCount,
+                                  RadixHeap *heap) {
+    for (size_t id = 0; id < cityCount; id++) {
+        column[id] = NO_LANDMARK_DISTANCE;
+    }
+
+    HeapKey key = {0, 0};
+    column[landmarkId] = 0;
+    pushToRadixHeap(heap, landmarkId, key);
+    while (!isEmptyRadixHeap(heap)) {
+        uint32_t cityId = popFromRadixHeap(heap, &key);
+        const City *city = cityOfId(map->memory, cityId);
+        const uint32_t *roads = roadNumbersOfCity(city);
+        for (size_t i = 0; i < city->roadCount; i++) {
+            const Road *road = roadOfNumber(map->memory, roads[i]);
+            uint32_t neighborId = landmarkRoadEndId(road, cityId);
+            uint64_t distance = key.primary + road->length;
+            if (distance < column[neighborId]) {
+                column[neighborId] = distance;
+                HeapKey neighborKey = {distance, 0};
+                pushToRadixHeap(heap, neighborId, neighborKey);
+            }
+        }
+    }
+    clearRadixHeap(heap);
+}
+
+static void *runLandmarkJob(void *jobPtr) {
+    LandmarkJob *job = jobPtr;
+    RadixHeap *heap = initRadixHeap(job->cityCount);
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    size_t landmark;
+    while ((landmark = atomic_fetch_add(&job->next, 1)) < job->landmarkCount) {
+        computeLandmarkColumn(job->map, job->landmarkIds[landmark], job->columns + landmark * job->cityCount,
+                              job->cityCount, heap);
+        atomic_fetch_add(&job->done, 1);
+    }
+    deleteRadixHeap(heap);
+    return NULL;
+}
+
+static size_t landmarkThreadCount(size_t landmarkCount) {
+    long processorCount = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+    processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (processorCount < 1) {
+        return 1;
+    }
+    return (size_t) processorCount < landmarkCount ? (size_t) processorCount : landmarkCount;
+}
+
+static size_t excessSearchWork(const Landmarks *landmarks) {
+    if (landmarks->state == LANDMARKS_MISSING || landmarks->exactSearchCount == 0) {
+        return landmarks->searchWork;
+    }
+
+    size_t expectedWork = landmarks->searchCount * landmarks->exactSearchWork / landmarks->exactSearchCount;
+    return landmarks->searchWork > expectedWork ? landmarks->searchWork - expectedWork : 0;
+}
+
+static bool refreshLandmarks(Landmarks *landmarks, const Map *map) {
+    uint64_t *columns = NULL;
+    size_t cityCount = map->cityCount;
+    FAIL_IF(cityCount == 0);
+    FAIL_IF(!areLandmarksOnMap(landmarks, map, cityCount) && !selectLandmarks(landmarks, map, cityCount));
+
+    columns = allocateStoragePages(sizeof(uint64_t) * cityCount * landmarks->count);
+    FAIL_IF(columns == NULL || !reserveLandmarkCities(landmarks, cityCount));
+
+    LandmarkJob job;
+    job.map = map;
+    job.cityCount = cityCount;
+    job.landmarkIds = landmarks->cityIds;
+    job.landmarkCount = landmarks->count;
+    job.columns = columns;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.done, 0);
+
+    /* Wątek wywołujący też liczy, więc punkty zostaną policzone nawet gdy nie uda się utworzyć wątków. */
+    pthread_t threads[LANDMARK_COUNT];
+    bool started[LANDMARK_COUNT] = {false};
+    size_t threadCount = landmarkThreadCount(landmarks->count);
+    for (size_t i = 1; i < threadCount; i++) {
+        started[i] = pthread_create(&threads[i], NULL, runLandmarkJob, &job) == 0;
+    }
+    runLandmarkJob(&job);
+    for (size_t i = 1; i < threadCount; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    FAIL_IF(atomic_load(&job.done) != landmarks->count);
+
+    for (size_t id = 0; id < landmarks->capacity; id++) {
+        uint64_t *row = landmarks->distances + id * LANDMARK_COUNT;
+        for (size_t j = 0; j < LANDMARK_COUNT; j++) {
+            row[j] = id < cityCount && j < landmarks->count ? columns[j * cityCount + id] : NO_LANDMARK_DISTANCE;
+        }
+    }
+    landmarks->state = LANDMARKS_EXACT;
+    landmarks->searchWork = 0;
+    landmarks->searchCount = 0;
+
+    freeStoragePages(columns, sizeof(uint64_t) * cityCount * landmarks->count);
+    return true;
+
+    FAILURE:
+
+    freeStoragePages(columns, sizeof(uint64_t) * cityCount * landmarks->count);
+    return false;
+}
+
+
+/* Funkcje z interfejsu. */
+
+Landmarks *initLandmarks(void) {
+    Landmarks *landmarks = malloc(sizeof(Landmarks));
+    if (landmarks == NULL) {
+        return NULL;
+    }
+
+    landmarks->state = LANDMARKS_MISSING;
+    landmarks->count = 0;
+    landmarks->capacity = 0;
+    landmarks->distances = NULL;
+    landmarks->searchWork = 0;
+    landmarks->searchCount = 0;
+    landmarks->exactSearchWork = 0;
+    landmarks->exactSearchCount = 0;
+    return landmarks;
+}
+
+void deleteLandmarks(Landmarks *landmarks) {
+    if (landmarks == NULL) {
+        return;
+    }
+
+    freeStoragePages(landmarks->distances, sizeof(uint64_t) * LANDMARK_COUNT * landmarks->capacity);
+    free(landmarks);
+}
+
+void invalidateLandmarks(Landmarks *landmarks) {
+    if (landmarks == NULL) {
+        return;
+    }
+
+    /* Id punktów też straciły znaczenie. */
+    landmarks->state = LANDMARKS_MISSING;
+    landmarks->count = 0;
+    landmarks->exactSearchWork = 0;
+    landmarks->exactSearchCount = 0;
+}
+
+void markLandmarksStale(Landmarks *landmarks) {
+    if (landmarks != NULL && landmarks->state == LANDMARKS_EXACT) {
+        landmarks->state = LANDMARKS_STALE;
+    }
+}
+
+void addRoadToLandmarks(Landmarks *landmarks, const Map *map, const Road *road) {
+    if (landmarks == NULL || map == NULL || road == NULL || landmarks->state == LANDMARKS_MISSING) {
+        return;
+    }
+
+    uint32_t maxId = road->end1Id > road->end2Id ? road->end1Id : road->end2Id;
+    if (!reserveLandmarkCities(landmarks, (size_t) maxId + 1)) {
+        landmarks->state = LANDMARKS_MISSING;
+        return;
+    }
+
+    bool isLeaf1 = cityOfId(map->memory, road->end1Id)->roadCount == 1;
+    bool isLeaf2 = cityOfId(map->memory, road->end2Id)->roadCount == 1;
+    uint64_t *row1 = landmarks->distances + (size_t) road->end1Id * LANDMARK_COUNT;
+    uint64_t *row2 = landmarks->distances + (size_t) road->end2Id * LANDMARK_COUNT;
+    if (isLeaf1 && isLeaf2) {
+        /* Odcinek tworzy nową składową, nieosiągalną z żadnego punktu. */
+        for (size_t j = 0; j < LANDMARK_COUNT; j++) {
+            row1[j] = NO_LANDMARK_DISTANCE;
+            row2[j] = NO_LANDMARK_DISTANCE;
+        }
+        return;
+    }
+
+    if (isLeaf1 || isLeaf2) {
+        /* Do miasta z jednym odcinkiem da się dojść tylko przez drugi koniec. */
+        uint64_t *leafRow = isLeaf1 ? row1 : row2;
+        const uint64_t *otherRow = isLeaf1 ? row2 : row1;
+        for (size_t j = 0; j < LANDMARK_COUNT; j++) {
+            leafRow[j] = otherRow[j] == NO_LANDMARK_DISTANCE ? NO_LANDMARK_DISTANCE : otherRow[j] + road->length;
+        }
+        return;
+    }
+
+    for (size_t j = 0; j < LANDMARK_COUNT; j++) {
+        if ((row1[j] == NO_LANDMARK_DISTANCE) != (row2[j] == NO_LANDMARK_DISTANCE)) {
+            /* Odcinek łączy składowe, więc wartości nieosiągalnych miast przestają być poprawne. */
+            landmarks->state = LANDMARKS_MISSING;
+            return;
+        }
+
+        uint64_t difference = row1[j] > row2[j] ? row1[j] - row2[j] : row2[j] - row1[j];
+        if (difference > road->length) {
+            landmarks->state = LANDMARKS_MISSING;
+            return;
+        }
+    }
+    /* Odcinek nie skraca żadnej odległości od punktów, więc dokładne odległości dalej są dokładne. */
+}
+
+bool prepareLandmarks(Landmarks *landmarks, const Map *map) {
+    if (landmarks == NULL || map == NULL) {
+        return false;
+    }
+
+    /* Przeliczenie kosztuje tyle, co szukania od wszystkich punktów po całej mapie. */
+    size_t cityCount = map->cityCount;
+    if (landmarks->state != LANDMARKS_EXACT && excessSearchWork(landmarks) >= LANDMARK_COUNT * cityCount &&
+        !refreshLandmarks(landmarks, map)) {
+        landmarks->searchWork = 0;
+        landmarks->searchCount = 0;
+    }
+    return landmarks->state != LANDMARKS_MISSING;
+}
+
+void addLandmarkSearchWork(Landmarks *landmarks, size_t work) {
+    if (landmarks == NULL) {
+        return;
+    }
+
+    if (landmarks->state == LANDMARKS_EXACT) {
+        landmarks->exactSearchWork += work;
+        landmarks->exactSearchCount++;
+    } else {
+        landmarks->searchWork += work;
+        landmarks->searchCount++;
+    }
+}
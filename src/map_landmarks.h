@@ -0,0 +1,157 @@
+/** @file
+ * Interfejs modułu przechowującego odległości od punktów orientacyjnych mapy.
+ *
+ * Dla kilku wybranych miast (punktów orientacyjnych) pamiętane są odległości
+ * do wszystkich miast. Z nierówności trójkąta różnica odległości dwóch miast
+ * od punktu orientacyjnego ogranicza z dołu odległość między nimi, co pozwala
+ * szukaniu drogi kierować się w stronę celu (algorytm A*).
+ *
+ * Ograniczenia pozostają poprawne, dopóki dla każdego odcinka różnica wartości
+ * jego końców nie przekracza jego długości. Usuwanie odcinków tego nie psuje,
+ * więc po usunięciu odległości są tylko oznaczane jako nieaktualne i liczone
+ * od nowa dopiero wtedy, gdy dodatkowa praca szukań ze słabszymi ograniczeniami
+ * zrówna się z kosztem przeliczenia. Dodany odcinek jest sprawdzany od razu.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_MAP_LANDMARKS_H
+#define DROGI_MAP_LANDMARKS_H
+
+#include "map_types.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+
+/* Stałe. */
+
+/**
+ * Największa liczba punktów orientacyjnych. Odległości jednego miasta
+ * od wszystkich punktów zajmują wtedy 64 bajty, czyli jedną linię pamięci podręcznej.
+ */
+#define LANDMARK_COUNT 8
+
+/** Wartość oznaczająca miasto nieosiągalne z punktu orientacyjnego. */
+#define NO_LANDMARK_DISTANCE UINT64_MAX
+
+
+/* Definicje typów. */
+
+/**
+ * Typ wyliczeniowy określający stan odległości od punktów orientacyjnych.
+ */
+enum LandmarkStateEnum {
+    /** Odległości nie mogą być używane, bo nie zostały policzone lub mapa się zmieniła. */
+            LANDMARKS_MISSING,
+    /** Odległości dają poprawne ograniczenia, ale mogą być mniejsze od prawdziwych. */
+            LANDMARKS_STALE,
+    /** Odległości są dokładne. */
+            LANDMARKS_EXACT
+};
+
+/**
+ * Typ określający stan odległości od punktów orientacyjnych.
+ */
+typedef enum LandmarkStateEnum LandmarkState;
+
+
+/* Deklaracje struktur. */
+
+/**
+ * Przechowuje odległości od punktów orientacyjnych.
+ * Odległości miasta od kolejnych punktów leżą obok siebie, więc ograniczenie
+ * dla jednego miasta wymaga odczytania jednej linii pamięci podręcznej.
+ */
+struct LandmarksStruct {
+    /** Stan odległości. */
+    LandmarkState state;
+    /** Liczba punktów orientacyjnych, nie większa od @ref LANDMARK_COUNT. */
+    size_t count;
+    /** Id miast będących punktami orientacyjnymi. */
+    uint32_t cityIds[LANDMARK_COUNT];
+    /** Liczba miast, dla których jest miejsce w tablicy odległości. */
+    size_t capacity;
+    /**
+     * Tablica @p capacity razy @ref LANDMARK_COUNT odległości, odległość miasta o id @p i
+     * od punktu @p j jest na miejscu @p i * @ref LANDMARK_COUNT + @p j. Nieużywane punkty
+     * mają wartość @ref NO_LANDMARK_DISTANCE, więc nie wpływają na ograniczenia.
+     * Tablica leży w bloku z @ref allocateStoragePages.
+     */
+    uint64_t *distances;
+    /** Liczba miast zdjętych z kolejek przez szukania od czasu, gdy odległości przestały być dokładne. */
+    size_t searchWork;
+    /** Liczba szukań od czasu, gdy odległości przestały być dokładne. */
+    size_t searchCount;
+    /** Liczba miast zdjętych z kolejek przez szukania z dokładnymi odległościami. */
+    size_t exactSearchWork;
+    /** Liczba szukań z dokładnymi odległościami. */
+    size_t exactSearchCount;
+};
+
+
+/* Funkcje z interfejsu. */
+
+/**
+ * @brief Tworzy puste odległości od punktów orientacyjnych.
+ * Odległości są liczone dopiero wtedy, gdy szukania wykonają odpowiednio dużo pracy.
+ * @return Wskaźnik na odległości lub @p NULL gdy brak pamięci.
+ */
+Landmarks *initLandmarks(void);
+
+/**
+ * @brief Usuwa odległości od punktów orientacyjnych.
+ * Jeśli wskaźnik to @p NULL nic nie robi.
+ * @param[in,out] landmarks - wskaźnik na odległości.
+ */
+void deleteLandmarks(Landmarks *landmarks);
+
+/**
+ * @brief Zaznacza, że odległości nie mogą być używane.
+ * Używana, gdy zmienia się numeracja miast.
+ * @param[in,out] landmarks - wskaźnik na odległości lub @p NULL.
+ */
+void invalidateLandmarks(Landmarks *landmarks);
+
+/**
+ * @brief Zaznacza, że po usunięciu odcinka odległości mogą być za małe.
+ * Ograniczenia pozostają poprawne, bo usunięcie odcinka nie skraca żadnej drogi.
+ * @param[in,out] landmarks - wskaźnik na odległości lub @p NULL.
+ */
+void markLandmarksStale(Landmarks *landmarks);
+
+/**
+ * @brief Uwzględnia w odległościach nowo dodany odcinek.
+ * Miastu, które ma tylko ten odcinek, wyznacza odległości przez drugi koniec.
+ * Jeśli oba końce mają inne odcinki, a różnica ich odległości od któregoś punktu
+ * przekracza długość odcinka, to ograniczenia przestają być poprawne i odległości
+ * nie mogą być używane do przeliczenia.
+ * @param[in,out] landmarks - wskaźnik na odległości lub @p NULL;
+ * @param[in] map           - wskaźnik na mapę;
+ * @param[in] road          - wskaźnik na dodany odcinek.
+ */
+void addRoadToLandmarks(Landmarks *landmarks, const Map *map, const Road *road);
+
+/**
+ * @brief Przygotowuje odległości do szukania drogi.
+ * Jeśli odległości nie są dokładne, a szukania wykonały od tego czasu co najmniej
+ * tyle dodatkowej pracy, ile kosztuje przeliczenie, to liczy je od nowa, od każdego
+ * punktu w osobnym wątku. Punkty, które dalej są na mapie, zostają te same.
+ * Dodatkowa praca to praca ponad średnią pracę szukań z dokładnymi odległościami,
+ * a gdy odległości nie mogą być używane lub takich szukań nie było, cała praca.
+ * @param[in,out] landmarks - wskaźnik na odległości lub @p NULL;
+ * @param[in] map           - wskaźnik na mapę.
+ * @return @p true jeśli odległości mogą być używane, @p false w p.p.
+ */
+bool prepareLandmarks(Landmarks *landmarks, const Map *map);
+
+/**
+ * @brief Zapisuje pracę wykonaną przez szukanie drogi.
+ * @param[in,out] landmarks - wskaźnik na odległości lub @p NULL;
+ * @param[in] work          - liczba miast zdjętych z kolejki.
+ */
+void addLandmarkSearchWork(Landmarks *landmarks, size_t work);
+
+#endif /* DROGI_MAP_LANDMARKS_H */
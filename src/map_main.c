@@ -8,7 +8,8 @@
 #define _GNU_SOURCE
 
 #include "map.h"
-#include "vector.h"
+#include "map_find_route.h"
+#include "page_memory.h"
 #include "utility.h"
 
 #include <string.h>
@@ -21,6 +22,46 @@
 #include <ctype.h>
 
 
+/* Stałe. */
+
+/**
+ * Nazwa zmiennej środowiskowej z polityką przydzielania dużych bloków pamięci,
+ * w formacie opisanym przy @ref parsePagePolicy.
+ */
+static const char *const PAGE_POLICY_VARIABLE = "DROGI_PAGE_POLICY";
+/**
+ * Nazwa zmiennej środowiskowej z katalogiem, w którego pliku tymczasowym
+ * mają być trzymane duże bloki grafu (@ref setStorageDirectory).
+ */
+static const char *const STORAGE_DIRECTORY_VARIABLE = "DROGI_STORAGE_DIR";
+/**
+ * Nazwa zmiennej środowiskowej z rodzajem kolejki używanej przez szukanie drogi,
+ * w formacie opisanym przy @ref parseSearchQueueKind.
+ */
+static const char *const SEARCH_QUEUE_VARIABLE = "DROGI_SEARCH_QUEUE";
+/**
+ * Nazwa zmiennej środowiskowej ze sposobem szukania drogi,
+ * w formacie opisanym przy @ref parseSearchEngine.
+ */
+static const char *const SEARCH_ENGINE_VARIABLE = "DROGI_SEARCH_ENGINE";
+/** Początkowa liczba miejsc na parametry komendy. */
+static const size_t INITIAL_PARAMETER_CAPACITY = 16;
+
+
+/* Definicje typów. */
+
+/** Struktura przechowująca parametr komendy. */
+typedef struct ParameterStruct Parameter;
+
+/** Zawiera parametr komendy wraz z jego kluczem jako nazwy miasta. */
+struct ParameterStruct {
+    /** Wskaźnik na napis z parametrem. */
+    const char *text;
+    /** Klucz parametru utworzony przez @ref scanCityKey, niepoprawny jeśli parametr nie jest nazwą. */
+    CityKey key;
+};
+
+
 /* Zmienne globalne. */
 
 /**
@@ -28,19 +69,33 @@
  */
 static Map *map = NULL;
 
+/**
+ * Czy od ostatniej komendy szukającej dróg były wczytywane odcinki,
+ * czyli czy trwa seria wczytywania zakończona przez @ref finishLoadingBatch.
+ */
+static bool isLoadingBatch = false;
+
+/** Parametry ostatniej komendy, tablica jest używana ponownie przez kolejne komendy. */
+static Parameter *commandParameters = NULL;
+
+/** Liczba miejsc w tablicy @ref commandParameters. */
+static size_t parameterCapacity = 0;
+
 
 /* Funkcje pomocnicze. */
 
 /**
- * @brief Ekstrahuje kolejne parametry z komendy.
- * Dla napisu będącego komendą wyciąga kolejne napisy pomiędzy średnikami.
- * Jeśli parametr @p string jest @p NULL to z napisu, na którym ostatnio było operowane, zwraca kolejny parametr.
- * Jeśli nie to zaczyna od nowa parsowanie podanego napisu.
- * Zamienia średniki na zerowe bajty i zwraca wskaźniki na kolejne pozycje w oryginalnym napisie.
- * @param[in,out] string - napis to ekstrahowania parametrów lub @p NULL jeśli ma być użyty poprzedni napis.
- * @return wskaźnik na odpowiednią pozycję w oryginalnym napisie lub @p NULL jeśli się skończył.
+ * @brief Dzieli komendę na parametry.
+ * Wyciąga kolejne napisy pomiędzy średnikami i zapisuje je w @ref commandParameters.
+ * Zamienia średniki na zerowe bajty, więc parametry wskazują na pozycje w oryginalnym napisie.
+ * Każdy parametr jest przeglądany raz: razem z jego końcem liczony jest jego klucz
+ * jako nazwy miasta (@ref scanCityKey), więc nazwy nie są później ani sprawdzane, ani haszowane.
+ * @param[in,out] command     - napis z komendą bez znaku nowej linii;
+ * @param[in] end             - wskaźnik na miejsce za ostatnim znakiem komendy;
+ * @param[out] parameterCount - wskaźnik na miejsce na liczbę parametrów.
+ * @return @p true lub @p false gdy komenda zawiera zerowy bajt lub zabrakło pamięci.
  */
-static char *getNextParameter(char *string);
+static bool splitCommand(char *command, const char *end, size_t *parameterCount);
 
 /**
  * @brief Konwertuje napis na @p unsigned.
@@ -81,39 +136,86 @@ static bool executeCommand(char *command, size_t len);
  * Tworzy na mapie drogę krajową o podanym opisie.
  * Tworzy lub naprawia odpowiednie odcinki drogowe.
  * Może je modyfikować nawet w przypadku nieudanego stworzenia drogi krajowej.
+ * Klucz nazwy każdego miasta jest tworzony raz i używany we wszystkich operacjach.
  * @param[in] routeId        - ID dodawanej drogi;
  * @param[in] parameters     - tablica parametrów;
  * @param[in] parameterCount - liczba parametrów.
  * @return @p true lub @p false w zależności od powodzenia.
  */
-static bool executeCreateRoute(unsigned routeId, const char **parameters, size_t parameterCount);
+static bool executeCreateRoute(unsigned routeId, const Parameter *parameters, size_t parameterCount);
+
+/**
+ * @brief Kończy serię wczytywania odcinków przed komendą szukającą dróg.
+ * Jeśli od ostatniej takiej komendy były wczytywane odcinki, to wywołuje
+ * @ref finishBulkLoad, więc mapa jest porządkowana raz na serię, a nie w trakcie komendy.
+ */
+static void finishLoadingBatch(void);
+
+/**
+ * @brief Ustawia politykę przydzielania dużych bloków pamięci.
+ * Jeśli zmienna środowiskowa @ref PAGE_POLICY_VARIABLE jest ustawiona, to ustawia
+ * politykę z niej i wypisuje na wyjście diagnostyczne politykę, która została
+ * faktycznie ustawiona. W p.p. zostaje polityka domyślna.
+ */
+static void setupPagePolicy(void);
+
+/**
+ * @brief Włącza trzymanie grafu w pliku, jeśli wybrano katalog.
+ * Jeśli zmienna środowiskowa @ref STORAGE_DIRECTORY_VARIABLE jest ustawiona, to
+ * graf będzie trzymany w pliku w tym katalogu, a na wyjście diagnostyczne jest
+ * wypisywane, czy to się udało. W p.p. graf jest trzymany w pamięci procesu.
+ */
+static void setupStorage(void);
+
+/**
+ * @brief Ustawia rodzaj kolejki używanej przez szukanie drogi.
+ * Jeśli zmienna środowiskowa @ref SEARCH_QUEUE_VARIABLE jest ustawiona, to ustawia
+ * rodzaj z niej i wypisuje go na wyjście diagnostyczne. W p.p. zostaje rodzaj domyślny.
+ */
+static void setupSearchQueue(void);
+
+/**
+ * @brief Ustawia sposób szukania drogi.
+ * Jeśli zmienna środowiskowa @ref SEARCH_ENGINE_VARIABLE jest ustawiona, to ustawia
+ * sposób z niej i wypisuje go na wyjście diagnostyczne. W p.p. zostaje sposób domyślny.
+ */
+static void setupSearchEngine(void);
 
 
 /* Implementacja funkcji pomocniczych. */
 
-static char *getNextParameter(char *string) {
-    static char *savePointer = NULL;
-    if (string != NULL) {
-        if (*string == '\0') {
-            string = NULL;
-        }
-    } else {
-        string = savePointer;
+static bool splitCommand(char *command, const char *end, size_t *parameterCount) {
+    *parameterCount = 0;
+    if (command == end) {
+        return true;
     }
 
-    if (string == NULL) {
-        return NULL;
-    }
+    char *parameter = command;
+    while (true) {
+        if (*parameterCount == parameterCapacity) {
+            size_t newCapacity = parameterCapacity == 0 ? INITIAL_PARAMETER_CAPACITY : parameterCapacity * 2;
+            Parameter *newParameters = realloc(commandParameters, sizeof(Parameter) * newCapacity);
+            if (newParameters == NULL) {
+                return false;
+            }
+            commandParameters = newParameters;
+            parameterCapacity = newCapacity;
+        }
 
-    char *end = string + strcspn(string, ";");
-    if (*end == '\0') {
-        savePointer = NULL;
-        return string;
-    }
+        /* Koniec parametru jest znajdowany w tym samym przejściu, w którym liczony jest klucz. */
+        CityKey key = scanCityKey(parameter, ';');
+        char *parameterEnd = parameter + key.length;
+        commandParameters[*parameterCount].text = parameter;
+        commandParameters[*parameterCount].key = key;
+        (*parameterCount)++;
+        if (*parameterEnd == '\0') {
+            /* Zerowy bajt przed końcem linii jest niepoprawny. */
+            return parameterEnd == end;
+        }
 
-    *end = '\0';
-    savePointer = end + 1;
-    return string;
+        *parameterEnd = '\0';
+        parameter = parameterEnd + 1;
+    }
 }
 
 static bool stringToUnsigned(const char *str, unsigned *number) {
@@ -161,66 +263,53 @@ static bool stringToInt(const char *str, int *number) {
 }
 
 static bool executeCommand(char *command, size_t len) {
-    Vector *parametersVector = NULL;
     FAIL_IF(command == NULL || len == 0);
 
-    /* Wczytano zerowy bajt, który jest niepoprawny. */
-    FAIL_IF(len != strlen(command));
-
     /* Usuwanie znaku newline. */
     FAIL_IF(command[len - 1] != '\n');
     command[len - 1] = '\0';
 
     if (command[0] == '#') {
-        return true;
+        /* Wczytano zerowy bajt, który jest niepoprawny. */
+        return strlen(command) == len - 1;
     }
 
-    parametersVector = initVector();
-    FAIL_IF(parametersVector == NULL);
+    /* Zerowy bajt w komendzie jest wykrywany przy podziale na parametry. */
+    size_t parameterCount;
+    FAIL_IF(!splitCommand(command, command + len - 1, &parameterCount));
 
-    char *nextParameter = getNextParameter(command);
-    while (nextParameter != NULL) {
-        FAIL_IF(!pushToVector(parametersVector, nextParameter));
-        nextParameter = getNextParameter(NULL);
-    }
-
-    size_t parameterCount = sizeOfVector(parametersVector);
-    const char **parameters = (const char **) storageBlockOfVector(parametersVector);
+    const Parameter *parameters = commandParameters;
     if (parameterCount == 0) {
-        deleteVector(parametersVector, NULL);
         return true;
     }
 
     /* Z komendy zostały "wyjęte" wszystkie parametry. */
     if (strcmp(command, "addRoad") == 0) {
         FAIL_IF(parameterCount != 5);
-        const char *city1Name = parameters[1];
-        const char *city2Name = parameters[2];
+        CityKey city1Key = parameters[1].key;
+        CityKey city2Key = parameters[2].key;
         unsigned length;
         int builtYear;
-        FAIL_IF(!stringToUnsigned(parameters[3], &length));
-        FAIL_IF(!stringToInt(parameters[4], &builtYear));
+        FAIL_IF(!stringToUnsigned(parameters[3].text, &length));
+        FAIL_IF(!stringToInt(parameters[4].text, &builtYear));
 
-        deleteVector(parametersVector, NULL);
-        return addRoad(map, city1Name, city2Name, length, builtYear);
+        isLoadingBatch = true;
+        return addRoadKeyed(map, city1Key, city2Key, length, builtYear);
     }
     if (strcmp(command, "repairRoad") == 0) {
         FAIL_IF(parameterCount != 4);
-        const char *city1Name = parameters[1];
-        const char *city2Name = parameters[2];
+        CityKey city1Key = parameters[1].key;
+        CityKey city2Key = parameters[2].key;
         int repairYear;
-        FAIL_IF(!stringToInt(parameters[3], &repairYear));
+        FAIL_IF(!stringToInt(parameters[3].text, &repairYear));
 
-        deleteVector(parametersVector, NULL);
-        return repairRoad(map, city1Name, city2Name, repairYear);
+        return repairRoadKeyed(map, city1Key, city2Key, repairYear);
     }
     if (strcmp(command, "getRouteDescription") == 0) {
         FAIL_IF(parameterCount != 2);
         unsigned routeId;
-        FAIL_IF(!stringToUnsigned(parameters[1], &routeId));
+        FAIL_IF(!stringToUnsigned(parameters[1].text, &routeId));
 
-        deleteVector(parametersVector, NULL);
-        parametersVector = NULL;
         char *description = (char *) getRouteDescription(map, routeId);
         FAIL_IF(description == NULL);
 
@@ -231,99 +320,96 @@ static bool executeCommand(char *command, size_t len) {
     if (strcmp(command, "newRoute") == 0) {
         FAIL_IF(parameterCount != 4);
         unsigned routeId;
-        FAIL_IF(!stringToUnsigned(parameters[1], &routeId));
-        const char *city1Name = parameters[2];
-        const char *city2Name = parameters[3];
+        FAIL_IF(!stringToUnsigned(parameters[1].text, &routeId));
+        CityKey city1Key = parameters[2].key;
+        CityKey city2Key = parameters[3].key;
 
-        deleteVector(parametersVector, NULL);
-        return newRoute(map, routeId, city1Name, city2Name);
+        finishLoadingBatch();
+        return newRouteKeyed(map, routeId, city1Key, city2Key);
     }
     if (strcmp(command, "extendRoute") == 0) {
         FAIL_IF(parameterCount != 3);
         unsigned routeId;
-        FAIL_IF(!stringToUnsigned(parameters[1], &routeId));
-        const char *cityName = parameters[2];
+        FAIL_IF(!stringToUnsigned(parameters[1].text, &routeId));
+        CityKey cityKey = parameters[2].key;
 
-        deleteVector(parametersVector, NULL);
-        return extendRoute(map, routeId, cityName);
+        finishLoadingBatch();
+        return extendRouteKeyed(map, routeId, cityKey);
     }
     if (strcmp(command, "removeRoad") == 0) {
         FAIL_IF(parameterCount != 3);
-        const char *city1Name = parameters[1];
-        const char *city2Name = parameters[2];
+        CityKey city1Key = parameters[1].key;
+        CityKey city2Key = parameters[2].key;
 
-        deleteVector(parametersVector, NULL);
-        return removeRoad(map, city1Name, city2Name);
+        finishLoadingBatch();
+        return removeRoadKeyed(map, city1Key, city2Key);
     }
     if (strcmp(command, "removeRoute") == 0) {
         FAIL_IF(parameterCount != 2);
         unsigned routeId;
-        FAIL_IF(!stringToUnsigned(parameters[1], &routeId));
+        FAIL_IF(!stringToUnsigned(parameters[1].text, &routeId));
 
-        deleteVector(parametersVector, NULL);
         return removeRoute(map, routeId);
     }
 
     unsigned routeId;
-    FAIL_IF(!stringToUnsigned(parameters[0], &routeId));
-    bool result = executeCreateRoute(routeId, parameters + 1, parameterCount - 1);
-    deleteVector(parametersVector, NULL);
-    return result;
+    FAIL_IF(!stringToUnsigned(parameters[0].text, &routeId));
+    isLoadingBatch = true;
+    return executeCreateRoute(routeId, parameters + 1, parameterCount - 1);
 
     FAILURE:
 
-    deleteVector(parametersVector, NULL);
     return false;
 }
 
-static bool executeCreateRoute(unsigned routeId, const char **parameters, size_t parameterCount) {
-    const char **cityNames = NULL;
+static bool executeCreateRoute(unsigned routeId, const Parameter *parameters, size_t parameterCount) {
+    CityKey *cityKeys = NULL;
     unsigned *roadLengths = NULL;
     int *roadYears = NULL;
     RoadStatus *roadStatuses = NULL;
     size_t roadCount = parameterCount / 3;
     FAIL_IF(roadCount < 1 || roadCount * 3 + 1 != parameterCount);
 
-    cityNames = malloc(sizeof(const char *) * (roadCount + 1));
+    cityKeys = malloc(sizeof(CityKey) * (roadCount + 1));
     roadLengths = malloc(sizeof(int) * roadCount);
     roadYears = malloc(sizeof(unsigned) * roadCount);
-    FAIL_IF(cityNames == NULL || roadLengths == NULL || roadYears == NULL);
+    FAIL_IF(cityKeys == NULL || roadLengths == NULL || roadYears == NULL);
 
     for (size_t i = 0; i < roadCount; i++) {
         size_t nr = i * 3;
-        cityNames[i] = parameters[nr++];
-        FAIL_IF(!stringToUnsigned(parameters[nr++], &roadLengths[i]));
-        FAIL_IF(!stringToInt(parameters[nr++], &roadYears[i]));
+        cityKeys[i] = parameters[nr++].key;
+        FAIL_IF(!stringToUnsigned(parameters[nr++].text, &roadLengths[i]));
+        FAIL_IF(!stringToInt(parameters[nr++].text, &roadYears[i]));
     }
-    cityNames[roadCount] = parameters[roadCount * 3];
+    cityKeys[roadCount] = parameters[roadCount * 3].key;
 
     roadStatuses = malloc(sizeof(RoadStatus) * roadCount);
     FAIL_IF(roadStatuses == NULL);
     for (size_t i = 0; i < roadCount; i++) {
-        roadStatuses[i] = getRoadStatus(map, cityNames[i], cityNames[i + 1], roadLengths[i], roadYears[i]);
+        roadStatuses[i] = getRoadStatusKeyed(map, cityKeys[i], cityKeys[i + 1], roadLengths[i], roadYears[i]);
         FAIL_IF(roadStatuses[i] == ROAD_ILLEGAL);
     }
 
     for (size_t i = 0; i < roadCount; i++) {
         switch (roadStatuses[i]) {
             case ROAD_REPAIRABLE:
-                FAIL_IF(!repairRoad(map, cityNames[i], cityNames[i + 1], roadYears[i]));
+                FAIL_IF(!repairRoadKeyed(map, cityKeys[i], cityKeys[i + 1], roadYears[i]));
                 break;
             case ROAD_ADDABLE:
-                FAIL_IF(!addRoad(map, cityNames[i], cityNames[i + 1],
-                                 roadLengths[i], roadYears[i]));
+                FAIL_IF(!addRoadKeyed(map, cityKeys[i], cityKeys[i + 1],
+                                      roadLengths[i], roadYears[i]));
                 break;
             default:
                 break;
         }
     }
 
-    FAIL_IF(!createRoute(map, routeId, cityNames, roadCount + 1));
+    FAIL_IF(!createRouteKeyed(map, routeId, cityKeys, roadCount + 1));
 
     free(roadStatuses);
     free(roadYears);
     free(roadLengths);
-    free(cityNames);
+    free(cityKeys);
     return true;
 
     FAILURE:
@@ -331,16 +417,84 @@ static bool executeCreateRoute(unsigned routeId, const char **parameters, size_t
     free(roadStatuses);
     free(roadYears);
     free(roadLengths);
-    free(cityNames);
+    free(cityKeys);
     return false;
 }
 
+static void finishLoadingBatch(void) {
+    if (isLoadingBatch) {
+        finishBulkLoad(map);
+        isLoadingBatch = false;
+    }
+}
+
+static void setupPagePolicy(void) {
+    const char *text = getenv(PAGE_POLICY_VARIABLE);
+    if (text == NULL) {
+        return;
+    }
+
+    PagePolicy policy;
+    if (!parsePagePolicy(text, &policy)) {
+        fprintf(stderr, "Unknown memory policy: %s\n", text);
+        return;
+    }
+    fprintf(stderr, "Memory policy: %s\n", describePagePolicy(setPagePolicy(policy)));
+}
+
+static void setupStorage(void) {
+    const char *directory = getenv(STORAGE_DIRECTORY_VARIABLE);
+    if (directory == NULL) {
+        return;
+    }
+
+    if (!setStorageDirectory(directory)) {
+        fprintf(stderr, "Cannot use storage directory: %s\n", directory);
+        return;
+    }
+    fprintf(stderr, "Storage directory: %s\n", directory);
+}
+
+static void setupSearchQueue(void) {
+    const char *text = getenv(SEARCH_QUEUE_VARIABLE);
+    if (text == NULL) {
+        return;
+    }
+
+    SearchQueueKind kind;
+    if (!parseSearchQueueKind(text, &kind)) {
+        fprintf(stderr, "Unknown search queue: %s\n", text);
+        return;
+    }
+    setSearchQueueKind(kind);
+    fprintf(stderr, "Search queue: %s\n", describeSearchQueueKind(kind));
+}
+
+static void setupSearchEngine(void) {
+    const char *text = getenv(SEARCH_ENGINE_VARIABLE);
+    if (text == NULL) {
+        return;
+    }
+
+    SearchEngine engine;
+    if (!parseSearchEngine(text, &engine)) {
+        fprintf(stderr, "Unknown search engine: %s\n", text);
+        return;
+    }
+    setSearchEngine(engine);
+    fprintf(stderr, "Search engine: %s\n", describeSearchEngine(engine));
+}
+
 
 /**
  * Funkcja main programu.
  * @return Kod wyjścia.
  */
 int main() {
+    setupPagePolicy();
+    setupStorage();
+    setupSearchQueue();
+    setupSearchEngine();
     map = newMap();
     if (map == NULL) {
         return 0;
@@ -360,6 +514,7 @@ int main() {
     }
 
     free(buff);
+    free(commandParameters);
     deleteMap(map);
     return 0;
 }
\ No newline at end of file
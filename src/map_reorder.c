@@ -0,0 +1,218 @@
+/** @file
+ * Implementacja modułu przenumerowującego miasta mapy zgodnie z jej grafem.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include "map_reorder.h"
+#include "map_types.h"
+#include "map_graph.h"
+#include "map_checkers.h"
+#include "road_index.h"
+#include "map_csr.h"
+#include "map_landmarks.h"
+
+#include "vector.h"
+#include "dict.h"
+#include "utility.h"
+
+#include <stdlib.h>
+#include <inttypes.h>
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Wyznacza nową kolejność miast przeszukiwaniem wszerz.
+ * Każda spójna składowa jest przeszukiwana od miasta o najmniejszym starym id,
+ * więc sąsiedzi dostają bliskie sobie nowe id.
+ * @param[in] map     - wskaźnik na mapę;
+ * @param[out] order  - tablica na stare id miast w nowej kolejności;
+ * @param[out] newIds - tablica na nowe id według starych id, @ref NO_CITY_ID dla wolnych id.
+ * @return Liczba miast na mapie.
+ */
+static size_t breadthFirstOrder(const Map *map, uint32_t *order, uint32_t *newIds);
+
+/**
+ * @brief Tworzy w nowej pamięci grafu kopię miast i odcinków mapy w nowej kolejności.
+ * Odcinek jest kopiowany przy tym końcu, który ma mniejsze nowe id, więc odcinki
+ * kolejnych miast leżą obok siebie. W razie niepowodzenia część kopii może już
+ * istnieć, wtedy należy usunąć całą nową pamięć i nowy indeks.
+ * @param[in] map            - wskaźnik na mapę;
+ * @param[in] order          - stare id miast w nowej kolejności;
+ * @param[in] newIds         - nowe id według starych id;
+ * @param[in] count          - liczba miast;
+ * @param[in,out] memory     - nowa pamięć grafu;
+ * @param[in,out] roadIndex  - nowy indeks odcinków;
+ * @param[out] newCities     - tablica na nowe miasta według nowych id.
+ * @return @p true lub @p false gdy brak pamięci.
+ */
+static bool copyGraphInOrder(const Map *map, const uint32_t *order, const uint32_t *newIds, size_t count,
+                             GraphMemory *memory, RoadIndex *roadIndex, City **newCities);
+
+/**
+ * @brief Przepina drogi krajowe na nowe miasta i odcinki.
+ * Nie alokuje pamięci. Stare odcinki muszą jeszcze istnieć.
+ * @param[in,out] map    - wskaźnik na mapę;
+ * @param[in] newIds     - nowe id według starych id;
+ * @param[in] newCities  - nowe miasta według nowych id;
+ * @param[in] roadIndex  - nowy indeks odcinków.
+ */
+static void remapRoutes(Map *map, const uint32_t *newIds, City *const *newCities, const RoadIndex *roadIndex);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static size_t breadthFirstOrder(const Map *map, uint32_t *order, uint32_t *newIds) {
+    size_t idBound = map->cityCount;
+    for (size_t id = 0; id < idBound; id++) {
+        newIds[id] = NO_CITY_ID;
+    }
+
+    size_t count = 0;
+    for (size_t start = 0; start < idBound; start++) {
+        if (newIds[start] != NO_CITY_ID || cityOfId(map->memory, start) == NULL) {
+            continue;
+        }
+
+        /* Tablica kolejności służy jednocześnie za kolejkę przeszukiwania. */
+        size_t head = count;
+        newIds[start] = count;
+        order[count++] = start;
+        while (head < count) {
+            const City *city = cityOfId(map->memory, order[head++]);
+            const uint32_t *roads = roadNumbersOfCity(city);
+            for (size_t i = 0; i < city->roadCount; i++) {
+                uint32_t neighborId = otherRoadEndId(roadOfNumber(map->memory, roads[i]), city->id);
+                if (neighborId != NO_CITY_ID && newIds[neighborId] == NO_CITY_ID) {
+                    newIds[neighborId] = count;
+                    order[count++] = neighborId;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+static bool copyGraphInOrder(const Map *map, const uint32_t *order, const uint32_t *newIds, size_t count,
+                             GraphMemory *memory, RoadIndex *roadIndex, City **newCities) {
+    for (size_t newId = 0; newId < count; newId++) {
+        const City *city = cityOfId(map->memory, order[newId]);
+        CityName name = nameOfCity(map->memory, city);
+        newCities[newId] = initCity(memory, name.text, name.length, newId);
+        if (newCities[newId] == NULL) {
+            return false;
+        }
+    }
+
+    for (size_t newId = 0; newId < count; newId++) {
+        const City *city = cityOfId(map->memory, order[newId]);
+        const uint32_t *roads = roadNumbersOfCity(city);
+        for (size_t i = 0; i < city->roadCount; i++) {
+            const Road *road = roadOfNumber(map->memory, roads[i]);
+            City *end1 = newCities[newIds[road->end1Id]];
+            City *end2 = newCities[newIds[road->end2Id]];
+            if (end1->id < newId || end2->id < newId) {
+                /* Odcinek został już skopiowany przy drugim końcu. */
+                continue;
+            }
+
+            Road *newRoad = initRoad(memory, road->lastRepaired, road->length, end1, end2);
+            if (newRoad == NULL || !addRoadToCity(memory, end1, newRoad) ||
+                !addRoadToCity(memory, end2, newRoad) || !addToRoadIndex(roadIndex, newRoad)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void remapRoutes(Map *map, const uint32_t *newIds, City *const *newCities, const RoadIndex *roadIndex) {
+    for (size_t routeId = 0; routeId <= MAX_ROUTE_ID; routeId++) {
+        Route *route = map->routes[routeId];
+        if (route == NULL) {
+            continue;
+        }
+
+        size_t roadCount = sizeOfVector(route->roads);
+        Road **roads = (Road **) storageBlockOfVector(route->roads);
+        for (size_t i = 0; i < roadCount; i++) {
+            /* Między parą miast jest co najwyżej jeden odcinek, więc para go wyznacza. */
+            roads[i] = findInRoadIndex(roadIndex, newCities[newIds[roads[i]->end1Id]],
+                                       newCities[newIds[roads[i]->end2Id]]);
+        }
+        route->end1 = newCities[newIds[route->end1->id]];
+        route->end2 = newCities[newIds[route->end2->id]];
+    }
+}
+
+
+/* Funkcje z interfejsu. */
+
+bool renumberCities(Map *map) {
+    uint32_t *order = NULL;
+    uint32_t *newIds = NULL;
+    City **newCities = NULL;
+    GraphMemory *memory = NULL;
+    RoadIndex *roadIndex = NULL;
+    DictKey *keys = NULL;
+    Dict *cities = NULL;
+    FAIL_IF(map == NULL);
+
+    size_t idBound = map->cityCount;
+    order = malloc(sizeof(uint32_t) * (idBound + 1));
+    newIds = malloc(sizeof(uint32_t) * (idBound + 1));
+    newCities = malloc(sizeof(City *) * (idBound + 1));
+    memory = initGraphMemory();
+    roadIndex = initRoadIndex();
+    FAIL_IF(order == NULL || newIds == NULL || newCities == NULL || memory == NULL || roadIndex == NULL);
+
+    size_t count = breadthFirstOrder(map, order, newIds);
+    FAIL_IF(!copyGraphInOrder(map, order, newIds, count, memory, roadIndex, newCities));
+
+    /* Słownik jest budowany od razu w docelowym rozmiarze, bez nazw usuniętych miast. */
+    keys = malloc(sizeof(DictKey) * (count + 1));
+    FAIL_IF(keys == NULL);
+    for (size_t newId = 0; newId < count; newId++) {
+        keys[newId] = initDictKey(nameOfCity(memory, newCities[newId]).text);
+    }
+    cities = dictBuildFromArray(keys, (void *const *) newCities, count);
+    FAIL_IF(cities == NULL);
+
+    /* Dalej nic nie jest alokowane. Nazwy miast wskazują odtąd na kopie w nowym słowniku. */
+    size_t cursor = 0;
+    DictEntry entry;
+    while (dictForEach(cities, &cursor, &entry)) {
+        setNameOfCity(memory, entry.value, entry.word, entry.length);
+    }
+    remapRoutes(map, newIds, newCities, roadIndex);
+
+    deleteDict(map->cities, NULL);
+    map->cities = cities;
+    deleteRoadIndex(map->roadIndex);
+    map->roadIndex = roadIndex;
+    deleteGraphMemory(map->memory);
+    map->memory = memory;
+    resetCsrGraph(map->csr);
+    invalidateLandmarks(map->landmarks);
+    map->cityCount = count;
+    map->freeIdCount = 0;
+
+    free(order);
+    free(newIds);
+    free(newCities);
+    free(keys);
+    return true;
+
+    FAILURE:
+
+    free(order);
+    free(newIds);
+    free(newCities);
+    free(keys);
+    deleteDict(cities, NULL);
+    deleteRoadIndex(roadIndex);
+    deleteGraphMemory(memory);
+    return false;
+}
@@ -0,0 +1,34 @@
+/** @file
+ * Interfejs modułu przenumerowującego miasta mapy zgodnie z jej grafem.
+ *
+ * Id miast wynikają z kolejności ich dodawania, która zwykle nie ma związku
+ * z połączeniami między miastami. Przenumerowanie w kolejności przeszukiwania wszerz
+ * nadaje sąsiadom bliskie id, więc szukanie drogi odwołuje się do bliskich
+ * miejsc w tablicach indeksowanych id, a miasta i odcinki są przenoszone
+ * do nowej pamięci grafu w tej samej kolejności.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_MAP_REORDER_H
+#define DROGI_MAP_REORDER_H
+
+#include "map_types.h"
+
+#include <stdbool.h>
+
+/**
+ * @brief Przenumerowuje miasta mapy i przenosi miasta oraz odcinki do nowej pamięci.
+ * Miasta dostają kolejne id w kolejności przeszukiwania wszerz, bez luk po usuniętych
+ * miastach. Słownik miast jest budowany od nowa tylko z nazw miast na mapie, więc
+ * zwalnia pamięć po nazwach usuniętych miast. Drogi krajowe i indeks odcinków
+ * są aktualizowane, a kopia grafu jest porzucana i zostanie zbudowana od nowa przy szukaniu drogi.
+ * Na czas działania potrzebuje pamięci na drugą kopię grafu.
+ * Wskaźniki na miasta i odcinki sprzed wywołania przestają być ważne.
+ * @param[in,out] map - wskaźnik na mapę.
+ * @return @p true lub @p false gdy brak pamięci, wtedy mapa pozostaje bez zmian.
+ */
+bool renumberCities(Map *map);
+
+#endif /* DROGI_MAP_REORDER_H */
@@ -31,10 +31,11 @@ static const size_t MAX_YEAR_LENGTH = 11;
 /**
  * @brief Dodaje do opisu nazwę miasta.
  * Dodaje na podane miejsce odpowiedni napis i przesuwa wskaźnik na nowy koniec.
+ * Nie dopisuje średnika za nazwą.
  * @param[in,out] description - wskaźnik na oryginalny wskaźnik na napis;
  * @param[in] name            - nazwa miasta.
  */
-static void addNameToDescription(char **description, const char *name);
+static void addNameToDescription(char **description, CityName name);
 
 /**
  * @brief Dodaje do opisu liczbę bez znaku.
@@ -55,15 +56,15 @@ static void addIntToDescription(char **description, int number);
 
 /* Implementacja funkcji pomocniczych. */
 
-static void addNameToDescription(char **description, const char *name) {
-    if (description == NULL || name == NULL) {
+static void addNameToDescription(char **description, CityName name) {
+    if (description == NULL || name.text == NULL) {
         return;
     }
 
-    strcat(*description, name);
-    *description += strlen(name);
-    strcat(*description, ";");
-    *description += 1;
+    /* Długość nazwy jest znana, więc nie trzeba szukać końca napisu. */
+    memcpy(*description, name.text, name.length);
+    *description += name.length;
+    **description = '\0';
 }
 
 static void addUnsignedToDescription(char **description, unsigned number) {
@@ -107,35 +108,36 @@ void deleteRoute(void *routeVoid) {
 }
 
 int checkRouteOrientation(const Route *route, const City *city1, const City *city2) {
-    if (route == NULL || city1 == city2) {
+    if (route == NULL || city1 == NULL || city2 == NULL || city1 == city2) {
         return 0;
     }
 
     size_t roadCount = sizeOfVector(route->roads);
     Road **roads = (Road **) storageBlockOfVector(route->roads);
 
-    City *position = route->end1;
-    for (size_t i = 0; i < roadCount && position != NULL; i++) {
-        if (position == city1) {
+    /* Wystarczy przechodzić po id, bo miasta są potrzebne tylko do porównań. */
+    uint32_t position = route->end1->id;
+    for (size_t i = 0; i < roadCount && position != NO_CITY_ID; i++) {
+        if (position == city1->id) {
             return 1;
         }
-        if (position == city2) {
+        if (position == city2->id) {
             return 2;
         }
-        position = otherRoadEnd(roads[i], position);
+        position = otherRoadEndId(roads[i], position);
     }
 
-    if (position == city1) {
+    if (position == city1->id) {
         return 1;
     }
-    if (position == city2) {
+    if (position == city2->id) {
         return 2;
     }
 
     return 0;
 }
 
-char *generateRouteDescription(const Route *route, unsigned routeId) {
+char *generateRouteDescription(const GraphMemory *memory, const Route *route, unsigned routeId) {
     char *description = NULL;
     if (route == NULL) {
         return calloc(1, sizeof(char));
@@ -147,12 +149,12 @@ char *generateRouteDescription(const Route *route, unsigned routeId) {
     City *position = route->end1;
     size_t totalLength = MAX_ROUTE_ID_LENGTH + 1;
     for (size_t i = 0; i < roadCount; i++) {
-        totalLength += strlen(position->name + 1);
+        totalLength += nameOfCity(memory, position).length + 1;
         totalLength += MAX_LENGTH_LENGTH + 1;
         totalLength += MAX_YEAR_LENGTH + 1;
-        position = otherRoadEnd(roads[i], position);
+        position = otherRoadEnd(memory, roads[i], position);
     }
-    totalLength += strlen(position->name) + 1;
+    totalLength += nameOfCity(memory, position).length + 1;
 
     description = malloc(sizeof(char) * totalLength);
     FAIL_IF(description == NULL);
@@ -162,12 +164,13 @@ char *generateRouteDescription(const Route *route, unsigned routeId) {
     char *descriptionPosition = description;
     addUnsignedToDescription(&descriptionPosition, routeId);
     for (size_t i = 0; i < roadCount; i++) {
-        addNameToDescription(&descriptionPosition, position->name);
+        addNameToDescription(&descriptionPosition, nameOfCity(memory, position));
+        *descriptionPosition++ = ';';
         addUnsignedToDescription(&descriptionPosition, roads[i]->length);
         addIntToDescription(&descriptionPosition, roads[i]->lastRepaired);
-        position = otherRoadEnd(roads[i], position);
+        position = otherRoadEnd(memory, roads[i], position);
     }
-    strcat(descriptionPosition, position->name);
+    addNameToDescription(&descriptionPosition, nameOfCity(memory, position));
 
     return description;
 
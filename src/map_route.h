@@ -57,10 +57,11 @@ int checkRouteOrientation(const Route *route, const City *city1, const City *cit
  * w wywołaniu funkcji @ref newRoute, które utworzyło tę drogę krajową, zostały
  * wypisane w tej kolejności.
  * Zakłada, że droga jest kompletna i nic nie jest zablokowane.
+ * @param[in] memory  - pamięć grafu, w której są miasta drogi;
  * @param[in] route   - wskaźnik na drogę krajową;
  * @param[in] routeId - numer drogi krajowej.
  * @return Wskaźnik na napis lub @p NULL, gdy nie udało się zaalokować pamięci.
  */
-char *generateRouteDescription(const Route *route, unsigned routeId);
+char *generateRouteDescription(const GraphMemory *memory, const Route *route, unsigned routeId);
 
 #endif /* DROGI_MAP_ROUTE_H */
@@ -15,6 +15,27 @@
 #include <inttypes.h>
 
 
+/* Stałe. */
+
+/**
+ * Liczba numerów odcinków przechowywanych bezpośrednio w strukturze miasta.
+ * Razem z id i licznikami zajmuje 64 bajty, czyli jedną linię pamięci podręcznej.
+ */
+#define INLINE_ROAD_COUNT 12
+
+/**
+ * Id oznaczające brak miasta. Miasta są numerowane 32-bitowymi id,
+ * więc wszystkie id na mapie są od niego mniejsze.
+ */
+#define NO_CITY_ID UINT32_MAX
+
+/**
+ * Numer oznaczający brak odcinka. Odcinki są wskazywane w grafie 32-bitowymi
+ * numerami, które udostępnia @ref roadOfNumber, więc wszystkie są od niego mniejsze.
+ */
+#define NO_ROAD_NUMBER UINT32_MAX
+
+
 /* Definicje typów. */
 
 /** Struktura przechowująca mapę dróg krajowych. */
@@ -26,9 +47,52 @@ typedef struct RoadStruct Road;
 /** Struktura przechowująca informacje o mieście. */
 typedef struct CityStruct City;
 
+/** Struktura przechowująca nazwę miasta. */
+typedef struct CityNameStruct CityName;
+
 /** Struktura przechowująca informacje o drodze krajowej. */
 typedef struct RouteStruct Route;
 
+/** Struktura przechowująca indeks odcinków drogowych według par miast. */
+typedef struct RoadIndexStruct RoadIndex;
+
+/** Struktura przechowująca zwartą kopię grafu mapy używaną przy szukaniu dróg. */
+typedef struct CsrGraphStruct CsrGraph;
+
+/** Struktura przechowująca pamięć, z której są przydzielane miasta i odcinki mapy. */
+typedef struct GraphMemoryStruct GraphMemory;
+
+/** Struktura przechowująca pamięć roboczą szukania dróg, używaną ponownie przez kolejne szukania. */
+typedef struct SearchWorkspaceStruct SearchWorkspace;
+
+/** Struktura przechowująca odległości od punktów orientacyjnych, używane do kierowania szukania dróg. */
+typedef struct LandmarksStruct Landmarks;
+
+/**
+ * Typ wyliczeniowy określający etap porządkowania pamięci mapy.
+ */
+enum CompactionStageEnum {
+    /** Dopasowanie miejsca na odcinki kolejnych miast. */
+            COMPACTION_ADJACENCY,
+    /** Dopasowanie wektorów dróg krajowych. */
+            COMPACTION_ROUTES,
+    /** Opróżnianie rzadko zajętych bloków pamięci bloków odcinków miast. */
+            COMPACTION_ROAD_BLOCKS,
+    /** Opróżnianie rzadko zajętych bloków pamięci miast. */
+            COMPACTION_CITIES,
+    /** Opróżnianie rzadko zajętych bloków pamięci odcinków. */
+            COMPACTION_ROADS,
+    /** Przepisanie słownika nazw miast bez nazw usuniętych miast. */
+            COMPACTION_NAMES,
+    /** Oddanie wolnej pamięci systemowi. */
+            COMPACTION_RELEASE
+};
+
+/**
+ * Typ określający etap porządkowania pamięci mapy.
+ */
+typedef enum CompactionStageEnum CompactionStage;
+
 
 /* Deklaracje struktur. */
 
@@ -36,32 +100,85 @@ typedef struct RouteStruct Route;
 struct Map {
     /** Słownik, gdzie nazwie miasta jest przypisany wskaźnik na obiekt miasta. */
     Dict *cities;
+    /** Pamięć, z której są przydzielane wszystkie miasta i odcinki mapy. */
+    GraphMemory *memory;
+    /** Indeks, gdzie parze miast jest przypisany łączący je odcinek. */
+    RoadIndex *roadIndex;
+    /** Zwarta kopia grafu z nakładką zmian, @p NULL jeśli szukanie korzysta tylko z aktualnego grafu. */
+    CsrGraph *csr;
+    /** Pamięć robocza szukania dróg. */
+    SearchWorkspace *searchWorkspace;
+    /** Odległości od punktów orientacyjnych. */
+    Landmarks *landmarks;
     /** Wskaźnik na tablicę wskaźników na drogi krajowe. */
     Route **routes;
-    /** Liczba miast na mapie. */
+    /** Liczba wydanych id, czyli górne ograniczenie id miast na mapie. */
     size_t cityCount;
+    /** Stos id zwolnionych przez usunięte miasta. */
+    uint32_t *freeIds;
+    /** Liczba id na stosie wolnych id. */
+    size_t freeIdCount;
+    /** Liczba miejsc w bloku stosu wolnych id. */
+    size_t freeIdCapacity;
+    /** Liczba miast po ostatnim przenumerowaniu miast. */
+    size_t reorderedCityCount;
+    /** Liczba miast dodanych od ostatniego zamrożenia słownika nazw miast. */
+    size_t unfrozenCityCount;
+    /** Etap porządkowania pamięci, od którego zacznie się kolejny krok. */
+    CompactionStage compactionStage;
+    /** Id miasta, od którego jest kontynuowany etap @ref COMPACTION_ADJACENCY. */
+    size_t compactionCursor;
+    /** Liczba odcinków usuniętych od zakończenia ostatniego porządkowania pamięci. */
+    size_t removedRoadCount;
 };
 
-/** Przechowuje informacje o drodze. */
+/**
+ * Przechowuje informacje o drodze.
+ * Końce są zapisane jako id miast, które udostępnia @ref cityOfId.
+ * Miejsca odcinka w tablicach odcinków obu końców pamięta pamięć grafu,
+ * więc usunięcie go z miasta nie wymaga szukania.
+ */
 struct RoadStruct {
     /** Rok ostatniego remontu lub budowy. Jeśli jest @p 0 to droga jest w "zablokowanym" stanie. */
     int lastRepaired;
-    /** Pierwszy koniec drogi. */
-    City *end1;
-    /** Drugi koniec drogi. */
-    City *end2;
     /** Długość drogi. Jeśli jest @p 0 to droga jest niedostępna. */
     unsigned length;
+    /** Id pierwszego końca drogi. */
+    uint32_t end1Id;
+    /** Id drugiego końca drogi. */
+    uint32_t end2Id;
 };
 
-/** Przechowuje informacje o mieście. */
+/**
+ * Przechowuje informacje o mieście potrzebne przy szukaniu dróg.
+ * Nazwa jest używana tylko przy wyszukiwaniu miasta i opisach dróg,
+ * więc jest przechowywana osobno, w pamięci grafu (@ref nameOfCity).
+ */
 struct CityStruct {
-    /** Wskaźnik na napis reprezentujący nazwę miasta. */
-    char *name;
-    /** Wskaźnik na wektor dróg wychodzących z miasta. */
-    Vector *roads;
-    /** Id miasta w danej mapie. */
-    size_t id;
+    /** Id miasta w danej mapie, mniejsze od @ref NO_CITY_ID. */
+    uint32_t id;
+    /** Liczba odcinków wychodzących z miasta. */
+    uint32_t roadCount;
+    /**
+     * Liczba miejsc na odcinki. Jeśli jest równa @ref INLINE_ROAD_COUNT,
+     * to odcinki są w @p roads.inlineRoads, a w p.p. w bloku @p roads.heapRoads.
+     */
+    uint32_t roadSpace;
+    /** Numery odcinków wychodzących z miasta, dostępne przez @ref roadNumbersOfCity. */
+    union {
+        /** Numery odcinków przechowywane bezpośrednio w mieście. */
+        uint32_t inlineRoads[INLINE_ROAD_COUNT];
+        /** Wskaźnik na blok numerów odcinków, gdy nie mieszczą się w mieście. */
+        uint32_t *heapRoads;
+    } roads;
+};
+
+/** Przechowuje nazwę miasta. */
+struct CityNameStruct {
+    /** Wskaźnik na napis reprezentujący nazwę miasta, przechowywany przez słownik miast. */
+    const char *text;
+    /** Długość nazwy miasta. */
+    size_t length;
 };
 
 /** Przechowuje informacje o drodze krajowej. */
@@ -0,0 +1,487 @@
+/** @file
+ * Implementacja modułu przydzielającego duże bloki pamięci według wybranej polityki stron.
+ *
+ * Na Linuksie duże bloki są mapowane przez @p mmap, przezroczyste duże strony są
+ * zamawiane przez @p madvise, a rozmieszczenie NUMA jest ustawiane przez wywołanie
+ * systemowe @p mbind, bez zależności od libnuma. Na innych systemach polityka
+ * jest zawsze domyślna i wszystkie bloki idą przez @p calloc.
+ *
+ * Pamięć trzymana w pliku to kolejne fragmenty jednego usuniętego już z katalogu
+ * pliku tymczasowego, mapowane przez @p mmap jako współdzielone. Zwolnione
+ * fragmenty są wycinane z pliku przez @p madvise z @p MADV_REMOVE, więc nie zajmują
+ * miejsca na dysku, a nowe fragmenty są zawsze dokładane na końcu pliku.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#define _GNU_SOURCE
+
+#include "page_memory.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+
+/* Stałe. */
+
+/** Najmniejszy blok mapowany przez @p mmap, mniejsze bloki są przydzielane przez @p calloc. */
+static const size_t MIN_MAPPED_SIZE = 256 * 1024;
+/** Rozmiar dużej strony. */
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+/** Rozmiar zwykłej strony. */
+static const size_t REGULAR_PAGE_SIZE = 4096;
+/** Plik z listą włączonych węzłów NUMA. */
+static const char *const NUMA_NODES_FILE = "/sys/devices/system/node/online";
+/** Plik z ustawieniem przezroczystych dużych stron. */
+static const char *const TRANSPARENT_HUGE_PAGES_FILE = "/sys/kernel/mm/transparent_hugepage/enabled";
+/**
+ * Najmniejszy blok grafu trzymany w pliku. Każdy blok to osobne mapowanie,
+ * a liczba mapowań procesu jest ograniczona przez jądro.
+ */
+static const size_t MIN_STORAGE_BLOCK_SIZE = 2 * 1024 * 1024;
+/** Wzorzec nazwy pliku tymczasowego w katalogu pamięci trzymanej w pliku. */
+static const char *const STORAGE_FILE_PATTERN = "/drogi-XXXXXX";
+/** Tryb @p MPOL_INTERLEAVE wywołania @p mbind. */
+static const int MPOL_INTERLEAVE_MODE = 3;
+/** Tryb @p MPOL_LOCAL wywołania @p mbind. */
+static const int MPOL_LOCAL_MODE = 4;
+/** Opisy polityk według trybu dużych stron i trybu NUMA. */
+static const char *const POLICY_DESCRIPTIONS[3][3] = {
+        {"huge pages: off, numa: default",
+                "huge pages: off, numa: interleave",
+                "huge pages: off, numa: local"},
+        {"huge pages: transparent, numa: default",
+                "huge pages: transparent, numa: interleave",
+                "huge pages: transparent, numa: local"},
+        {"huge pages: explicit, numa: default",
+                "huge pages: explicit, numa: interleave",
+                "huge pages: explicit, numa: local"}
+};
+
+
+/* Zmienne globalne. */
+
+/** Aktualna polityka. */
+static PagePolicy currentPolicy = {HUGE_PAGES_OFF, NUMA_DEFAULT};
+/** Czy blok był już przydzielony, wtedy polityki nie można zmienić. */
+static bool policyLocked = false;
+/** Maska włączonych węzłów NUMA, używana przy rozkładaniu stron. */
+static unsigned long numaNodeMask = 0;
+/** Deskryptor pliku pamięci trzymanej w pliku lub @p -1, gdy jest trzymana w pamięci procesu. */
+static int storageFile = -1;
+/** Rozmiar pliku pamięci trzymanej w pliku, czyli miejsce na kolejny fragment. */
+static size_t storageFileSize = 0;
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Sprawdza czy blok danego rozmiaru jest mapowany przez @p mmap.
+ * @param[in] size - rozmiar bloku.
+ * @return @p true jeśli blok jest mapowany, @p false jeśli idzie przez @p calloc.
+ */
+static bool isMappedSize(size_t size);
+
+/**
+ * @brief Zaokrągla rozmiar mapowanego bloku do wielokrotności strony.
+ * @param[in] size - rozmiar bloku.
+ * @return Rozmiar mapowania.
+ */
+static size_t mappedSize(size_t size);
+
+/**
+ * @brief Mapuje blok zgodnie z polityką.
+ * @param[in] size - rozmiar mapowania.
+ * @return Wskaźnik na blok lub @p NULL gdy mapowanie się nie udało.
+ */
+static void *mapPages(size_t size);
+
+/**
+ * @brief Mapuje zwykłe strony, z początkiem wyrównanym do dużej strony.
+ * Wyrównanie pozwala jądru użyć przezroczystych dużych stron dla całego bloku.
+ * @param[in] size - rozmiar mapowania.
+ * @return Wskaźnik na blok lub @p NULL gdy mapowanie się nie udało.
+ */
+static void *mapAlignedPages(size_t size);
+
+/**
+ * @brief Ustawia rozmieszczenie NUMA dla zmapowanego bloku.
+ * @param[in] memory - wskaźnik na blok;
+ * @param[in] size   - rozmiar mapowania;
+ * @param[in] numa   - tryb NUMA różny od @ref NUMA_DEFAULT.
+ * @return @p true jeśli jądro przyjęło ustawienie, @p false w p.p.
+ */
+static bool bindPages(void *memory, size_t size, NumaMode numa);
+
+/**
+ * @brief Odczytuje maskę włączonych węzłów NUMA.
+ * Pomija węzły o numerach, które nie mieszczą się w masce.
+ * @return Maska węzłów lub @p 0 jeśli nie da się jej odczytać.
+ */
+static unsigned long readNumaNodeMask(void);
+
+/**
+ * @brief Sprawdza czy jądro pozwala na przezroczyste duże strony.
+ * @return @p true jeśli pozwala na nie przynajmniej na żądanie.
+ */
+static bool transparentHugePagesEnabled(void);
+
+/**
+ * @brief Zaokrągla rozmiar fragmentu pliku do wielokrotności zwykłej strony.
+ * @param[in] size - rozmiar bloku.
+ * @return Rozmiar fragmentu.
+ */
+static size_t storageSize(size_t size);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static bool isMappedSize(size_t size) {
+    if (currentPolicy.hugePages == HUGE_PAGES_OFF && currentPolicy.numa == NUMA_DEFAULT) {
+        return false;
+    }
+    return size >= MIN_MAPPED_SIZE;
+}
+
+static size_t mappedSize(size_t size) {
+    size_t pageSize = currentPolicy.hugePages == HUGE_PAGES_OFF ? REGULAR_PAGE_SIZE : HUGE_PAGE_SIZE;
+    return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+static void *mapPages(size_t size) {
+#ifdef __linux__
+    void *memory = NULL;
+    if (currentPolicy.hugePages == HUGE_PAGES_EXPLICIT) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory == MAP_FAILED) {
+            memory = NULL;
+        }
+    }
+
+    if (memory == NULL && currentPolicy.hugePages != HUGE_PAGES_OFF) {
+        /* Gdy w puli zabraknie jawnych dużych stron, blok dostaje przezroczyste duże strony. */
+        memory = mapAlignedPages(size);
+        if (memory != NULL) {
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+    } else if (memory == NULL) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            memory = NULL;
+        }
+    }
+
+    if (memory != NULL && currentPolicy.numa != NUMA_DEFAULT) {
+        /* Niepowodzenie nie jest błędem, strony trafią po prostu na domyślne węzły. */
+        bindPages(memory, size, currentPolicy.numa);
+    }
+    return memory;
+#else
+    (void) size;
+    return NULL;
+#endif
+}
+
+static void *mapAlignedPages(size_t size) {
+#ifdef __linux__
+    char *memory = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+
+    /* Nadmiarowe strony przed wyrównanym początkiem i za końcem bloku są oddawane. */
+    uintptr_t start = ((uintptr_t) memory + HUGE_PAGE_SIZE - 1) & ~(uintptr_t) (HUGE_PAGE_SIZE - 1);
+    size_t head = start - (uintptr_t) memory;
+    if (head > 0) {
+        munmap(memory, head);
+    }
+    munmap((char *) start + size, HUGE_PAGE_SIZE - head);
+    return (void *) start;
+#else
+    (void) size;
+    return NULL;
+#endif
+}
+
+static bool bindPages(void *memory, size_t size, NumaMode numa) {
+#ifdef __linux__
+    if (numa == NUMA_INTERLEAVE) {
+        return syscall(SYS_mbind, memory, size, MPOL_INTERLEAVE_MODE, &numaNodeMask,
+                       sizeof(numaNodeMask) * CHAR_BIT + 1, 0) == 0;
+    }
+    return syscall(SYS_mbind, memory, size, MPOL_LOCAL_MODE, NULL, 0, 0) == 0;
+#else
+    (void) memory;
+    (void) size;
+    (void) numa;
+    return false;
+#endif
+}
+
+static unsigned long readNumaNodeMask(void) {
+    FILE *file = fopen(NUMA_NODES_FILE, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    /* Plik zawiera listę przedziałów, na przykład "0-1,3". */
+    unsigned long mask = 0;
+    unsigned first, last;
+    int read;
+    while ((read = fscanf(file, "%u-%u", &first, &last)) >= 1) {
+        if (read == 1) {
+            last = first;
+        }
+        for (unsigned node = first; node <= last && node < sizeof(mask) * CHAR_BIT; node++) {
+            mask |= 1ul << node;
+        }
+        if (fgetc(file) != ',') {
+            break;
+        }
+    }
+    fclose(file);
+    return mask;
+}
+
+static bool transparentHugePagesEnabled(void) {
+    FILE *file = fopen(TRANSPARENT_HUGE_PAGES_FILE, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    char setting[64] = "";
+    bool enabled = fgets(setting, sizeof(setting), file) != NULL && strstr(setting, "[never]") == NULL;
+    fclose(file);
+    return enabled;
+}
+
+static size_t storageSize(size_t size) {
+    return (size + REGULAR_PAGE_SIZE - 1) / REGULAR_PAGE_SIZE * REGULAR_PAGE_SIZE;
+}
+
+
+/* Funkcje z interfejsu. */
+
+bool parsePagePolicy(const char *text, PagePolicy *policy) {
+    if (text == NULL || policy == NULL) {
+        return false;
+    }
+
+    PagePolicy parsed = {HUGE_PAGES_OFF, NUMA_DEFAULT};
+    while (*text != '\0') {
+        size_t length = strcspn(text, ",");
+        if (length == 3 && strncmp(text, "thp", length) == 0) {
+            parsed.hugePages = HUGE_PAGES_TRANSPARENT;
+        } else if (length == 4 && strncmp(text, "huge", length) == 0) {
+            parsed.hugePages = HUGE_PAGES_EXPLICIT;
+        } else if (length == 10 && strncmp(text, "interleave", length) == 0) {
+            parsed.numa = NUMA_INTERLEAVE;
+        } else if (length == 5 && strncmp(text, "local", length) == 0) {
+            parsed.numa = NUMA_LOCAL;
+        } else if (length != 7 || strncmp(text, "default", length) != 0) {
+            return false;
+        }
+
+        text += length;
+        if (*text == ',') {
+            text++;
+        }
+    }
+
+    *policy = parsed;
+    return true;
+}
+
+PagePolicy setPagePolicy(PagePolicy requested) {
+    if (policyLocked) {
+        return currentPolicy;
+    }
+
+    PagePolicy actual = requested;
+#ifdef __linux__
+    if (actual.hugePages == HUGE_PAGES_EXPLICIT) {
+        void *probe = mmap(NULL, HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (probe == MAP_FAILED) {
+            actual.hugePages = HUGE_PAGES_TRANSPARENT;
+        } else {
+            munmap(probe, HUGE_PAGE_SIZE);
+        }
+    }
+    if (actual.hugePages == HUGE_PAGES_TRANSPARENT && !transparentHugePagesEnabled()) {
+        actual.hugePages = HUGE_PAGES_OFF;
+    }
+
+    if (actual.numa != NUMA_DEFAULT) {
+        numaNodeMask = readNumaNodeMask();
+        void *probe = mmap(NULL, REGULAR_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        /* Na jednym węźle nie ma czego rozkładać ani do czego przypinać. */
+        if ((numaNodeMask & (numaNodeMask - 1)) == 0 || probe == MAP_FAILED ||
+            !bindPages(probe, REGULAR_PAGE_SIZE, actual.numa)) {
+            actual.numa = NUMA_DEFAULT;
+        }
+        if (probe != MAP_FAILED) {
+            munmap(probe, REGULAR_PAGE_SIZE);
+        }
+    }
+#else
+    actual.hugePages = HUGE_PAGES_OFF;
+    actual.numa = NUMA_DEFAULT;
+#endif
+
+    currentPolicy = actual;
+    return actual;
+}
+
+const char *describePagePolicy(PagePolicy policy) {
+    return POLICY_DESCRIPTIONS[policy.hugePages][policy.numa];
+}
+
+size_t preferredBlockSize(size_t size) {
+    if (storageFile >= 0) {
+        return storageSize(size < MIN_STORAGE_BLOCK_SIZE ? MIN_STORAGE_BLOCK_SIZE : size);
+    }
+    if (currentPolicy.hugePages == HUGE_PAGES_OFF && currentPolicy.numa == NUMA_DEFAULT) {
+        return size;
+    }
+    if (size < MIN_MAPPED_SIZE) {
+        size = MIN_MAPPED_SIZE;
+    }
+    return mappedSize(size);
+}
+
+void *allocatePages(size_t size) {
+    policyLocked = true;
+    if (!isMappedSize(size)) {
+        return calloc(1, size);
+    }
+
+    /* Mapowane strony są wyzerowane przez jądro. */
+    return mapPages(mappedSize(size));
+}
+
+void freePages(void *memory, size_t size) {
+    if (memory == NULL) {
+        return;
+    }
+
+    if (!isMappedSize(size)) {
+        free(memory);
+        return;
+    }
+#ifdef __linux__
+    munmap(memory, mappedSize(size));
+#endif
+}
+
+bool setStorageDirectory(const char *directory) {
+#ifdef __linux__
+    if (directory == NULL || policyLocked || storageFile >= 0) {
+        return false;
+    }
+
+    char *path = malloc(strlen(directory) + strlen(STORAGE_FILE_PATTERN) + 1);
+    if (path == NULL) {
+        return false;
+    }
+    strcpy(path, directory);
+    strcat(path, STORAGE_FILE_PATTERN);
+
+    /* Plik jest od razu usuwany z katalogu, więc zniknie razem z procesem. */
+    int file = mkstemp(path);
+    if (file >= 0) {
+        unlink(path);
+    }
+    free(path);
+    if (file < 0) {
+        return false;
+    }
+
+    storageFile = file;
+    storageFileSize = 0;
+    return true;
+#else
+    (void) directory;
+    return false;
+#endif
+}
+
+bool isStorageInFile(void) {
+    return storageFile >= 0;
+}
+
+void *allocateStoragePages(size_t size) {
+#ifdef __linux__
+    if (storageFile < 0) {
+        return allocatePages(size);
+    }
+    policyLocked = true;
+
+    /* Przedłużona część pliku jest wyzerowana i nie zajmuje miejsca, dopóki nie zostanie zapisana. */
+    size_t fragmentSize = storageSize(size);
+    if (ftruncate(storageFile, (off_t) (storageFileSize + fragmentSize)) != 0) {
+        return NULL;
+    }
+    void *memory = mmap(NULL, fragmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, storageFile,
+                        (off_t) storageFileSize);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    storageFileSize += fragmentSize;
+    return memory;
+#else
+    return allocatePages(size);
+#endif
+}
+
+void freeStoragePages(void *memory, size_t size) {
+#ifdef __linux__
+    if (storageFile < 0) {
+        freePages(memory, size);
+        return;
+    }
+    if (memory == NULL) {
+        return;
+    }
+
+    madvise(memory, storageSize(size), MADV_REMOVE);
+    munmap(memory, storageSize(size));
+#else
+    freePages(memory, size);
+#endif
+}
+
+void prefetchStoragePages(const void *memory, size_t size) {
+#ifdef __linux__
+    if (storageFile < 0 || memory == NULL || size == 0) {
+        return;
+    }
+
+    /* Początek musi być wyrównany do strony, koniec jest zaokrąglany przez jądro. */
+    uintptr_t start = (uintptr_t) memory & ~(uintptr_t) (REGULAR_PAGE_SIZE - 1);
+    madvise((void *) start, size + ((uintptr_t) memory - start), MADV_WILLNEED);
+#else
+    (void) memory;
+    (void) size;
+#endif
+}
+
+void releaseFreeMemory(void) {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
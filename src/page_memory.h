@@ -0,0 +1,173 @@
+/** @file
+ * Interfejs modułu przydzielającego duże bloki pamięci według wybranej polityki stron.
+ *
+ * Duże tablice grafu i szukania dróg mogą być umieszczane na dużych stronach
+ * (przezroczystych lub jawnych), co zmniejsza liczbę chybień w TLB, oraz rozkładane
+ * między węzły NUMA lub przypinane do lokalnego węzła. Politykę wybiera się raz,
+ * przy starcie programu, a moduł sam sprawdza co jest dostępne i w razie
+ * potrzeby przechodzi na słabszy tryb. Małe bloki są zawsze przydzielane przez @p calloc.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_PAGE_MEMORY_H
+#define DROGI_PAGE_MEMORY_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Typ wyliczeniowy określający użycie dużych stron.
+ */
+enum HugePageModeEnum {
+    /** Zwykłe strony. */
+            HUGE_PAGES_OFF,
+    /** Przezroczyste duże strony, o które jądro jest proszone przez @p madvise. */
+            HUGE_PAGES_TRANSPARENT,
+    /** Jawne duże strony z puli jądra (@p MAP_HUGETLB). */
+            HUGE_PAGES_EXPLICIT
+};
+
+/**
+ * Typ wyliczeniowy określający rozmieszczenie pamięci między węzłami NUMA.
+ */
+enum NumaModeEnum {
+    /** Domyślne rozmieszczenie, czyli na węźle wątku, który pierwszy użył strony. */
+            NUMA_DEFAULT,
+    /** Strony rozkładane po kolei na wszystkie węzły. */
+            NUMA_INTERLEAVE,
+    /** Strony przypięte do węzła wątku, który je przydzielił. */
+            NUMA_LOCAL
+};
+
+/**
+ * Typ określający użycie dużych stron.
+ */
+typedef enum HugePageModeEnum HugePageMode;
+
+/**
+ * Typ określający rozmieszczenie pamięci między węzłami NUMA.
+ */
+typedef enum NumaModeEnum NumaMode;
+
+/** Struktura przechowująca politykę przydzielania dużych bloków pamięci. */
+typedef struct PagePolicyStruct PagePolicy;
+
+/** Przechowuje politykę przydzielania dużych bloków pamięci. */
+struct PagePolicyStruct {
+    /** Użycie dużych stron. */
+    HugePageMode hugePages;
+    /** Rozmieszczenie między węzłami NUMA. */
+    NumaMode numa;
+};
+
+/**
+ * @brief Odczytuje politykę z napisu.
+ * Napis to oddzielone przecinkami słowa: @p thp, @p huge, @p interleave, @p local
+ * lub @p default. Nie wymienione części polityki są domyślne.
+ * @param[in] text    - napis;
+ * @param[out] policy - wskaźnik na miejsce na politykę.
+ * @return @p true lub @p false gdy napis jest niepoprawny.
+ */
+bool parsePagePolicy(const char *text, PagePolicy *policy);
+
+/**
+ * @brief Ustawia politykę przydzielania dużych bloków pamięci.
+ * Sprawdza, które części polityki system faktycznie udostępnia, i ustawia najbliższą
+ * dostępną: jawne duże strony przechodzą w przezroczyste, a te w zwykłe strony,
+ * a NUMA bez kilku węzłów lub bez obsługi w jądrze w domyślne rozmieszczenie.
+ * Działa tylko przed pierwszym przydzieleniem dużego bloku.
+ * @param[in] requested - żądana polityka.
+ * @return Polityka, która została ustawiona.
+ */
+PagePolicy setPagePolicy(PagePolicy requested);
+
+/**
+ * @brief Opisuje politykę dla człowieka.
+ * @param[in] policy - polityka.
+ * @return Stały napis, na przykład "huge pages: transparent, numa: interleave".
+ */
+const char *describePagePolicy(PagePolicy policy);
+
+/**
+ * @brief Zaokrągla rozmiar bloku do wielkości, przy której polityka ma sens.
+ * Przy domyślnej polityce zwraca rozmiar bez zmian. W p.p. zwraca co najmniej
+ * najmniejszy mapowany blok, zaokrąglony do wielokrotności (dużej) strony.
+ * Gdy bloki grafu są trzymane w pliku, zwraca co najmniej 2 MiB, żeby
+ * ograniczyć liczbę mapowań.
+ * @param[in] size - rozmiar w bajtach.
+ * @return Zalecany rozmiar bloku w bajtach.
+ */
+size_t preferredBlockSize(size_t size);
+
+/**
+ * @brief Przydziela wyzerowany blok pamięci zgodnie z polityką.
+ * Blok trzeba zwolnić przez @ref freePages z tym samym rozmiarem.
+ * @param[in] size - rozmiar w bajtach.
+ * @return Wskaźnik na blok lub @p NULL gdy brak pamięci.
+ */
+void *allocatePages(size_t size);
+
+/**
+ * @brief Zwalnia blok przydzielony przez @ref allocatePages.
+ * Jeśli blok to @p NULL nic nie robi.
+ * @param[in,out] memory - wskaźnik na blok;
+ * @param[in] size       - rozmiar podany przy przydzieleniu.
+ */
+void freePages(void *memory, size_t size);
+
+/**
+ * @brief Oddaje systemowi wolną pamięć, którą trzyma jeszcze @p malloc.
+ * Mapowane bloki wracają do systemu już przy @ref freePages, a małe bloki
+ * i inne alokacje mogą zostać w pamięci procesu, dopóki nie zostanie wywołana ta funkcja.
+ * Poza biblioteką glibc nic nie robi.
+ */
+void releaseFreeMemory(void);
+
+/**
+ * @brief Włącza trzymanie dużych bloków grafu w pliku w danym katalogu.
+ * Bloki przydzielane przez @ref allocateStoragePages są wtedy fragmentami pliku
+ * tymczasowego mapowanymi do pamięci, więc jądro może je zapisywać na dysk i wczytywać
+ * z powrotem według potrzeby, a pamięć procesu nie ogranicza wielkości grafu.
+ * Plik jest usuwany z katalogu od razu, więc znika razem z procesem.
+ * Działa tylko przed pierwszym przydzieleniem dużego bloku i tylko na Linuksie.
+ * @param[in] directory - ścieżka do katalogu.
+ * @return @p true lub @p false gdy nie da się utworzyć pliku lub jest już za późno.
+ */
+bool setStorageDirectory(const char *directory);
+
+/**
+ * @brief Sprawdza czy bloki grafu są trzymane w pliku.
+ * @return @p true jeśli @ref setStorageDirectory się powiodło, @p false w p.p.
+ */
+bool isStorageInFile(void);
+
+/**
+ * @brief Przydziela wyzerowany blok pamięci na dane grafu.
+ * Gdy bloki grafu są trzymane w pliku, blok jest fragmentem pliku, a w p.p.
+ * jest przydzielany przez @ref allocatePages. Blok trzeba zwolnić przez
+ * @ref freeStoragePages z tym samym rozmiarem.
+ * @param[in] size - rozmiar w bajtach.
+ * @return Wskaźnik na blok lub @p NULL gdy brak pamięci lub miejsca na dysku.
+ */
+void *allocateStoragePages(size_t size);
+
+/**
+ * @brief Zwalnia blok przydzielony przez @ref allocateStoragePages.
+ * Fragment pliku jest z niego wycinany, więc przestaje zajmować miejsce na dysku.
+ * Jeśli blok to @p NULL nic nie robi.
+ * @param[in,out] memory - wskaźnik na blok;
+ * @param[in] size       - rozmiar podany przy przydzieleniu.
+ */
+void freeStoragePages(void *memory, size_t size);
+
+/**
+ * @brief Zleca jądru wczytanie z wyprzedzeniem części bloku trzymanego w pliku.
+ * Nie czeka na wczytanie. Gdy bloki grafu nie są trzymane w pliku nic nie robi.
+ * @param[in] memory - wskaźnik na początek części bloku z @ref allocateStoragePages;
+ * @param[in] size   - rozmiar części w bajtach.
+ */
+void prefetchStoragePages(const void *memory, size_t size);
+
+#endif /* DROGI_PAGE_MEMORY_H */
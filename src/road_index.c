@@ -0,0 +1,273 @@
+/** @file
+ * Implementacja indeksu odcinków drogowych według par miast.
+ *
+ * Indeks jest tablicą haszującą z adresowaniem otwartym w wariancie Robin Hood,
+ * tak jak słownik, ale kluczem jest para id miast, więc pola nie wskazują na napisy.
+ * Pola leżą w blokach danych grafu, więc przy grafie trzymanym w pliku też są w pliku.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include "road_index.h"
+#include "page_memory.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+
+/* Definicje typów. */
+
+/** Struktura odpowiadająca za jedno pole indeksu. */
+typedef struct RoadIndexSlotStruct RoadIndexSlot;
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje pole indeksu, czyli odcinek z uporządkowaną parą id końców. */
+struct RoadIndexSlotStruct {
+    /** Mniejsze z id końców odcinka. */
+    uint32_t lowerId;
+    /** Większe z id końców odcinka. */
+    uint32_t higherId;
+    /** Wskaźnik na odcinek, @p NULL jeśli pole jest puste. */
+    Road *road;
+};
+
+/** Przechowuje indeks odcinków. */
+struct RoadIndexStruct {
+    /** Liczba pól, zawsze potęga dwójki. */
+    size_t capacity;
+    /** Liczba zajętych pól. */
+    size_t count;
+    /** Wskaźnik na blok pól z @ref allocateStoragePages. */
+    RoadIndexSlot *slots;
+};
+
+
+/* Stałe. */
+
+/** Początkowa liczba pól indeksu. */
+static const size_t INITIAL_CAPACITY = 16;
+/** Licznik maksymalnego zapełnienia indeksu. */
+static const size_t MAX_LOAD_NUMERATOR = 4;
+/** Mianownik maksymalnego zapełnienia indeksu. */
+static const size_t MAX_LOAD_DENOMINATOR = 5;
+/** Mnożnik, przez który mniejsze id jest mnożone przed połączeniem z większym. */
+static const uint64_t PAIR_MULTIPLIER = 0x9e3779b97f4a7c15;
+/** Mnożnik używany przy mieszaniu bitów. */
+static const uint64_t HASH_MIX_MULTIPLIER = 0xff51afd7ed558ccd;
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Liczy hasz uporządkowanej pary id.
+ * @param[in] lowerId  - mniejsze id;
+ * @param[in] higherId - większe id.
+ * @return Hasz pary.
+ */
+static inline uint64_t hashIdPair(size_t lowerId, size_t higherId);
+
+/**
+ * @brief Liczy odległość wpisu od jego pola docelowego.
+ * @param[in] index    - wskaźnik na indeks;
+ * @param[in] position - numer zajętego pola.
+ * @return Odległość wpisu od pola wyznaczonego przez jego hasz.
+ */
+static inline size_t probeDistance(const RoadIndex *index, size_t position);
+
+/**
+ * @brief Znajduje pole z daną parą id.
+ * @param[in] index    - wskaźnik na indeks;
+ * @param[in] lowerId  - mniejsze id;
+ * @param[in] higherId - większe id.
+ * @return Wskaźnik na pole lub @p NULL jeśli pary nie ma w indeksie.
+ */
+static RoadIndexSlot *findSlot(const RoadIndex *index, size_t lowerId, size_t higherId);
+
+/**
+ * @brief Wstawia wpis do indeksu.
+ * Nie sprawdza czy para już jest w indeksie ani czy jest w nim miejsce.
+ * @param[in,out] index - wskaźnik na indeks;
+ * @param[in] slot      - wstawiany wpis.
+ */
+static void insertSlot(RoadIndex *index, RoadIndexSlot slot);
+
+/**
+ * @brief Dwukrotnie powiększa indeks, przepisując wszystkie wpisy.
+ * @param[in,out] index - wskaźnik na indeks.
+ * @return @p true lub @p false w zależności od powodzenia alokacji,
+ * w razie niepowodzenia indeks pozostaje bez zmian.
+ */
+static bool growRoadIndex(RoadIndex *index);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static inline uint64_t hashIdPair(size_t lowerId, size_t higherId) {
+    uint64_t x = ((uint64_t) lowerId * PAIR_MULTIPLIER) ^ (uint64_t) higherId;
+    x ^= x >> 33;
+    x *= HASH_MIX_MULTIPLIER;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline size_t probeDistance(const RoadIndex *index, size_t position) {
+    const RoadIndexSlot *slot = &index->slots[position];
+    return (position - hashIdPair(slot->lowerId, slot->higherId)) & (index->capacity - 1);
+}
+
+static RoadIndexSlot *findSlot(const RoadIndex *index, size_t lowerId, size_t higherId) {
+    size_t mask = index->capacity - 1;
+    size_t position = hashIdPair(lowerId, higherId) & mask;
+    /* Indeks nigdy nie jest pełny, więc pętla natrafi na puste pole. */
+    for (size_t distance = 0;; distance++) {
+        RoadIndexSlot *slot = &index->slots[position];
+        if (slot->road == NULL || probeDistance(index, position) < distance) {
+            return NULL;
+        }
+        if (slot->lowerId == lowerId && slot->higherId == higherId) {
+            return slot;
+        }
+        position = (position + 1) & mask;
+    }
+}
+
+static void insertSlot(RoadIndex *index, RoadIndexSlot slot) {
+    size_t mask = index->capacity - 1;
+    size_t position = hashIdPair(slot.lowerId, slot.higherId) & mask;
+    size_t distance = 0;
+    while (index->slots[position].road != NULL) {
+        size_t existingDistance = probeDistance(index, position);
+        if (existingDistance < distance) {
+            /* Wpis bliżej swojego pola ustępuje miejsca i to on jest dalej wstawiany. */
+            RoadIndexSlot tmp = index->slots[position];
+            index->slots[position] = slot;
+            slot = tmp;
+            distance = existingDistance;
+        }
+        position = (position + 1) & mask;
+        distance++;
+    }
+
+    index->slots[position] = slot;
+    index->count++;
+}
+
+static bool growRoadIndex(RoadIndex *index) {
+    RoadIndexSlot *oldSlots = index->slots;
+    size_t oldCapacity = index->capacity;
+    RoadIndexSlot *newSlots = allocateStoragePages(sizeof(RoadIndexSlot) * oldCapacity * 2);
+    if (newSlots == NULL) {
+        return false;
+    }
+
+    index->slots = newSlots;
+    index->capacity = oldCapacity * 2;
+    index->count = 0;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i].road != NULL) {
+            insertSlot(index, oldSlots[i]);
+        }
+    }
+    freeStoragePages(oldSlots, sizeof(RoadIndexSlot) * oldCapacity);
+    return true;
+}
+
+
+/* Funkcje z interfejsu. */
+
+RoadIndex *initRoadIndex(void) {
+    RoadIndex *index = malloc(sizeof(RoadIndex));
+    if (index == NULL) {
+        return NULL;
+    }
+
+    index->slots = allocateStoragePages(sizeof(RoadIndexSlot) * INITIAL_CAPACITY);
+    if (index->slots == NULL) {
+        free(index);
+        return NULL;
+    }
+
+    index->capacity = INITIAL_CAPACITY;
+    index->count = 0;
+    return index;
+}
+
+void deleteRoadIndex(RoadIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+
+    freeStoragePages(index->slots, sizeof(RoadIndexSlot) * index->capacity);
+    free(index);
+}
+
+bool addToRoadIndex(RoadIndex *index, Road *road) {
+    if (index == NULL || road == NULL) {
+        return false;
+    }
+
+    if ((index->count + 1) * MAX_LOAD_DENOMINATOR > index->capacity * MAX_LOAD_NUMERATOR &&
+        !growRoadIndex(index)) {
+        return false;
+    }
+
+    RoadIndexSlot slot;
+    slot.lowerId = road->end1Id < road->end2Id ? road->end1Id : road->end2Id;
+    slot.higherId = road->end1Id < road->end2Id ? road->end2Id : road->end1Id;
+    slot.road = road;
+    insertSlot(index, slot);
+    return true;
+}
+
+void removeFromRoadIndex(RoadIndex *index, const Road *road) {
+    if (index == NULL || road == NULL) {
+        return;
+    }
+
+    size_t lowerId = road->end1Id < road->end2Id ? road->end1Id : road->end2Id;
+    size_t higherId = road->end1Id < road->end2Id ? road->end2Id : road->end1Id;
+    RoadIndexSlot *slot = findSlot(index, lowerId, higherId);
+    if (slot == NULL || slot->road != road) {
+        return;
+    }
+
+    /* Kolejne wpisy spoza swoich pól docelowych są przesuwane o jedno pole wstecz. */
+    size_t mask = index->capacity - 1;
+    size_t position = (size_t) (slot - index->slots);
+    size_t next = (position + 1) & mask;
+    while (index->slots[next].road != NULL && probeDistance(index, next) > 0) {
+        index->slots[position] = index->slots[next];
+        position = next;
+        next = (next + 1) & mask;
+    }
+    index->slots[position].road = NULL;
+    index->count--;
+}
+
+Road *findInRoadIndex(const RoadIndex *index, const City *city1, const City *city2) {
+    if (index == NULL || city1 == NULL || city2 == NULL) {
+        return NULL;
+    }
+
+    size_t lowerId = city1->id < city2->id ? city1->id : city2->id;
+    size_t higherId = city1->id < city2->id ? city2->id : city1->id;
+    RoadIndexSlot *slot = findSlot(index, lowerId, higherId);
+    return slot == NULL ? NULL : slot->road;
+}
+
+void updateInRoadIndex(RoadIndex *index, Road *road) {
+    if (index == NULL || road == NULL) {
+        return;
+    }
+
+    size_t lowerId = road->end1Id < road->end2Id ? road->end1Id : road->end2Id;
+    size_t higherId = road->end1Id < road->end2Id ? road->end2Id : road->end1Id;
+    RoadIndexSlot *slot = findSlot(index, lowerId, higherId);
+    if (slot != NULL) {
+        slot->road = road;
+    }
+}
@@ -0,0 +1,65 @@
+/** @file
+ * Interfejs indeksu odcinków drogowych według par miast.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_ROAD_INDEX_H
+#define DROGI_ROAD_INDEX_H
+
+#include "map_types.h"
+
+#include <stdbool.h>
+
+/**
+ * @brief Tworzy nowy, pusty indeks odcinków.
+ * @return Wskaźnik na indeks lub @p NULL gdy brak pamięci.
+ */
+RoadIndex *initRoadIndex(void);
+
+/**
+ * @brief Usuwa indeks odcinków.
+ * Nie usuwa samych odcinków. Jeśli indeks to @p NULL nic nie robi.
+ * @param[in,out] index - wskaźnik na indeks.
+ */
+void deleteRoadIndex(RoadIndex *index);
+
+/**
+ * @brief Dodaje odcinek do indeksu.
+ * Kluczem jest nieuporządkowana para id końców odcinka, między parą miast
+ * może być w indeksie tylko jeden odcinek. Nie sprawdza czy para już jest w indeksie.
+ * @param[in,out] index - wskaźnik na indeks;
+ * @param[in] road      - wskaźnik na odcinek.
+ * @return @p true lub @p false w zależności od powodzenia alokacji.
+ */
+bool addToRoadIndex(RoadIndex *index, Road *road);
+
+/**
+ * @brief Usuwa odcinek z indeksu.
+ * Jeśli odcinka nie ma w indeksie nic nie robi.
+ * @param[in,out] index - wskaźnik na indeks;
+ * @param[in] road      - wskaźnik na odcinek.
+ */
+void removeFromRoadIndex(RoadIndex *index, const Road *road);
+
+/**
+ * @brief Znajduje odcinek między dwoma miastami.
+ * Działa w czasie stałym, niezależnie od liczby odcinków wychodzących z miast.
+ * @param[in] index - wskaźnik na indeks;
+ * @param[in] city1 - jeden koniec odcinka lub @p NULL;
+ * @param[in] city2 - drugi koniec odcinka lub @p NULL.
+ * @return Wskaźnik na odcinek lub @p NULL jeśli nie ma go w indeksie.
+ */
+Road *findInRoadIndex(const RoadIndex *index, const City *city1, const City *city2);
+
+/**
+ * @brief Zapisuje w indeksie nowe miejsce odcinka.
+ * Zastępuje odcinek między tymi samymi miastami, więc nie alokuje pamięci.
+ * Jeśli pary miast nie ma w indeksie nic nie robi.
+ * @param[in,out] index - wskaźnik na indeks;
+ * @param[in] road      - wskaźnik na przeniesiony odcinek.
+ */
+void updateInRoadIndex(RoadIndex *index, Road *road);
+
+#endif /* DROGI_ROAD_INDEX_H */
@@ -0,0 +1,440 @@
+/** @file
+ * Implementacja klasy przydzielającej obiekty jednego rozmiaru z dużych bloków pamięci.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include "slab.h"
+#include "page_memory.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+
+/* Definicje typów. */
+
+/** Struktura odpowiadająca za jeden blok pamięci przydzielacza. */
+typedef struct SlabBlockStruct SlabBlock;
+
+/**
+ * Typ wyliczeniowy określający stan miejsca w opróżnianym bloku.
+ */
+enum SlotStateEnum {
+    /** Miejsce jest wolne. */
+            SLOT_FREE,
+    /** Miejsce zajmuje obiekt, który nie został jeszcze przeniesiony. */
+            SLOT_LIVE,
+    /** Obiekt został przeniesiony, miejsce trzyma wskaźnik na jego nowe miejsce. */
+            SLOT_MOVED
+};
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje blok pamięci, z którego są przydzielane obiekty. */
+struct SlabBlockStruct {
+    /** Następny blok na stosie bloków z wolnymi miejscami. */
+    SlabBlock *nextPartial;
+    /** Lista zwróconych obiektów bloku, każdy na początku trzyma wskaźnik na następny. */
+    void *freeList;
+    /** Liczba początkowych obiektów bloku, które były już przydzielone. */
+    size_t usedCount;
+    /** Liczba obiektów bloku, które są teraz przydzielone. */
+    size_t liveCount;
+    /** Numer bloku, stały przez cały czas istnienia bloku, wyznacza numery miejsc jego obiektów. */
+    size_t number;
+    /** Czy blok jest na stosie bloków z wolnymi miejscami. */
+    bool isPartial;
+    /** Zawartość bloku, wyrównana tak jak wskaźnik. */
+    void *data[];
+};
+
+/** Przechowuje przydzielacz obiektów jednego rozmiaru. */
+struct SlabAllocatorStruct {
+    /** Rozmiar obiektu w bajtach, wielokrotność rozmiaru wskaźnika. */
+    size_t objectSize;
+    /** Liczba obiektów w jednym bloku. */
+    size_t objectsPerBlock;
+    /** Liczba bitów numeru miejsca na miejsce w bloku, @p 2^numberShift nie jest mniejsze od liczby obiektów w bloku. */
+    size_t numberShift;
+    /** Rozmiar bloku w bajtach, razem z nagłówkiem. */
+    size_t blockSize;
+    /** Tablica bloków posortowana rosnąco według adresów, żeby szybko znaleźć blok obiektu. */
+    SlabBlock **blocks;
+    /** Tablica bloków według ich numerów, @p NULL dla wolnych numerów. */
+    SlabBlock **numberedBlocks;
+    /** Liczba bloków. */
+    size_t blockCount;
+    /** Liczba miejsc w tablicy bloków i na stosie wolnych numerów bloków. */
+    size_t blockSpace;
+    /** Stos numerów zwolnionych przez bloki zwrócone do systemu. */
+    size_t *freeNumbers;
+    /** Liczba numerów na stosie wolnych numerów bloków. */
+    size_t freeNumberCount;
+    /** Liczba wydanych numerów bloków, nie większa od liczby miejsc w tablicy bloków. */
+    size_t numberLimit;
+    /**
+     * Wierzchołek stosu bloków z wolnymi miejscami lub @p NULL. Bloki, które się zapełniły
+     * albo są opróżniane, są zdejmowane ze stosu dopiero przy przydzielaniu.
+     */
+    SlabBlock *partial;
+    /** Liczba przydzielonych obiektów we wszystkich blokach. */
+    size_t liveCount;
+    /** Opróżniany blok lub @p NULL. */
+    SlabBlock *evacuated;
+    /** Stany kolejnych miejsc opróżnianego bloku. */
+    unsigned char *slotStates;
+    /** Miejsce, od którego są szukane kolejne obiekty do przeniesienia. */
+    size_t evacuationCursor;
+    /** Liczba przeniesionych obiektów opróżnianego bloku. */
+    size_t movedCount;
+};
+
+
+/* Stałe. */
+
+/**
+ * Najmniejszy rozmiar bloku w bajtach. Przy dużych stronach blok zajmuje całą dużą stronę,
+ * a większy jest też wtedy, gdy obiekt się w nim nie mieści.
+ */
+static const size_t BLOCK_SIZE = 64 * 1024;
+/** Początkowa liczba miejsc w tablicy bloków. */
+static const size_t INITIAL_BLOCK_SPACE = 8;
+
+
+/* Funkcje pomocnicze. */
+
+/**
+ * @brief Przydziela nowy blok i kładzie go na stos bloków z wolnymi miejscami.
+ * @param[in,out] slab - wskaźnik na przydzielacz.
+ * @return @p true lub @p false gdy brak pamięci.
+ */
+static bool addSlabBlock(SlabAllocator *slab);
+
+/**
+ * @brief Znajduje blok, z którego pochodzi obiekt.
+ * @param[in] slab   - wskaźnik na przydzielacz;
+ * @param[in] object - wskaźnik na obiekt przydzielony z tego przydzielacza.
+ * @return Numer bloku w tablicy bloków.
+ */
+static size_t blockIndexOf(const SlabAllocator *slab, const void *object);
+
+/**
+ * @brief Kładzie blok na stos bloków z wolnymi miejscami, jeśli go tam nie ma.
+ * @param[in,out] slab  - wskaźnik na przydzielacz;
+ * @param[in,out] block - wskaźnik na blok.
+ */
+static void pushPartialBlock(SlabAllocator *slab, SlabBlock *block);
+
+/**
+ * @brief Zdejmuje blok ze stosu bloków z wolnymi miejscami.
+ * @param[in,out] slab  - wskaźnik na przydzielacz;
+ * @param[in,out] block - wskaźnik na blok leżący na stosie.
+ */
+static void removePartialBlock(SlabAllocator *slab, SlabBlock *block);
+
+
+/* Implementacja funkcji pomocniczych. */
+
+static bool addSlabBlock(SlabAllocator *slab) {
+    if (slab->blockCount == slab->blockSpace) {
+        size_t newSpace = slab->blockSpace == 0 ? INITIAL_BLOCK_SPACE : slab->blockSpace * 2;
+        SlabBlock **newBlocks = realloc(slab->blocks, sizeof(SlabBlock *) * newSpace);
+        if (newBlocks == NULL) {
+            return false;
+        }
+        slab->blocks = newBlocks;
+        /* Numerów bloków nigdy nie jest więcej niż miejsc w tablicy bloków. */
+        SlabBlock **newNumberedBlocks = realloc(slab->numberedBlocks, sizeof(SlabBlock *) * newSpace);
+        if (newNumberedBlocks == NULL) {
+            return false;
+        }
+        slab->numberedBlocks = newNumberedBlocks;
+        /* Wolnych numerów nigdy nie jest więcej niż bloków, więc stos ma tyle samo miejsc. */
+        size_t *newFreeNumbers = realloc(slab->freeNumbers, sizeof(size_t) * newSpace);
+        if (newFreeNumbers == NULL) {
+            return false;
+        }
+        slab->freeNumbers = newFreeNumbers;
+        slab->blockSpace = newSpace;
+    }
+
+    /* Pamięć bloku jest wyzerowana, więc nagłówek opisuje pusty blok. */
+    SlabBlock *block = allocateStoragePages(slab->blockSize);
+    if (block == NULL) {
+        return false;
+    }
+
+    size_t position = slab->blockCount;
+    while (position > 0 && (uintptr_t) slab->blocks[position - 1] > (uintptr_t) block) {
+        slab->blocks[position] = slab->blocks[position - 1];
+        position--;
+    }
+    slab->blocks[position] = block;
+    slab->blockCount++;
+    block->number = slab->freeNumberCount > 0 ? slab->freeNumbers[--slab->freeNumberCount] : slab->numberLimit++;
+    slab->numberedBlocks[block->number] = block;
+    pushPartialBlock(slab, block);
+    return true;
+}
+
+static size_t blockIndexOf(const SlabAllocator *slab, const void *object) {
+    /* Szukany jest ostatni blok, który zaczyna się nie dalej niż obiekt. */
+    size_t low = 0;
+    size_t high = slab->blockCount;
+    while (high - low > 1) {
+        size_t middle = (low + high) / 2;
+        if ((uintptr_t) slab->blocks[middle] <= (uintptr_t) object) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static void pushPartialBlock(SlabAllocator *slab, SlabBlock *block) {
+    if (block->isPartial) {
+        return;
+    }
+
+    block->nextPartial = slab->partial;
+    block->isPartial = true;
+    slab->partial = block;
+}
+
+static void removePartialBlock(SlabAllocator *slab, SlabBlock *block) {
+    SlabBlock **link = &slab->partial;
+    while (*link != block) {
+        link = &(*link)->nextPartial;
+    }
+    *link = block->nextPartial;
+    block->isPartial = false;
+}
+
+
+/* Funkcje z interfejsu. */
+
+SlabAllocator *initSlabAllocator(size_t objectSize) {
+    SlabAllocator *slab = malloc(sizeof(SlabAllocator));
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    /* Zwrócony obiekt musi pomieścić wskaźnik listy i zachować wyrównanie następnych. */
+    if (objectSize < sizeof(void *)) {
+        objectSize = sizeof(void *);
+    }
+    objectSize = (objectSize + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+
+    size_t blockSize = preferredBlockSize(BLOCK_SIZE);
+    slab->objectSize = objectSize;
+    slab->objectsPerBlock = objectSize > blockSize - sizeof(SlabBlock) ? 1 : (blockSize - sizeof(SlabBlock)) / objectSize;
+    slab->blockSize = sizeof(SlabBlock) + objectSize * slab->objectsPerBlock;
+    /* Numer miejsca składa się z numeru bloku i miejsca w bloku, więc odwrócenie go nie wymaga dzielenia. */
+    slab->numberShift = 0;
+    while ((size_t) 1 << slab->numberShift < slab->objectsPerBlock) {
+        slab->numberShift++;
+    }
+    slab->blocks = NULL;
+    slab->numberedBlocks = NULL;
+    slab->blockCount = 0;
+    slab->blockSpace = 0;
+    slab->freeNumbers = NULL;
+    slab->freeNumberCount = 0;
+    slab->numberLimit = 0;
+    slab->partial = NULL;
+    slab->liveCount = 0;
+    slab->evacuated = NULL;
+    slab->slotStates = NULL;
+    slab->evacuationCursor = 0;
+    slab->movedCount = 0;
+    return slab;
+}
+
+void deleteSlabAllocator(SlabAllocator *slab) {
+    if (slab == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < slab->blockCount; i++) {
+        freeStoragePages(slab->blocks[i], slab->blockSize);
+    }
+    free(slab->blocks);
+    free(slab->numberedBlocks);
+    free(slab->freeNumbers);
+    free(slab->slotStates);
+    free(slab);
+}
+
+void *allocateFromSlab(SlabAllocator *slab) {
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    while (slab->partial != NULL &&
+           (slab->partial == slab->evacuated || slab->partial->liveCount == slab->objectsPerBlock)) {
+        SlabBlock *block = slab->partial;
+        slab->partial = block->nextPartial;
+        block->isPartial = false;
+    }
+    if (slab->partial == NULL && !addSlabBlock(slab)) {
+        return NULL;
+    }
+
+    SlabBlock *block = slab->partial;
+    void *object;
+    if (block->freeList != NULL) {
+        object = block->freeList;
+        block->freeList = *(void **) object;
+    } else {
+        object = (char *) block->data + slab->objectSize * block->usedCount;
+        block->usedCount++;
+    }
+    block->liveCount++;
+    slab->liveCount++;
+    return object;
+}
+
+void freeToSlab(SlabAllocator *slab, void *object) {
+    if (slab == NULL || object == NULL) {
+        return;
+    }
+
+    SlabBlock *block = slab->blocks[blockIndexOf(slab, object)];
+    *(void **) object = block->freeList;
+    block->freeList = object;
+    block->liveCount--;
+    slab->liveCount--;
+    pushPartialBlock(slab, block);
+}
+
+size_t objectNumberInSlab(const SlabAllocator *slab, const void *object) {
+    const SlabBlock *block = slab->blocks[blockIndexOf(slab, object)];
+    return (block->number << slab->numberShift) + ((const char *) object - (const char *) block->data) / slab->objectSize;
+}
+
+void *objectOfNumberInSlab(const SlabAllocator *slab, size_t number) {
+    SlabBlock *block = slab->numberedBlocks[number >> slab->numberShift];
+    return (char *) block->data + slab->objectSize * (number & (((size_t) 1 << slab->numberShift) - 1));
+}
+
+size_t objectNumberLimit(const SlabAllocator *slab) {
+    return slab->numberLimit << slab->numberShift;
+}
+
+bool beginSlabEvacuation(SlabAllocator *slab) {
+    if (slab == NULL || slab->evacuated != NULL || slab->blockCount == 0) {
+        return false;
+    }
+
+    /* Obiekty bloku muszą się zmieścić w wolnych miejscach pozostałych bloków. */
+    if (slab->liveCount > (slab->blockCount - 1) * slab->objectsPerBlock) {
+        return false;
+    }
+
+    SlabBlock *sparsest = slab->blocks[0];
+    for (size_t i = 1; i < slab->blockCount; i++) {
+        if (slab->blocks[i]->liveCount < sparsest->liveCount) {
+            sparsest = slab->blocks[i];
+        }
+    }
+    if (sparsest->liveCount * 2 > slab->objectsPerBlock) {
+        return false;
+    }
+
+    if (slab->slotStates == NULL) {
+        slab->slotStates = malloc(sizeof(unsigned char) * slab->objectsPerBlock);
+        if (slab->slotStates == NULL) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < sparsest->usedCount; i++) {
+        slab->slotStates[i] = SLOT_LIVE;
+    }
+    for (void *object = sparsest->freeList; object != NULL; object = *(void **) object) {
+        slab->slotStates[((char *) object - (char *) sparsest->data) / slab->objectSize] = SLOT_FREE;
+    }
+
+    slab->evacuated = sparsest;
+    slab->evacuationCursor = 0;
+    slab->movedCount = 0;
+    return true;
+}
+
+void *nextEvacuatedObject(SlabAllocator *slab) {
+    if (slab == NULL || slab->evacuated == NULL) {
+        return NULL;
+    }
+
+    SlabBlock *block = slab->evacuated;
+    while (slab->evacuationCursor < block->usedCount) {
+        size_t position = slab->evacuationCursor++;
+        if (slab->slotStates[position] == SLOT_LIVE) {
+            return (char *) block->data + slab->objectSize * position;
+        }
+    }
+    return NULL;
+}
+
+void markObjectMoved(SlabAllocator *slab, void *object, void *newObject) {
+    size_t position = ((char *) object - (char *) slab->evacuated->data) / slab->objectSize;
+    slab->slotStates[position] = SLOT_MOVED;
+    slab->movedCount++;
+    *(void **) object = newObject;
+}
+
+void *forwardedObject(const SlabAllocator *slab, void *object) {
+    if (slab == NULL || slab->evacuated == NULL || object == NULL) {
+        return object;
+    }
+
+    SlabBlock *block = slab->evacuated;
+    uintptr_t begin = (uintptr_t) block->data;
+    uintptr_t offset = (uintptr_t) object - begin;
+    if ((uintptr_t) object < begin || offset >= slab->objectSize * block->usedCount) {
+        return object;
+    }
+    if (slab->slotStates[offset / slab->objectSize] != SLOT_MOVED) {
+        return object;
+    }
+    return *(void **) object;
+}
+
+bool finishSlabEvacuation(SlabAllocator *slab) {
+    if (slab == NULL || slab->evacuated == NULL) {
+        return false;
+    }
+
+    SlabBlock *block = slab->evacuated;
+    slab->evacuated = NULL;
+    if (slab->movedCount == block->liveCount) {
+        /* Wszystkie obiekty są w innych blokach, więc cały blok wraca do systemu. */
+        if (block->isPartial) {
+            removePartialBlock(slab, block);
+        }
+        size_t index = blockIndexOf(slab, block);
+        for (size_t i = index + 1; i < slab->blockCount; i++) {
+            slab->blocks[i - 1] = slab->blocks[i];
+        }
+        slab->blockCount--;
+        slab->liveCount -= block->liveCount;
+        slab->freeNumbers[slab->freeNumberCount++] = block->number;
+        slab->numberedBlocks[block->number] = NULL;
+        freeStoragePages(block, slab->blockSize);
+        return true;
+    }
+
+    /* Stare miejsca przeniesionych obiektów są zwalniane, a blok znowu jest używany. */
+    for (size_t i = 0; i < block->usedCount; i++) {
+        if (slab->slotStates[i] == SLOT_MOVED) {
+            freeToSlab(slab, (char *) block->data + slab->objectSize * i);
+        }
+    }
+    if (block->liveCount < slab->objectsPerBlock) {
+        pushPartialBlock(slab, block);
+    }
+    return false;
+}
@@ -0,0 +1,125 @@
+/** @file
+ * Interfejs klasy przydzielającej obiekty jednego rozmiaru z dużych bloków pamięci.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_SLAB_H
+#define DROGI_SLAB_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/** Struktura przechowująca przydzielacz obiektów jednego rozmiaru. */
+typedef struct SlabAllocatorStruct SlabAllocator;
+
+/**
+ * @brief Tworzy nowy przydzielacz obiektów.
+ * @param[in] objectSize - rozmiar obiektu w bajtach.
+ * @return Wskaźnik na przydzielacz lub @p NULL gdy brak pamięci.
+ */
+SlabAllocator *initSlabAllocator(size_t objectSize);
+
+/**
+ * @brief Usuwa przydzielacz.
+ * Zwalnia wszystkie bloki naraz, razem ze wszystkimi przydzielonymi obiektami,
+ * także tymi, które nie zostały zwrócone. Jeśli przydzielacz to @p NULL nic nie robi.
+ * @param[in,out] slab - wskaźnik na przydzielacz.
+ */
+void deleteSlabAllocator(SlabAllocator *slab);
+
+/**
+ * @brief Przydziela obiekt.
+ * Najpierw używa wolnych miejsc w istniejących blokach, także po obiektach
+ * zwróconych przez @ref freeToSlab. Nigdy nie używa opróżnianego bloku.
+ * Obiekt jest wyrównany tak jak wskaźnik.
+ * @param[in,out] slab - wskaźnik na przydzielacz.
+ * @return Wskaźnik na niezainicjowany obiekt lub @p NULL gdy brak pamięci.
+ */
+void *allocateFromSlab(SlabAllocator *slab);
+
+/**
+ * @brief Zwraca obiekt do przydzielacza, żeby mógł zostać ponownie przydzielony.
+ * Jeśli obiekt to @p NULL nic nie robi.
+ * @param[in,out] slab   - wskaźnik na przydzielacz, z którego pochodzi obiekt;
+ * @param[in,out] object - wskaźnik na obiekt.
+ */
+void freeToSlab(SlabAllocator *slab, void *object);
+
+/**
+ * @brief Wyznacza numer miejsca obiektu.
+ * Numer nie zmienia się, dopóki obiekt jest przydzielony, a różne przydzielone obiekty
+ * mają różne numery, więc może indeksować tablice równoległe do obiektów.
+ * Numery są zwalniane razem z blokami, więc pozostają małe.
+ * @param[in] slab   - wskaźnik na przydzielacz;
+ * @param[in] object - wskaźnik na obiekt przydzielony z tego przydzielacza.
+ * @return Numer miejsca obiektu, mniejszy od @ref objectNumberLimit.
+ */
+size_t objectNumberInSlab(const SlabAllocator *slab, const void *object);
+
+/**
+ * @brief Wyznacza obiekt o danym numerze miejsca.
+ * Działa w czasie stałym, bez szukania bloku.
+ * @param[in] slab   - wskaźnik na przydzielacz;
+ * @param[in] number - numer miejsca przydzielonego obiektu, zwrócony przez @ref objectNumberInSlab.
+ * @return Wskaźnik na obiekt.
+ */
+void *objectOfNumberInSlab(const SlabAllocator *slab, size_t number);
+
+/**
+ * @brief Udostępnia ograniczenie numerów miejsc obiektów.
+ * @param[in] slab - wskaźnik na przydzielacz.
+ * @return Liczba większa od numerów miejsc wszystkich przydzielonych obiektów.
+ */
+size_t objectNumberLimit(const SlabAllocator *slab);
+
+/**
+ * @brief Rozpoczyna opróżnianie najrzadziej zajętego bloku.
+ * Blok jest wybierany tylko wtedy, gdy jest zajęty co najwyżej w połowie, a jego obiekty
+ * mieszczą się w wolnych miejscach pozostałych bloków, więc po ich przeniesieniu
+ * przydzielacz będzie miał o jeden blok mniej. Obiekty przenosi wywołujący:
+ * przydziela nowy obiekt przez @ref allocateFromSlab, kopiuje zawartość,
+ * poprawia odwołania i wywołuje @ref markObjectMoved.
+ * @param[in,out] slab - wskaźnik na przydzielacz.
+ * @return @p true jeśli blok został wybrany, @p false gdy żaden blok się nie nadaje,
+ * opróżnianie już trwa lub brak pamięci.
+ */
+bool beginSlabEvacuation(SlabAllocator *slab);
+
+/**
+ * @brief Udostępnia kolejny obiekt opróżnianego bloku, który nie został przeniesiony.
+ * @param[in,out] slab - wskaźnik na przydzielacz.
+ * @return Wskaźnik na obiekt lub @p NULL gdy nie ma więcej obiektów do przeniesienia.
+ */
+void *nextEvacuatedObject(SlabAllocator *slab);
+
+/**
+ * @brief Zapisuje, że obiekt opróżnianego bloku został przeniesiony.
+ * Początek starego obiektu jest nadpisywany wskaźnikiem na nowe miejsce,
+ * reszta zawartości pozostaje do zakończenia opróżniania.
+ * @param[in,out] slab   - wskaźnik na przydzielacz;
+ * @param[in,out] object - wskaźnik na obiekt zwrócony przez @ref nextEvacuatedObject;
+ * @param[in] newObject  - wskaźnik na nowe miejsce obiektu.
+ */
+void markObjectMoved(SlabAllocator *slab, void *object, void *newObject);
+
+/**
+ * @brief Wyznacza aktualne miejsce obiektu w czasie opróżniania bloku.
+ * @param[in] slab   - wskaźnik na przydzielacz;
+ * @param[in] object - wskaźnik na obiekt lub jego stare miejsce.
+ * @return Nowe miejsce dla przeniesionych obiektów, dla pozostałych @p object.
+ */
+void *forwardedObject(const SlabAllocator *slab, void *object);
+
+/**
+ * @brief Kończy opróżnianie bloku.
+ * Jeśli wszystkie obiekty bloku zostały przeniesione, to blok jest zwracany do systemu.
+ * W p.p. (gdy zabrakło pamięci) stare miejsca przeniesionych obiektów są zwalniane,
+ * a blok znowu jest używany. Jeśli opróżnianie nie trwa nic nie robi.
+ * @param[in,out] slab - wskaźnik na przydzielacz.
+ * @return @p true jeśli blok został zwrócony do systemu, @p false w p.p.
+ */
+bool finishSlabEvacuation(SlabAllocator *slab);
+
+#endif /* DROGI_SLAB_H */
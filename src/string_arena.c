@@ -0,0 +1,123 @@
+/** @file
+ * Implementacja klasy przechowującej napisy w dużych, wspólnych blokach pamięci.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#include "string_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Definicje typów. */
+
+/** Struktura odpowiadająca za jeden blok pamięci areny. */
+typedef struct StringArenaBlockStruct StringArenaBlock;
+
+
+/* Deklaracje struktur. */
+
+/** Przechowuje blok pamięci, w którym kolejne napisy są zapisywane jeden za drugim. */
+struct StringArenaBlockStruct {
+    /** Poprzednio zaalokowany blok lub @p NULL. */
+    StringArenaBlock *previous;
+    /** Rozmiar bloku w bajtach. */
+    size_t space;
+    /** Liczba wykorzystanych bajtów bloku. */
+    size_t used;
+    /** Zawartość bloku. */
+    char data[];
+};
+
+/** Przechowuje arenę napisów. */
+struct StringArenaStruct {
+    /** Ostatnio zaalokowany blok, do którego są dopisywane napisy, lub @p NULL. */
+    StringArenaBlock *last;
+    /** Liczba bajtów potrzebnych kopii. */
+    size_t liveBytes;
+    /** Liczba bajtów zwolnionych kopii. */
+    size_t deadBytes;
+};
+
+
+/* Stałe. */
+
+/** Domyślny rozmiar bloku w bajtach. */
+static const size_t BLOCK_SIZE = 64 * 1024;
+
+
+/* Funkcje z interfejsu. */
+
+StringArena *initStringArena(void) {
+    StringArena *arena = malloc(sizeof(StringArena));
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    arena->last = NULL;
+    arena->liveBytes = 0;
+    arena->deadBytes = 0;
+    return arena;
+}
+
+void deleteStringArena(StringArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    StringArenaBlock *block = arena->last;
+    while (block != NULL) {
+        StringArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    free(arena);
+}
+
+const char *addToStringArena(StringArena *arena, const char *string, size_t length) {
+    if (arena == NULL || string == NULL) {
+        return NULL;
+    }
+
+    size_t needed = length + 1;
+    StringArenaBlock *block = arena->last;
+    if (block == NULL || block->space - block->used < needed) {
+        /* Napis nie mieści się w ostatnim bloku, więc jest tworzony nowy. */
+        size_t space = needed > BLOCK_SIZE ? needed : BLOCK_SIZE;
+        block = malloc(sizeof(StringArenaBlock) + space);
+        if (block == NULL) {
+            return NULL;
+        }
+
+        block->previous = arena->last;
+        block->space = space;
+        block->used = 0;
+        arena->last = block;
+    }
+
+    char *copy = block->data + block->used;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    block->used += needed;
+    arena->liveBytes += needed;
+    return copy;
+}
+
+void releaseFromStringArena(StringArena *arena, const char *string, size_t length) {
+    if (arena == NULL || string == NULL) {
+        return;
+    }
+
+    arena->liveBytes -= length + 1;
+    arena->deadBytes += length + 1;
+}
+
+size_t liveBytesOfStringArena(const StringArena *arena) {
+    return arena == NULL ? 0 : arena->liveBytes;
+}
+
+size_t deadBytesOfStringArena(const StringArena *arena) {
+    return arena == NULL ? 0 : arena->deadBytes;
+}
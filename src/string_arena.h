@@ -0,0 +1,66 @@
+/** @file
+ * Interfejs klasy przechowującej napisy w dużych, wspólnych blokach pamięci.
+ *
+ * @author Antoni Żewierżejew <azewierzejew@gmail.com>
+ * @date 16.10.2026
+ */
+
+#ifndef DROGI_STRING_ARENA_H
+#define DROGI_STRING_ARENA_H
+
+#include <stdlib.h>
+
+/** Struktura przechowująca arenę napisów. */
+typedef struct StringArenaStruct StringArena;
+
+/**
+ * @brief Tworzy nową, pustą arenę napisów.
+ * @return Wskaźnik na arenę lub @p NULL gdy brak pamięci.
+ */
+StringArena *initStringArena(void);
+
+/**
+ * @brief Usuwa arenę.
+ * Usuwa arenę razem ze wszystkimi napisami, które zostały do niej dodane.
+ * Jeśli arena to @p NULL nic nie robi.
+ * @param[in,out] arena - wskaźnik na arenę.
+ */
+void deleteStringArena(StringArena *arena);
+
+/**
+ * @brief Kopiuje napis do areny.
+ * Kopiuje @p length bajtów napisu i dopisuje za nimi zerowy bajt.
+ * Kopia nie zmienia położenia aż do usunięcia areny i nie należy jej samodzielnie usuwać.
+ * @param[in,out] arena - wskaźnik na arenę;
+ * @param[in] string    - wskaźnik na napis;
+ * @param[in] length    - długość napisu.
+ * @return Wskaźnik na kopię napisu lub @p NULL gdy argumenty są niepoprawne lub brak pamięci.
+ */
+const char *addToStringArena(StringArena *arena, const char *string, size_t length);
+
+/**
+ * @brief Zaznacza, że kopia napisu nie jest już potrzebna.
+ * Arena nie odzyskuje tego miejsca, tylko liczy martwe bajty, żeby właściciel
+ * wiedział, kiedy opłaca się przepisać potrzebne napisy do nowej areny.
+ * Kopia pozostaje czytelna aż do usunięcia areny.
+ * @param[in,out] arena - wskaźnik na arenę;
+ * @param[in] string    - wskaźnik na kopię zwróconą przez @ref addToStringArena;
+ * @param[in] length    - długość napisu.
+ */
+void releaseFromStringArena(StringArena *arena, const char *string, size_t length);
+
+/**
+ * @brief Podaje liczbę bajtów zajmowanych przez potrzebne kopie napisów.
+ * @param[in] arena - wskaźnik na arenę.
+ * @return Liczba bajtów, razem z zerowymi bajtami, lub @p 0 gdy arena to @p NULL.
+ */
+size_t liveBytesOfStringArena(const StringArena *arena);
+
+/**
+ * @brief Podaje liczbę bajtów zajmowanych przez kopie zwolnione przez @ref releaseFromStringArena.
+ * @param[in] arena - wskaźnik na arenę.
+ * @return Liczba bajtów, razem z zerowymi bajtami, lub @p 0 gdy arena to @p NULL.
+ */
+size_t deadBytesOfStringArena(const StringArena *arena);
+
+#endif /* DROGI_STRING_ARENA_H */
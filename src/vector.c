@@ -255,4 +255,26 @@ bool appendVector(Vector *vector, Vector *part) {
     vector->count = totalCount;
     deleteVector(part, NULL);
     return true;
-}
\ No newline at end of file
+}
+
+void shrinkVector(Vector *vector) {
+    if (vector == NULL || vector->space == vector->count) {
+        return;
+    }
+
+    if (vector->count == 0) {
+        free(vector->holder);
+        vector->holder = NULL;
+        vector->space = 0;
+        return;
+    }
+    resizeVector(vector, vector->count);
+}
+
+void clearVector(Vector *vector) {
+    if (vector == NULL) {
+        return;
+    }
+
+    vector->count = 0;
+}
@@ -119,4 +119,19 @@ bool existsInVector(const Vector *vector, const void *value);
  */
 bool appendVector(Vector *vector, Vector *part);
 
+/**
+ * @brief Dopasowuje zaalokowane miejsce wektora do liczby elementów.
+ * Gdy realokacja się nie uda, wektor zostaje bez zmian.
+ * Jeśli wektor to @p NULL nic nie robi.
+ * @param[in,out] vector - wskaźnik na wektor.
+ */
+void shrinkVector(Vector *vector);
+
+/**
+ * @brief Usuwa wszystkie wartości z wektora, zostawiając zaalokowane miejsce.
+ * Jeśli wektor to @p NULL nic nie robi.
+ * @param[in,out] vector - wskaźnik na wektor.
+ */
+void clearVector(Vector *vector);
+
 #endif /* DROGI_VECTOR_H */